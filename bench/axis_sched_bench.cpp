@@ -0,0 +1,119 @@
+/*
+   MSFS 202x–ArduPilot Bridge - servo -> sim event scheduler benchmark.
+
+   Replays the sim loop's servo output path on a virtual clock: a 1 kHz
+   loop, sim frames at sim_hz, and SITL servo packets at 400 Hz where four
+   surfaces move (quantized to 1 us PWM like the real packets) and the
+   other twelve mapped channels hold still. Reports the SimConnect events
+   per second of the old send-everything loop against AxisScheduler with a
+   few deadband settings, and the worst delay from a value change on the
+   servo side to the event carrying it (or one within the deadband).
+   Exits nonzero if the scheduler does not cut events by 10x or delays a
+   change by more than 1.5 sim frames.
+
+   Usage: axis_sched_bench [sim_hz] [seconds]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "core/axis_sched.h"
+
+typedef AxisScheduler::Clock Clock;
+
+struct Result {
+    uint64_t events = 0;
+    double max_delay_ms = 0.0;
+    AxisSchedStats stats;
+};
+
+// PWM -> sim axis units, as servo_to_sim_axes() does for a bipolar channel.
+static long pwm_to_axis(int pwm){
+    return (long)std::llround(((pwm - 1500) / 500.0) * 16383.0);
+}
+
+static Result run(double sim_hz, double seconds, bool scheduled, int deadband, bool align){
+    Result r;
+    AxisScheduler sch;
+    sch.configure(deadband, 250, align);
+
+    const Clock::time_point t0{};
+    const int loop_n = (int)(seconds * 1000.0);
+    const double frame_ms = 1000.0 / sim_hz;
+    long cur[16]{}, sent[16]{};
+    double changed_at[16];
+    for (int i = 0; i < 16; i++) changed_at[i] = -1.0;
+    int next_frame = 0, next_servo = 0;
+
+    for (int k = 0; k < loop_n; k++) {
+        const double t_ms = (double)k;
+
+        // Servo packets at 400 Hz (2.5 ms), several may land per loop.
+        while (next_servo * 2.5 <= t_ms) {
+            const double ts = next_servo * 2.5 / 1000.0;
+            for (int i = 0; i < 16; i++) {
+                int pwm = 1500;
+                if (i < 4) pwm = 1500 + (int)std::lround(300.0 * std::sin(0.7 * ts * (i + 1)) + 40.0 * std::sin(9.0 * ts));
+                long v = pwm_to_axis(pwm);
+                if (v != cur[i] && changed_at[i] < 0.0) changed_at[i] = t_ms;
+                cur[i] = v;
+            }
+            next_servo++;
+        }
+
+        bool new_frame = false;
+        while (next_frame * frame_ms <= t_ms) { new_frame = true; next_frame++; }
+
+        uint32_t mask = 0xFFFF;
+        if (scheduled) {
+            mask = sch.schedule(cur, 0xFFFF, new_frame, frame_ms,
+                                t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(t_ms)));
+        }
+        for (int i = 0; i < 16; i++) {
+            if (mask & (1u << i)) { sent[i] = cur[i]; r.events++; }
+            if (changed_at[i] >= 0.0 && std::labs(cur[i] - sent[i]) <= deadband) {
+                r.max_delay_ms = std::max(r.max_delay_ms, t_ms - changed_at[i]);
+                changed_at[i] = -1.0;
+            }
+        }
+    }
+    r.stats = sch.stats();
+    return r;
+}
+
+int main(int argc, char** argv){
+    const double sim_hz = argc > 1 ? atof(argv[1]) : 30.0;
+    const double seconds = argc > 2 ? atof(argv[2]) : 60.0;
+
+    printf("1 kHz sim loop, %.0f Hz sim frames, 400 Hz servo, 16 mapped channels, %.0f s\n", sim_hz, seconds);
+    printf("%-24s %12s %12s %14s\n", "mode", "events/s", "suppressed/s", "max delay ms");
+    auto row = [&](const char* name, const Result& r){
+        printf("%-24s %12.0f %12.0f %14.1f\n", name, r.events / seconds, r.stats.suppressed / seconds, r.max_delay_ms);
+    };
+
+    Result legacy = run(sim_hz, seconds, false, 0, false);
+    Result dedup = run(sim_hz, seconds, true, 0, false);
+    Result aligned = run(sim_hz, seconds, true, 0, true);
+    Result db = run(sim_hz, seconds, true, 64, true);
+    row("every loop (old)", legacy);
+    row("dedup", dedup);
+    row("dedup + frame aligned", aligned);
+    row("deadband 64 + aligned", db);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    Result timed = run(sim_hz, seconds, true, 0, true);
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("schedule %6.1f ns/loop (incl. harness)\n", s * 1e9 / (seconds * 1000.0));
+
+    const double frame_ms = 1000.0 / sim_hz;
+    bool ok = aligned.events * 10 <= legacy.events && timed.events == aligned.events;
+    ok = ok && aligned.max_delay_ms <= 1.5 * frame_ms + 1.0 && dedup.max_delay_ms <= 1.0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+/*
+   MSFS 202x–ArduPilot Bridge - binary sensor packet round trip.
+
+   Encodes random frames with encode_binary_frame() for every option
+   combination and decodes them with the reference C decoder
+   (sensor_packet_decode), expecting every double back bit for bit and
+   every float as the frame's value rounded to float. Checks the decoder
+   rejects short, foreign and future-version packets and accepts a longer
+   one. Then runs the bridge against loopback sinks with the SITL on the
+   binary format and two listeners (JSON, binary) and checks each gets
+   its own format with consecutive sequence numbers. Finally compares
+   frames/second and bytes/frame with the JSON encoder.
+
+   Usage: binary_frame_bench [frames] [port_base]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/binary_frame.h"
+#include "core/bridge.h"
+#include "core/json_encode.h"
+#include "core/net.h"
+#include "core/sensor_packet.h"
+#include "core/sensor_source.h"
+
+static std::mt19937_64 g_rng(4242);
+
+static double uni(double lo, double hi){
+    return std::uniform_real_distribution<double>(lo, hi)(g_rng);
+}
+
+static RawSensors random_sample(){
+    RawSensors R{};
+    R.lat_deg = uni(-90, 90); R.lon_deg = uni(-180, 180);
+    R.alt_msl_ft = uni(-1000, 45000); R.alt_agl_ft = uni(0, 5000);
+    R.pitch_deg = uni(-90, 90); R.bank_deg = uni(-180, 180); R.hdg_true_deg = uni(0, 360);
+    R.ias_kt = uni(0, 400);
+    R.vel_e_fps = uni(-300, 300); R.vel_n_fps = uni(-300, 300); R.vel_u_fps = uni(-50, 50);
+    R.p_rads = uni(-3, 3); R.q_rads = uni(-3, 3); R.r_rads = uni(-3, 3);
+    R.accel_x_fps2 = uni(-60, 60); R.accel_y_fps2 = uni(-60, 60); R.accel_z_fps2 = uni(-60, 60);
+    R.N_m = uni(-1e5, 1e5); R.E_m = uni(-1e5, 1e5); R.U_m = uni(-1e3, 1e4);
+    R.valid = true;
+    return R;
+}
+
+static bool same_bits(double a, double b){ return memcmp(&a, &b, sizeof(a)) == 0; }
+static bool same_float(float got, double want){ float w = (float)want; return memcmp(&got, &w, sizeof(w)) == 0; }
+
+// Field-by-field comparison of a decoded packet with its source frame.
+static bool matches(const sensor_packet& p, const SensorFrame& f, const JsonOptions& o, uint32_t seq){
+    const uint32_t flags = (o.no_lockstep ? SENSOR_PACKET_F_NO_LOCKSTEP : 0u) |
+                           (o.use_time_sync ? 0u : SENSOR_PACKET_F_NO_TIME_SYNC) |
+                           (o.pos_mode == 2 ? SENSOR_PACKET_F_LLA : 0u);
+    bool ok = p.magic == SENSOR_PACKET_MAGIC && p.version == SENSOR_PACKET_VERSION &&
+              p.length == SENSOR_PACKET_SIZE_V1 && p.seq == seq && p.flags == flags;
+    ok = ok && same_bits(p.timestamp, f.timestamp) && same_bits(p.lla[0], f.latitude) &&
+         same_bits(p.lla[1], f.longitude) && same_bits(p.lla[2], f.altitude);
+    for (int i = 0; i < 3; i++) {
+        ok = ok && same_bits(p.position[i], f.position[i]) && same_float(p.velocity[i], f.velocity[i]) &&
+             same_float(p.gyro[i], f.gyro[i]) && same_float(p.accel_body[i], f.accel_body[i]);
+    }
+    for (int i = 0; i < 4; i++) ok = ok && same_float(p.quaternion[i], f.quaternion[i]);
+    for (int i = 0; i < 12; i++) ok = ok && same_float(p.rc[i], f.rc[i]);
+    return ok && same_float(p.airspeed, f.airspeed) && same_float(p.rng_1, f.rng_1);
+}
+
+static bool check_malformed(const SensorFrame& f){
+    uint8_t buf[256];
+    sensor_packet p;
+    bool ok = true;
+    const int len = encode_binary_frame(buf, sizeof(buf), f, JsonOptions{}, 7);
+    ok = ok && encode_binary_frame(buf, SENSOR_PACKET_SIZE_V1 - 1, f, JsonOptions{}, 7) == -1;
+    ok = ok && memcmp(buf, "APSF", 4) == 0;
+
+    ok = ok && sensor_packet_decode(buf, (size_t)len - 1, &p) == SENSOR_PACKET_ERR_SHORT;
+    ok = ok && sensor_packet_decode(buf, 8, &p) == SENSOR_PACKET_ERR_SHORT;
+
+    uint8_t bad[256];
+    memcpy(bad, buf, (size_t)len);
+    bad[0] = '{';
+    ok = ok && sensor_packet_decode(bad, (size_t)len, &p) == SENSOR_PACKET_ERR_MAGIC;
+
+    memcpy(bad, buf, (size_t)len);
+    bad[4] = SENSOR_PACKET_VERSION + 1;
+    ok = ok && sensor_packet_decode(bad, (size_t)len, &p) == SENSOR_PACKET_ERR_VERSION;
+
+    memcpy(bad, buf, (size_t)len);
+    bad[6] = 100;                   // length below the version 1 size
+    ok = ok && sensor_packet_decode(bad, (size_t)len, &p) == SENSOR_PACKET_ERR_SHORT;
+
+    // A later minor revision appends fields: same version, larger length.
+    memcpy(bad, buf, (size_t)len);
+    memset(bad + len, 0xA5, 20);
+    bad[6] = (uint8_t)(len + 20);
+    ok = ok && sensor_packet_decode(bad, (size_t)len + 20, &p) == SENSOR_PACKET_OK && p.length == len + 20;
+    ok = ok && p.seq == 7 && same_bits(p.timestamp, f.timestamp) && same_float(p.rc[11], f.rc[11]);
+
+    printf("malformed: %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// Emits the same valid sample on every dispatch.
+class SyntheticSource : public SensorSource {
+public:
+    const char* name() const override { return "Synthetic"; }
+    bool open() override { return true; }
+    void close() override {}
+    bool dispatch(SensorTx& tx) override {
+        RawSensors R{};
+        R.lat_deg = -35.363261; R.lon_deg = 149.165230;
+        R.alt_msl_ft = 2000; R.ias_kt = 80; R.hdg_true_deg = 90;
+        tx.on_sample(R);
+        return true;
+    }
+};
+
+// SITL on binary, listeners on JSON and binary: each sink must only see
+// its own format, the binary ones with the same consecutive sequence.
+static bool check_destinations(uint16_t port_base){
+    const uint16_t port_sitl = port_base, port_json = (uint16_t)(port_base + 1), port_bin = (uint16_t)(port_base + 2);
+    Shared S;
+    S.dest.port_rx = (uint16_t)(port_base + 3);
+    S.rate_hz = 200;
+    S.sitl_format = FRAME_BINARY;
+    char listeners[64];
+    snprintf(listeners, sizeof(listeners), "127.0.0.1:%u, 127.0.0.1:%u/binary", (unsigned)port_json, (unsigned)port_bin);
+    S.sensor_listeners = listeners;
+    for (int i = 0; i < 12; i++) S.rc_out[i] = -1.0;
+    S.cfg.publish(snapshot_config(S));
+    S.sitl_addr.sin_family = AF_INET;
+    S.sitl_addr.sin_port = htons(port_sitl);
+    inet_pton(AF_INET, "127.0.0.1", &S.sitl_addr.sin_addr);
+    S.sitl_addr_known = true;
+
+    UdpRxRaw sink[3];
+    const uint16_t ports[3] = { port_sitl, port_json, port_bin };
+    for (int i = 0; i < 3; i++) sink[i].open(ports[i]);
+
+    BridgeHooks hooks;
+    std::atomic<bool> run_flag{true};
+    SyntheticSource src;
+    std::thread t_sim(sim_loop, std::ref(S), std::cref(hooks), std::ref(src), std::cref(run_flag));
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    run_flag = false;
+    t_sim.join();
+
+    std::vector<uint32_t> seqs[3];
+    int got[3] = {0, 0, 0}, wrong[3] = {0, 0, 0};
+    uint8_t buf[4096];
+    sockaddr_in from{};
+    for (int i = 0; i < 3; i++) {
+        sink[i].set_nonblocking(true);
+        int len;
+        while ((len = sink[i].recv(buf, sizeof(buf), &from)) > 0) {
+            got[i]++;
+            sensor_packet p;
+            const bool is_bin = sensor_packet_decode(buf, (size_t)len, &p) == SENSOR_PACKET_OK;
+            if (is_bin) seqs[i].push_back(p.seq);
+            if (is_bin != (i != 1) || (i == 1 && buf[0] != '{')) wrong[i]++;
+        }
+    }
+    bool ok = got[0] > 10 && got[1] == got[0] && got[2] == got[0] && seqs[0] == seqs[2];
+    for (int i = 0; i < 3; i++) ok = ok && wrong[i] == 0;
+    for (size_t k = 1; k < seqs[0].size(); k++) ok = ok && seqs[0][k] == seqs[0][k - 1] + 1;
+    printf("destinations: sitl %d binary, listener %d json, listener %d binary, %d wrong format: %s\n",
+           got[0], got[1], got[2], wrong[0] + wrong[1] + wrong[2], ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    const int frames = argc > 1 ? atoi(argv[1]) : 200000;
+    const uint16_t port_base = (uint16_t)(argc > 2 ? atoi(argv[2]) : 19900);
+
+    std::vector<SensorFrame> set(1024);
+    double rc[12];
+    for (size_t i = 0; i < set.size(); i++) {
+        for (int k = 0; k < 12; k++) rc[k] = (k % 3 == 0) ? -1.0 : uni(0, 1);
+        build_sensor_frame(set[i], random_sample(), i * 0.001, rc);
+    }
+    std::vector<JsonOptions> opts;
+    for (int pm = 0; pm < 3; pm++) {
+        for (int ts = 0; ts < 2; ts++) {
+            for (int ls = 0; ls < 2; ls++) opts.push_back(JsonOptions{pm, ts != 0, ls != 0});
+        }
+    }
+
+    uint8_t pkt[256];
+    size_t bad = 0;
+    uint32_t seq = 0xFFFFFF00u;     // crosses the wrap
+    for (const JsonOptions& o : opts) {
+        for (const SensorFrame& f : set) {
+            sensor_packet p;
+            const int len = encode_binary_frame(pkt, sizeof(pkt), f, o, seq);
+            if (len != SENSOR_PACKET_SIZE_V1 || sensor_packet_decode(pkt, (size_t)len, &p) != SENSOR_PACKET_OK ||
+                !matches(p, f, o, seq)) bad++;
+            seq++;
+        }
+    }
+    printf("round trip: %zu frames, %zu mismatches\n", set.size() * opts.size(), bad);
+    bool ok = bad == 0;
+    ok = check_malformed(set[0]) && ok;
+    ok = check_destinations(port_base) && ok;
+
+    const JsonOptions& o = opts[9];
+    const JsonProgram& prog = json_program_for(o);
+    char json[4096];
+    size_t json_bytes = 0, bin_bytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) json_bytes += (size_t)prog.encode(json, sizeof(json), set[i & 1023]);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) bin_bytes += (size_t)encode_binary_frame(pkt, sizeof(pkt), set[i & 1023], o, (uint32_t)i);
+    auto t2 = std::chrono::steady_clock::now();
+    const double s_json = std::chrono::duration<double>(t1 - t0).count();
+    const double s_bin = std::chrono::duration<double>(t2 - t1).count();
+    printf("%-8s %11.0f frames/s  %7.3f us/frame  %6.1f bytes/frame\n", "json", frames / s_json,
+           s_json * 1e6 / frames, (double)json_bytes / frames);
+    printf("%-8s %11.0f frames/s  %7.3f us/frame  %6.1f bytes/frame\n", "binary", frames / s_bin,
+           s_bin * 1e6 / frames, (double)bin_bytes / frames);
+    printf("binary: %.1fx faster, %.1fx smaller\n", s_json / s_bin, (double)json_bytes / (double)bin_bytes);
+    return ok ? 0 : 1;
+}
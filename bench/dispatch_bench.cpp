@@ -0,0 +1,150 @@
+/*
+   MSFS 202x–ArduPilot Bridge - event-driven sim dispatch benchmark.
+
+   Runs sim_loop against a mock sim that produces a frame every 1/fps s on
+   its own thread, the way SimConnect delivers data, once polled (the loop
+   picks the frame up on its next TX tick) and once event-driven (the mock
+   signals the source's WaitEvent and the loop wakes on it). Reports the
+   ingest latency from the frame being produced to on_sample(), the error
+   of the arrival stamp SensorTx stores in its history, and sim loop
+   iterations per second. Exits nonzero if the event mode does not cut
+   the worst-case ingest latency below the TX period, or misses frames.
+
+   Usage: dispatch_bench [tx_hz] [fps] [seconds]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+#include "core/platform.h"
+#include "core/sensor_source.h"
+
+class MockSimSource : public SensorSource {
+public:
+    explicit MockSimSource(bool event) : event_(event) {}
+
+    const char* name() const override { return "MockSim"; }
+    bool open() override { return true; }
+    void close() override {}
+    WaitEvent* data_event() override { return event_ ? &ev_ : nullptr; }
+
+    bool dispatch(SensorTx& tx) override {
+        dispatches_++;
+        std::deque<double> ready;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            ready.swap(queue_);
+        }
+        for (double t_made : ready) {
+            RawSensors R{};
+            R.lat_deg = -35.363261; R.lon_deg = 149.165230;
+            R.alt_msl_ft = 2000; R.ias_kt = 80; R.hdg_true_deg = 90;
+            tx.on_sample(R);
+            const double t_seen = tx.history().newest().t_s;
+            latency_us_.push_back((t_seen - t_made) * 1e6);
+        }
+        return true;
+    }
+
+    // Producer side, on the mock sim's thread.
+    void produce(){
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            queue_.push_back(_now_s());
+        }
+        if (event_) ev_.signal();
+        produced_++;
+    }
+
+    std::vector<double> latency_us_;
+    uint64_t dispatches_ = 0;
+    std::atomic<uint64_t> produced_{0};
+
+private:
+    bool event_;
+    WaitEvent ev_;
+    std::mutex m_;
+    std::deque<double> queue_;
+};
+
+struct Result {
+    double p50_us = 0, p99_us = 0, max_us = 0;
+    double loops_per_s = 0;
+    uint64_t produced = 0, received = 0;
+};
+
+static Result run(bool event, int tx_hz, double fps, double seconds){
+    Shared S;
+    S.rate_hz = tx_hz;
+    S.dest.port_tx = 19603;
+    S.sim_origin_set = true;
+    S.cfg.publish(snapshot_config(S));
+
+    BridgeHooks hooks;
+    std::atomic<bool> run_flag{true};
+    MockSimSource src(event);
+    std::thread t_sim(sim_loop, std::ref(S), std::cref(hooks), std::ref(src), std::cref(run_flag));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    const uint64_t d0 = src.dispatches_;
+    // Frames land at an offset that walks across the TX period, like a
+    // sim clock that is not locked to ours.
+    auto next = t0 + period;
+    while (next - t0 < std::chrono::duration<double>(seconds)) {
+        std::this_thread::sleep_until(next);
+        src.produce();
+        next += period;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    run_flag = false;
+    t_sim.join();
+
+    Result r;
+    std::vector<double> l = src.latency_us_;
+    std::sort(l.begin(), l.end());
+    r.produced = src.produced_.load();
+    r.received = l.size();
+    if (!l.empty()) {
+        r.p50_us = l[l.size() / 2];
+        r.p99_us = l[std::min(l.size() - 1, (size_t)(l.size() * 0.99))];
+        r.max_us = l.back();
+    }
+    r.loops_per_s = (double)(src.dispatches_ - d0) / elapsed;
+    return r;
+}
+
+int main(int argc, char** argv){
+    const int tx_hz = argc > 1 ? atoi(argv[1]) : 100;
+    const double fps = argc > 2 ? atof(argv[2]) : 61.0;
+    const double seconds = argc > 3 ? atof(argv[3]) : 5.0;
+
+    printf("TX %d Hz, mock sim %.1f fps, %.0f s\n", tx_hz, fps, seconds);
+    printf("%-8s %10s %10s %10s %10s %10s\n", "mode", "frames", "p50 us", "p99 us", "max us", "loops/s");
+    const Result poll = run(false, tx_hz, fps, seconds);
+    const Result ev = run(true, tx_hz, fps, seconds);
+    auto row = [](const char* name, const Result& r){
+        printf("%-8s %10llu %10.0f %10.0f %10.0f %10.0f\n", name, (unsigned long long)r.received, r.p50_us, r.p99_us, r.max_us, r.loops_per_s);
+    };
+    row("poll", poll);
+    row("event", ev);
+
+    const double tx_period_us = 1e6 / tx_hz;
+    bool ok = ev.received == ev.produced && poll.received == poll.produced;
+    ok = ok && ev.p99_us < tx_period_us / 2 && ev.p50_us < poll.p50_us;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor fan-out benchmark.
+
+   Plays a lockstep SITL against the bridge over loopback UDP (send one
+   servo_packet_16, wait for the JSON reply), first alone and then with
+   sitl_shadows on, a second SITL sending servo packets of its own and a
+   set of configured listeners. Reports steps/s, reply turnaround and the
+   frames and errors counted for each destination. Exits nonzero if a
+   listener or the shadow misses a frame or gets different bytes than the
+   primary, if the shadow's servo outputs reach the sim side or takes a
+   reply, or if the per-destination counters disagree with what arrived.
+   On Linux builds with io_uring both runs repeat on that backend.
+
+   Usage: fanout_bench [steps] [listeners] [port_rx]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+#include "core/net.h"
+#include "core/sensor_source.h"
+#include "core/uring_net.h"
+
+// Emits the same valid sample on every dispatch.
+class SyntheticSource : public SensorSource {
+public:
+    const char* name() const override { return "Synthetic"; }
+    bool open() override { return true; }
+    void close() override {}
+    bool dispatch(SensorTx& tx) override {
+        RawSensors R{};
+        R.lat_deg = -35.363261; R.lon_deg = 149.165230;
+        R.alt_msl_ft = 2000; R.ias_kt = 80; R.hdg_true_deg = 90;
+        tx.on_sample(R);
+        return true;
+    }
+};
+
+static sockaddr_in loopback(uint16_t port){
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &a.sin_addr);
+    return a;
+}
+
+// One run; prints its row and the per-destination counters, returns false
+// on any mismatch.
+static bool run(const char* name, int backend, int steps, int listeners, uint16_t port_rx){
+    const bool fanout = listeners > 0;
+    const uint16_t port_sitl = (uint16_t)(port_rx + 1);
+    const uint16_t port_shadow = (uint16_t)(port_rx + 2);
+    const uint16_t port_listen = (uint16_t)(port_rx + 10);
+
+    Shared S;
+    S.dest.port_rx = port_rx;
+    S.lockstep_tx = true;
+    S.net_backend = backend;
+    S.sitl_shadows = fanout;
+    for (int i = 0; i < listeners; i++) {
+        char item[32];
+        snprintf(item, sizeof(item), "%s127.0.0.1:%u", i ? "," : "", (unsigned)(port_listen + i));
+        S.sensor_listeners += item;
+    }
+    for (int i = 0; i < 12; i++) S.rc_out[i] = -1.0;
+    S.cfg.publish(snapshot_config(S));
+
+    std::vector<UdpRxRaw> sinks(listeners);
+    for (int i = 0; i < listeners; i++) sinks[i].open((uint16_t)(port_listen + i));
+
+    BridgeHooks hooks;
+    std::atomic<bool> run_flag{true};
+    SyntheticSource src;
+    std::thread t_rx(rx_loop, std::ref(S), std::cref(hooks), std::cref(run_flag));
+    std::thread t_sim(sim_loop, std::ref(S), std::cref(hooks), std::ref(src), std::cref(run_flag));
+
+    UdpRxRaw sitl, shadow;
+    sitl.open(port_sitl);
+    shadow.open(port_shadow);
+    const sockaddr_in bridge = loopback(port_rx);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    servo_packet_16 pkt{};
+    pkt.frame_rate = 1000;
+    for (int i = 0; i < 16; i++) pkt.pwm[i] = 1500;
+    servo_packet_16 spkt = pkt;
+    for (int i = 0; i < 16; i++) spkt.pwm[i] = 1100;
+
+    uint8_t reply[4096], got[4096];
+    sockaddr_in from{};
+    bool ok = true;
+    int missing = 0;
+
+    // Warm-up: the bridge learns the primary, then the shadow.
+    for (int i = 0; i < 20; i++) {
+        pkt.frame_count = (uint32_t)i;
+        sitl.send_to(&pkt, sizeof(pkt), &bridge);
+        sitl.recv(reply, sizeof(reply), &from);
+    }
+    if (fanout) {
+        spkt.frame_count = 1;
+        shadow.send_to(&spkt, sizeof(spkt), &bridge);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    // Empty every socket before counting.
+    auto drain = [&](UdpRxRaw& s){
+        int n = 0;
+        s.set_nonblocking(true);
+        while (s.recv(got, sizeof(got), &from) > 0) n++;
+        s.set_nonblocking(false);
+        return n;
+    };
+    drain(sitl);
+    drain(shadow);
+    for (auto& s : sinks) drain(s);
+    uint64_t base[kSensorDestMax] = {};
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    {
+        std::lock_guard<std::mutex> lk(S.m_gui);
+        for (int i = 0; i < S.dest_status_n; i++) base[i] = S.dest_status[i].frames;
+    }
+
+    std::vector<double> rt;
+    rt.reserve(steps);
+    int shadow_missing = 0, listener_missing = 0, mismatched = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++) {
+        pkt.frame_count = (uint32_t)(20 + i);
+        auto ts = std::chrono::steady_clock::now();
+        sitl.send_to(&pkt, sizeof(pkt), &bridge);
+        // Up to a second, past the sockets' 10 ms receive timeout, so a
+        // copy late on a loaded machine is not counted as missing.
+        int len = sitl.wait_readable(1000) > 0 ? sitl.recv(reply, sizeof(reply), &from) : 0;
+        if (len <= 0) { missing++; continue; }
+        rt.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - ts).count());
+        if (!fanout) continue;
+
+        // The shadow keeps stepping too; it must be fed, never answered.
+        spkt.frame_count = (uint32_t)(2 + i);
+        shadow.send_to(&spkt, sizeof(spkt), &bridge);
+        int sl = shadow.wait_readable(1000) > 0 ? shadow.recv(got, sizeof(got), &from) : 0;
+        if (sl <= 0) shadow_missing++;
+        else if (sl != len || memcmp(got, reply, (size_t)len) != 0) mismatched++;
+        for (auto& s : sinks) {
+            int ll = s.wait_readable(1000) > 0 ? s.recv(got, sizeof(got), &from) : 0;
+            if (ll <= 0) listener_missing++;
+            else if (ll != len || memcmp(got, reply, (size_t)len) != 0) mismatched++;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    run_flag = false;
+    t_sim.join();
+    t_rx.join();
+
+    std::sort(rt.begin(), rt.end());
+    const int expect_dests = fanout ? 2 + listeners : 1;
+    printf("%-10s %-8d %10.0f %9.1f %9.1f %8d\n", name, expect_dests, steps / elapsed,
+           rt.empty() ? 0.0 : rt[rt.size() / 2], rt.empty() ? 0.0 : rt.back(), missing);
+
+    const int answered = steps - missing;
+    if (S.dest_status_n != expect_dests) {
+        printf("  %d destinations, expected %d\n", S.dest_status_n, expect_dests);
+        ok = false;
+    }
+    for (int i = 0; i < S.dest_status_n; i++) {
+        const SensorDestStatus& d = S.dest_status[i];
+        const uint64_t frames = d.frames - base[i];
+        printf("  -> port %u %-8s %8llu frames %5llu errors %8.0f Hz\n", (unsigned)ntohs(d.addr.sin_port),
+               sensor_dest_kind_name(d.kind), (unsigned long long)frames, (unsigned long long)d.errors, d.rate_hz);
+        if (frames != (uint64_t)answered || d.errors != 0) ok = false;
+    }
+    if (fanout) {
+        const bool servo_clean = S.servo.read().pwm[0] == 1500;
+        if (shadow_missing || listener_missing || mismatched || !servo_clean || S.rx_stats.shadow.load() < (uint64_t)steps) {
+            printf("  shadow missed %d, listeners missed %d, %d differed, shadow packets %llu, shadow servo %s\n",
+                   shadow_missing, listener_missing, mismatched, (unsigned long long)S.rx_stats.shadow.load(),
+                   servo_clean ? "ignored" : "APPLIED");
+            ok = false;
+        }
+    }
+    return ok && missing == 0;
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    const int steps = argc > 1 ? atoi(argv[1]) : 3000;
+    const int listeners = argc > 2 ? std::max(1, std::min(atoi(argv[2]), kSensorDestMax - 2)) : 6;
+    const uint16_t port_rx = (uint16_t)(argc > 3 ? atoi(argv[3]) : 19702);
+
+    printf("lockstep, %d steps; fan-out = primary + 1 shadow + %d listeners\n", steps, listeners);
+    printf("%-10s %-8s %10s %9s %9s %8s\n", "backend", "dests", "steps/s", "p50 us", "max us", "missing");
+
+    bool ok = true;
+    const int backends[] = { NET_SOCKETS, NET_IO_URING };
+    for (int backend : backends) {
+        const char* name = backend == NET_IO_URING ? "io_uring" : "sockets";
+        if (backend == NET_IO_URING) {
+            // Same probe SensorTx does; skip the rows where it would fall back.
+            UdpTx probe;
+            UringUdpTx ring;
+            if (!probe.open("127.0.0.1", port_rx) || !ring.open(probe.handle())) {
+                printf("%-10s unavailable\n", name);
+                continue;
+            }
+        }
+        for (int fan = 0; fan < 2; fan++) ok = run(name, backend, steps, fan ? listeners : 0, port_rx) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sim frame clock estimator harness.
+
+   Feeds FrameClock synthetic frame arrival sequences with a known true
+   clock: steady 60 fps with Gaussian arrival jitter, a frame rate drifting
+   from 60 to 40 fps, randomly skipped frames, a 2 s stall and frames
+   delivered in late pairs. For each it reports the period error, the
+   spread (standard deviation) of the de-jittered frame time against the
+   true one, and the same
+   for the old 0.8/0.2 EMA over millisecond intervals (raw arrival stamp
+   as frame time). Exits nonzero when the estimator misses its bounds.
+
+   Usage: frame_clock_bench [jitter_ms]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "core/frame_clock.h"
+
+struct Frame { double t_true, t_arrive, period; };
+
+struct Score {
+    double period_err_max = 0.0;    // relative, after settling
+    double phase_rms = 0.0;         // seconds, after settling
+    double ema_period_err_max = 0.0;
+    double raw_phase_rms = 0.0;
+    FrameClockStats stats;
+    bool stall_seen = false;
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what){
+    if (!ok) { printf("FAIL: %s\n", what); failures++; }
+}
+
+// Old estimator: EMA over whole-millisecond intervals in 1..500 ms.
+struct Ema {
+    double dt_ms = 33.3;
+    uint64_t last_ms = 0;
+    void on_frame(double t_s){
+        uint64_t now = (uint64_t)(t_s * 1000.0);
+        double dt = now > last_ms ? (double)(now - last_ms) : 0.0;
+        last_ms = now;
+        if (dt > 1 && dt < 500) dt_ms = 0.8 * dt_ms + 0.2 * dt;
+    }
+};
+
+static Score score(const std::vector<Frame>& frames, double settle_s){
+    Score s;
+    FrameClock fc;
+    Ema ema;
+    double sum = 0.0, sq = 0.0, raw_sum = 0.0, raw_sq = 0.0;
+    int n = 0;
+    const double t0 = frames.front().t_true;
+    for (size_t i = 0; i < frames.size(); i++) {
+        const Frame& f = frames[i];
+        if (i > 0 && fc.stalled(f.t_arrive - 1e-3)) s.stall_seen = true;
+        fc.on_frame(f.t_arrive);
+        ema.on_frame(f.t_arrive);
+        if (f.t_true - t0 < settle_s || !fc.locked()) continue;
+        s.period_err_max = std::fmax(s.period_err_max, std::fabs(fc.period() - f.period) / f.period);
+        s.ema_period_err_max = std::fmax(s.ema_period_err_max, std::fabs(ema.dt_ms / 1000.0 - f.period) / f.period);
+        const double e = fc.last_frame() - f.t_true, r = f.t_arrive - f.t_true;
+        sum += e; sq += e * e;
+        raw_sum += r; raw_sq += r * r;
+        n++;
+    }
+    // The de-jittered time has a constant offset (the mean delivery
+    // delay); only its spread matters to the resampler.
+    if (n) {
+        s.phase_rms = std::sqrt(std::fmax(sq / n - (sum / n) * (sum / n), 0.0));
+        s.raw_phase_rms = std::sqrt(std::fmax(raw_sq / n - (raw_sum / n) * (raw_sum / n), 0.0));
+    }
+    s.stats = fc.stats();
+    return s;
+}
+
+static void row(const char* name, const Score& s){
+    printf("%-18s %9.3f %9.3f %9.0f %9.0f %8llu %8llu %7llu\n", name,
+           s.period_err_max * 100.0, s.ema_period_err_max * 100.0, s.phase_rms * 1e6, s.raw_phase_rms * 1e6,
+           (unsigned long long)s.stats.skipped, (unsigned long long)s.stats.outliers, (unsigned long long)s.stats.stalls);
+}
+
+int main(int argc, char** argv){
+    const double jitter = (argc > 1 ? atof(argv[1]) : 1.0) / 1000.0;
+    std::mt19937 rng(12345);
+    std::normal_distribution<double> noise(0.0, jitter);
+    // Delivery delay is positive: half-normal around a small offset.
+    auto arrive = [&](double t){ return t + 0.5e-3 + std::fabs(noise(rng)); };
+
+    printf("arrival jitter %.2f ms (half-normal)\n", jitter * 1000.0);
+    printf("%-18s %9s %9s %9s %9s %8s %8s %7s\n", "sequence", "per err%", "ema err%", "phase us", "raw us", "skipped", "outlier", "stalls");
+
+    // Steady 60 fps.
+    {
+        std::vector<Frame> f;
+        for (int k = 0; k < 60 * 60; k++) { double t = 1.0 + k / 60.0; f.push_back({t, arrive(t), 1.0 / 60.0}); }
+        Score s = score(f, 5.0);
+        row("steady 60", s);
+        check(s.period_err_max < 0.005, "steady period");
+        check(s.phase_rms < s.raw_phase_rms, "steady phase beats raw stamps");
+    }
+
+    // 60 -> 40 fps over 30 s (sim load rising), then 30 s at 40.
+    {
+        std::vector<Frame> f;
+        double t = 1.0;
+        while (t < 61.0) {
+            double u = std::fmin((t - 1.0) / 30.0, 1.0);
+            double p = 1.0 / (60.0 - 20.0 * u);
+            f.push_back({t, arrive(t), p});
+            t += p;
+        }
+        Score s = score(f, 3.0);
+        row("drift 60->40", s);
+        check(s.period_err_max < 0.02, "drift period");
+    }
+
+    // 5 % of frames never delivered.
+    {
+        std::vector<Frame> f;
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        int dropped = 0;
+        for (int k = 0; k < 60 * 60; k++) {
+            double t = 1.0 + k / 60.0;
+            if (k > 20 && u(rng) < 0.05) { dropped++; continue; }
+            f.push_back({t, arrive(t), 1.0 / 60.0});
+        }
+        Score s = score(f, 5.0);
+        row("5% skipped", s);
+        check(s.period_err_max < 0.005, "skipped period");
+        check(std::llabs((long long)s.stats.skipped - dropped) <= dropped / 5 + 2, "skipped count");
+    }
+
+    // 2 s stall (paused sim), same rate afterwards.
+    {
+        std::vector<Frame> f;
+        for (int k = 0; k < 60 * 30; k++) {
+            double t = 1.0 + k / 60.0 + (k >= 600 ? 2.0 : 0.0);
+            f.push_back({t, arrive(t), 1.0 / 60.0});
+        }
+        Score s = score(f, 5.0);
+        row("2 s stall", s);
+        check(s.stats.stalls == 1 && s.stall_seen, "stall detected");
+        check(s.period_err_max < 0.01, "period kept across stall");
+    }
+
+    // Every 25th frame is 12 ms late and handed over with the next one.
+    {
+        std::vector<Frame> f;
+        for (int k = 0; k < 60 * 60; k++) {
+            double t = 1.0 + k / 60.0;
+            double a = arrive(t);
+            if (k % 25 == 24) a = t + 0.012;
+            if (k % 25 == 0 && k > 0) a = std::fmax(a, f.back().t_arrive);
+            f.push_back({t, a, 1.0 / 60.0});
+        }
+        Score s = score(f, 5.0);
+        row("late pairs", s);
+        check(s.period_err_max < 0.005, "late pairs period");
+        check(s.phase_rms < s.raw_phase_rms, "late pairs phase");
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+/*
+   MSFS 202x–ArduPilot Bridge - frame kernel benchmark.
+
+   Checks build_sensor_frame_lerp() against the scalar path it replaces
+   (lerp_sensors() then build_sensor_frame()) on random sample pairs:
+   every double field must match bit for bit and the quaternion within
+   float rounding. Checks sincos4() against libm over +-4 pi. Then compares
+   ns/frame of the two paths. Exits nonzero on a mismatch.
+
+   Usage: frame_kernel_bench [frames]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "core/frame_kernel.h"
+#include "core/json_frame.h"
+#include "core/resample.h"
+
+static std::mt19937_64 g_rng(12345);
+
+static double uni(double lo, double hi){
+    return std::uniform_real_distribution<double>(lo, hi)(g_rng);
+}
+
+static RawSensors random_sample(){
+    RawSensors R{};
+    R.lat_deg = uni(-90, 90); R.lon_deg = uni(-180, 180);
+    R.alt_msl_ft = uni(-1000, 45000); R.alt_agl_ft = uni(0, 5000);
+    R.pitch_deg = uni(-90, 90); R.bank_deg = uni(-180, 180); R.hdg_true_deg = uni(0, 360);
+    R.ias_kt = uni(0, 400);
+    R.vel_e_fps = uni(-300, 300); R.vel_n_fps = uni(-300, 300); R.vel_u_fps = uni(-50, 50);
+    R.p_rads = uni(-3, 3); R.q_rads = uni(-3, 3); R.r_rads = uni(-3, 3);
+    R.accel_x_fps2 = uni(-100, 100); R.accel_y_fps2 = uni(-100, 100); R.accel_z_fps2 = uni(-100, 100);
+    R.N_m = uni(-1e5, 1e5); R.E_m = uni(-1e5, 1e5); R.U_m = uni(-1e3, 1e4);
+    R.valid = true;
+    return R;
+}
+
+struct Pair {
+    RawSensors a, b;
+    SensorBlock ba, bb;
+    double alpha;
+};
+
+static void scalar_path(SensorFrame& f, const Pair& p, const double rc[12]){
+    RawSensors R = p.b;
+    lerp_sensors(R, p.a, p.b, p.alpha);
+    build_sensor_frame(f, R, 1.0, rc);
+}
+
+static void kernel_path(SensorFrame& f, const Pair& p, const double rc[12]){
+    build_sensor_frame_lerp(f, p.ba, p.bb, p.alpha, 1.0, rc);
+}
+
+typedef void (*FrameFn)(SensorFrame&, const Pair&, const double*);
+
+static double time_ns(FrameFn fn, const std::vector<Pair>& set, const double rc[12], int reps){
+    SensorFrame f;
+    double sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) {
+        for (const Pair& p : set) {
+            fn(f, p, rc);
+            sink += f.position[0] + f.quaternion[0];
+        }
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (sink == 12345.0) printf(" ");
+    return s * 1e9 / ((double)reps * (double)set.size());
+}
+
+int main(int argc, char** argv){
+    const int frames = argc > 1 ? atoi(argv[1]) : 200000;
+    const double rc[12] = {0.5, -1, 0.25, -1, 1, 0, -1, -1, 0.75, -1, -1, 0.1};
+
+    std::vector<Pair> set(4096);
+    for (Pair& p : set) {
+        p.a = random_sample();
+        p.b = random_sample();
+        p.alpha = uni(0, 1);
+        sensor_block_pack(p.ba, p.a);
+        sensor_block_pack(p.bb, p.b);
+    }
+
+    // Every double from velocity to position is compared bit for bit.
+    const size_t span = offsetof(SensorFrame, position) + 3 * sizeof(double) - offsetof(SensorFrame, velocity);
+    size_t field_mismatch = 0;
+    double quat_max = 0.0;
+    for (int i = 0; i < frames; i++) {
+        const Pair& p = set[(size_t)i % set.size()];
+        SensorFrame fs, fk;
+        scalar_path(fs, p, rc);
+        kernel_path(fk, p, rc);
+        if (memcmp(&fs.velocity, &fk.velocity, span) != 0 || fs.timestamp != fk.timestamp ||
+            memcmp(fs.rc, fk.rc, sizeof(fs.rc)) != 0) field_mismatch++;
+        for (int k = 0; k < 4; k++) quat_max = std::max(quat_max, (double)std::fabs(fs.quaternion[k] - fk.quaternion[k]));
+    }
+
+    double sc_max = 0.0;
+    for (int i = 0; i < 1000000; i++) {
+        alignas(32) double x[4], s[4], c[4];
+        for (int k = 0; k < 4; k++) x[k] = uni(-4 * M_PI, 4 * M_PI);
+        sincos4(x, s, c);
+        for (int k = 0; k < 4; k++) {
+            sc_max = std::max(sc_max, std::fabs(s[k] - std::sin(x[k])));
+            sc_max = std::max(sc_max, std::fabs(c[k] - std::cos(x[k])));
+        }
+    }
+
+    printf("kernel isa: %s\n", frame_kernel_isa());
+    printf("%d frames: %zu field mismatches, quaternion max diff %.3g, sincos max error %.3g\n",
+    frames, field_mismatch, quat_max, sc_max);
+
+    const int reps = std::max(1, frames / (int)set.size());
+    double t_scalar = time_ns(scalar_path, set, rc, reps);
+    double t_kernel = time_ns(kernel_path, set, rc, reps);
+    printf("scalar  %7.1f ns/frame\n", t_scalar);
+    printf("kernel  %7.1f ns/frame (%.2fx)\n", t_kernel, t_kernel > 0 ? t_scalar / t_kernel : 0.0);
+
+    bool ok = field_mismatch == 0 && quat_max <= 2.4e-7 && sc_max < 1e-15;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+/*
+   MSFS 202x–ArduPilot Bridge - JSON encoder benchmark.
+
+   Checks that encode_json_frame() is byte-identical to the snprintf
+   reference (format_json_frame) on random frames and on a stress set of
+   raw values, then compares frames/second of the two paths.
+
+   Usage: json_encode_bench [frames] [kernel_values]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "core/json_encode.h"
+#include "core/json_frame.h"
+
+static std::mt19937_64 g_rng(12345);
+
+static double uni(double lo, double hi){
+    return std::uniform_real_distribution<double>(lo, hi)(g_rng);
+}
+
+static RawSensors random_sample(){
+    RawSensors R{};
+    R.lat_deg = uni(-90, 90); R.lon_deg = uni(-180, 180);
+    R.alt_msl_ft = uni(-1000, 45000); R.alt_agl_ft = uni(0, 5000);
+    R.pitch_deg = uni(-90, 90); R.bank_deg = uni(-180, 180); R.hdg_true_deg = uni(0, 360);
+    R.ias_kt = uni(0, 400);
+    R.vel_e_fps = uni(-300, 300); R.vel_n_fps = uni(-300, 300); R.vel_u_fps = uni(-50, 50);
+    R.p_rads = uni(-3, 3); R.q_rads = uni(-3, 3); R.r_rads = uni(-3, 3);
+    R.accel_x_fps2 = uni(-60, 60); R.accel_y_fps2 = uni(-60, 60); R.accel_z_fps2 = uni(-60, 60);
+    R.N_m = uni(-1e5, 1e5); R.E_m = uni(-1e5, 1e5); R.U_m = uni(-1e3, 1e4);
+    R.valid = true;
+    return R;
+}
+
+static bool check_kernel(size_t count){
+    static const int precs[] = {1, 4, 6, 10};
+    const double specials[] = {
+        0.0, -0.0, 0.5, -0.5, 1.5, 2.5, 0.05, 0.25, 0.125, 1e-7, -1e-7, 5e-7, 4.9999999e-7,
+        0.00000049999999999999, 1234567.0000005, 1e15, 1e17, -1e22, 1e300,
+        std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::quiet_NaN()
+    };
+
+    char ref[512], out[512];
+    size_t bad = 0;
+    auto check = [&](double v, int prec){
+        snprintf(ref, sizeof(ref), "%.*f", prec, v);
+        char* e = fmt_fixed(out, out + sizeof(out) - 1, v, prec);
+        if (!e) { bad++; return; }
+        *e = 0;
+        if (strcmp(ref, out) != 0) {
+            if (bad < 10) fprintf(stderr, "mismatch %.17g %%.%df: ref=%s got=%s\n", v, prec, ref, out);
+            bad++;
+        }
+    };
+
+    for (double v : specials) for (int p : precs) check(v, p);
+
+    for (size_t i = 0; i < count; i++) {
+        int p = precs[i % 4];
+        // Mix uniform values, values on exact decimal ties and wide exponents.
+        double v;
+        switch (i % 3) {
+            case 0: v = uni(-1e6, 1e6); break;
+            case 1: v = (double)(int64_t)uni(-1e9, 1e9) / 1e6 + 0.5 / std::pow(10.0, p); break;
+            default: v = std::ldexp(uni(-1, 1), (int)uni(-40, 60)); break;
+        }
+        check(v, p);
+    }
+
+    printf("kernel: %zu values, %zu mismatches\n", count + sizeof(specials) / sizeof(specials[0]) * 4, bad);
+    return bad == 0;
+}
+
+int main(int argc, char** argv){
+    const int frames = argc > 1 ? atoi(argv[1]) : 200000;
+    const size_t kernel_values = argc > 2 ? (size_t)atoll(argv[2]) : 2000000;
+
+    bool ok = check_kernel(kernel_values);
+
+    std::vector<SensorFrame> set(1024);
+    double rc[12];
+    for (size_t i = 0; i < set.size(); i++) {
+        for (int k = 0; k < 12; k++) rc[k] = (k % 3 == 0) ? -1.0 : uni(0, 1);
+        build_sensor_frame(set[i], random_sample(), i * 0.001, rc);
+    }
+
+    // Every pos_mode / time sync / lockstep combination.
+    std::vector<JsonOptions> opts;
+    for (int pm = 0; pm < 3; pm++) {
+        for (int ts = 0; ts < 2; ts++) {
+            for (int ls = 0; ls < 2; ls++) opts.push_back(JsonOptions{pm, ts != 0, ls != 0});
+        }
+    }
+
+    char ref[4096], out[4096];
+    size_t frame_bad = 0;
+    for (const JsonOptions& o : opts) {
+        for (const SensorFrame& f : set) {
+            int a = format_json_frame(ref, sizeof(ref), f, o);
+            int b = encode_json_frame(out, sizeof(out), f, o);
+            if (a != b || memcmp(ref, out, (size_t)(a > 0 ? a : 0)) != 0) {
+                if (frame_bad < 3) fprintf(stderr, "frame mismatch:\n%s%s", ref, out);
+                frame_bad++;
+            }
+        }
+    }
+    printf("frames: %zu checked, %zu mismatches\n", set.size() * opts.size(), frame_bad);
+    ok = ok && frame_bad == 0;
+
+    auto run = [&](const char* name, int (*fn)(char*, size_t, const SensorFrame&, const JsonOptions&)){
+        size_t bytes = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            bytes += (size_t)fn(out, sizeof(out), set[i & 1023], opts[9]);
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        printf("%-8s %9.0f frames/s  %7.3f us/frame  (%zu bytes)\n", name, frames / s, s * 1e6 / frames, bytes);
+        return s;
+    };
+
+    double t_ref = run("snprintf", format_json_frame);
+    double t_enc = run("encoder", encode_json_frame);
+
+    // What SensorTx does: program picked once, then encode() per frame.
+    const JsonProgram& prog = json_program_for(opts[9]);
+    size_t bytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) bytes += (size_t)prog.encode(out, sizeof(out), set[i & 1023]);
+    double t_prog = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%-8s %9.0f frames/s  %7.3f us/frame  (%zu bytes)\n", "program", frames / t_prog, t_prog * 1e6 / frames, bytes);
+
+    printf("speedup: %.2fx (encoder), %.2fx (program)\n", t_ref / t_enc, t_ref / t_prog);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/*
+   MSFS 202x–ArduPilot Bridge - lockstep turnaround benchmark.
+
+   Plays a lockstep SITL against the bridge over loopback UDP: send one
+   servo_packet_16, wait for the JSON reply, repeat. Runs once with the
+   free-running TX accumulator and once with lockstep_tx, and reports
+   SITL steps/s, reply turnaround percentiles, missing replies (timeouts)
+   and extra replies (frames SITL did not ask for). Exits nonzero if the
+   lockstep run misses a reply or sends one SITL did not ask for.
+
+   Usage: lockstep_bench [steps] [port_rx]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+#include "core/net.h"
+#include "core/sensor_source.h"
+
+// Emits the same valid sample on every dispatch.
+class SyntheticSource : public SensorSource {
+public:
+    const char* name() const override { return "Synthetic"; }
+    bool open() override { return true; }
+    void close() override {}
+    bool dispatch(SensorTx& tx) override {
+        RawSensors R{};
+        R.lat_deg = -35.363261; R.lon_deg = 149.165230;
+        R.alt_msl_ft = 2000; R.ias_kt = 80; R.hdg_true_deg = 90;
+        tx.on_sample(R);
+        return true;
+    }
+};
+
+struct RunResult {
+    double steps_per_s;
+    double p50_us, p99_us, max_us;
+    int missing, extra;
+};
+
+static RunResult run(bool lockstep, int steps, uint16_t port_rx){
+    Shared S;
+    S.dest.port_rx = port_rx;
+    S.lockstep_tx = lockstep;
+    S.rate_hz = 1000;
+    for (int i = 0; i < 12; i++) S.rc_out[i] = -1.0;
+    S.cfg.publish(snapshot_config(S));
+
+    BridgeHooks hooks;
+    std::atomic<bool> run_flag{true};
+    SyntheticSource src;
+    std::thread t_rx(rx_loop, std::ref(S), std::cref(hooks), std::cref(run_flag));
+    std::thread t_sim(sim_loop, std::ref(S), std::cref(hooks), std::ref(src), std::cref(run_flag));
+
+    UdpRxRaw sitl;
+    sitl.open((uint16_t)(port_rx + 1));
+    sockaddr_in bridge{};
+    bridge.sin_family = AF_INET;
+    bridge.sin_port = htons(port_rx);
+    inet_pton(AF_INET, "127.0.0.1", &bridge.sin_addr);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    servo_packet_16 pkt{};
+    pkt.frame_rate = 1000;
+    for (int i = 0; i < 16; i++) pkt.pwm[i] = 1500;
+
+    uint8_t buf[4096];
+    sockaddr_in from{};
+
+    // A free-running bridge never goes quiet, so drains are time bounded.
+    auto drain = [&](){
+        int n = 0;
+        auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(30);
+        while (std::chrono::steady_clock::now() < until && sitl.recv(buf, sizeof(buf), &from) > 0) n++;
+        return n;
+    };
+    std::vector<double> rt;
+    rt.reserve(steps);
+    RunResult r{};
+
+    // Warm-up so the bridge learns our address, then drain.
+    for (int i = 0; i < 50; i++) {
+        pkt.frame_count = (uint32_t)i;
+        sitl.send_to(&pkt, sizeof(pkt), &bridge);
+        sitl.recv(buf, sizeof(buf), &from);
+    }
+    drain();
+    uint64_t sent_before = S.tx_stats.frames_sent.load();
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++) {
+        pkt.frame_count = (uint32_t)(50 + i);
+        auto ts = std::chrono::steady_clock::now();
+        sitl.send_to(&pkt, sizeof(pkt), &bridge);
+        // Up to a second, longer than the socket's receive timeout: a
+        // reply late on a loaded machine is slow, not missing.
+        int len = sitl.wait_readable(1000) > 0 ? sitl.recv(buf, sizeof(buf), &from) : 0;
+        if (len <= 0) { r.missing++; continue; }
+        rt.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - ts).count());
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // Frames the bridge sent beyond one per step were not asked for.
+    long long sent = (long long)(S.tx_stats.frames_sent.load() - sent_before);
+    if (sent > steps) r.extra = (int)(sent - steps);
+
+    run_flag = false;
+    t_sim.join();
+    t_rx.join();
+
+    std::sort(rt.begin(), rt.end());
+    r.steps_per_s = steps / elapsed;
+    if (!rt.empty()) {
+        r.p50_us = rt[rt.size() / 2];
+        r.p99_us = rt[std::min(rt.size() - 1, rt.size() * 99 / 100)];
+        r.max_us = rt.back();
+    }
+    return r;
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    const int steps = argc > 1 ? atoi(argv[1]) : 5000;
+    const uint16_t port_rx = (uint16_t)(argc > 2 ? atoi(argv[2]) : 19402);
+
+    printf("%-12s %10s %9s %9s %9s %8s %8s\n", "mode", "steps/s", "p50 us", "p99 us", "max us", "missing", "extra");
+    bool ok = true;
+    for (int lockstep = 0; lockstep < 2; lockstep++) {
+        RunResult r = run(lockstep != 0, steps, port_rx);
+        printf("%-12s %10.0f %9.1f %9.1f %9.1f %8d %8d\n", lockstep ? "lockstep" : "free-run",
+        r.steps_per_s, r.p50_us, r.p99_us, r.max_us, r.missing, r.extra);
+        // Exactly one frame per frame_count is the lockstep promise.
+        if (lockstep) ok = r.missing == 0 && r.extra == 0;
+    }
+    return ok ? 0 : 1;
+}
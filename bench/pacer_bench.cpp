@@ -0,0 +1,125 @@
+/*
+   MSFS 202x–ArduPilot Bridge - TX pacing benchmark.
+
+   Compares the old pacing (sleep_for(1 ms) plus a catch-up accumulator)
+   with TxPacer at several rates. For every "frame" it records the error
+   of the inter-frame interval against the nominal period and reports
+   p50/p99/max error, frames sent back-to-back in a burst (old) or dropped
+   deadlines (pacer), and the CPU time used per wall second.
+
+   Usage: pacer_bench [seconds_per_run] [spin_us]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+#include "core/pacer.h"
+
+using clk = std::chrono::steady_clock;
+
+struct RunResult {
+    uint64_t frames;
+    uint32_t p50_us, p99_us, max_us;
+    uint64_t late;      // bursts (old) or dropped deadlines (pacer)
+    double cpu_pct;
+};
+
+static void record(JitterHistogram& h, clk::time_point& last, bool& have_last, clk::time_point now, double period_s){
+    if (have_last) {
+        double err = std::fabs(std::chrono::duration<double>(now - last).count() - period_s);
+        h.add((uint32_t)std::llround(err * 1e6));
+    }
+    last = now;
+    have_last = true;
+}
+
+// The loop sim_thread used to run: sleep 1 ms, add the measured dt, send
+// every whole period the accumulator holds.
+static RunResult run_legacy(int rate_hz, double seconds){
+    const double target_dt = 1.0 / rate_hz;
+    JitterHistogram h;
+    RunResult r{};
+    clk::time_point last;
+    bool have_last = false;
+
+    std::clock_t c0 = std::clock();
+    auto t0 = clk::now(), t_prev = t0;
+    double acc = 0.0;
+    while (clk::now() - t0 < std::chrono::duration<double>(seconds)) {
+        auto now = clk::now();
+        double dt = std::chrono::duration<double>(now - t_prev).count();
+        if (dt > 0.1) dt = 0.1;
+        t_prev = now;
+        acc += dt;
+
+        int burst = 0;
+        while (acc >= target_dt) {
+            acc -= target_dt;
+            record(h, last, have_last, clk::now(), target_dt);
+            r.frames++;
+            burst++;
+        }
+        if (burst > 1) r.late += (uint64_t)(burst - 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double wall = std::chrono::duration<double>(clk::now() - t0).count();
+    r.cpu_pct = 100.0 * (double)(std::clock() - c0) / CLOCKS_PER_SEC / wall;
+    r.p50_us = h.percentile(0.50);
+    r.p99_us = h.percentile(0.99);
+    r.max_us = h.max();
+    return r;
+}
+
+static RunResult run_pacer(int rate_hz, double seconds, int spin_us){
+    TxPacer p;
+    p.set_period(std::chrono::nanoseconds((int64_t)std::llround(1e9 / rate_hz)));
+    p.set_spin_budget(std::chrono::microseconds(spin_us));
+    RunResult r{};
+
+    std::clock_t c0 = std::clock();
+    auto t0 = clk::now();
+    p.restart();
+    while (clk::now() - t0 < std::chrono::duration<double>(seconds)) {
+        p.wait();
+        r.frames++;
+    }
+    double wall = std::chrono::duration<double>(clk::now() - t0).count();
+    r.cpu_pct = 100.0 * (double)(std::clock() - c0) / CLOCKS_PER_SEC / wall;
+
+    PacerStats s = p.total_stats();
+    r.p50_us = s.p50_us;
+    r.p99_us = s.p99_us;
+    r.max_us = s.max_us;
+    r.late = s.dropped;
+    return r;
+}
+
+int main(int argc, char** argv){
+    const double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    const int spin_us = argc > 2 ? atoi(argv[2]) : 200;
+    static const int rates[] = {400, 500, 1000};
+
+    printf("%-8s %6s %8s %8s %8s %8s %10s %6s\n", "pacing", "Hz", "frames", "p50 us", "p99 us", "max us", "burst/drop", "cpu%");
+    bool ok = true;
+    for (int hz : rates) {
+        RunResult a = run_legacy(hz, seconds);
+        RunResult b = run_pacer(hz, seconds, spin_us);
+        printf("%-8s %6d %8llu %8u %8u %8u %10llu %6.1f\n", "sleep1ms", hz,
+        (unsigned long long)a.frames, a.p50_us, a.p99_us, a.max_us, (unsigned long long)a.late, a.cpu_pct);
+        printf("%-8s %6d %8llu %8u %8u %8u %10llu %6.1f\n", "deadline", hz,
+        (unsigned long long)b.frames, b.p50_us, b.p99_us, b.max_us, (unsigned long long)b.late, b.cpu_pct);
+
+        // The pacer must hold the rate: within 1 % of the nominal count.
+        double expect = hz * seconds;
+        if (std::fabs((double)(b.frames + b.late) - expect) > expect * 0.01) ok = false;
+    }
+    return ok ? 0 : 1;
+}
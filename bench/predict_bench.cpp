@@ -0,0 +1,208 @@
+/*
+   MSFS 202x–ArduPilot Bridge - latency-compensating predictor harness.
+
+   Feeds an analytic climbing turn (with bank, pitch and body rates that
+   match the attitude) into a SensorHistory at the sim rate and, at every
+   TX instant, compares against the exact state at that instant:
+     - linear / cubic: what the resampler sends, a blend between the two
+       newest samples, i.e. one sim frame behind;
+     - predict: SensorPredictor extrapolating the newest sample to now;
+     - lookup: SensorHistory::sample_at() one sim frame in the past,
+       compared against the exact state at that past time.
+   A second run teleports the aircraft 100 m mid-flight and checks that
+   the predictor falls back to hold and then recovers. Then times the
+   predictor. Exits nonzero if prediction is not more accurate than the
+   resampler or the fallback does not trip.
+
+   Usage: predict_bench [sim_hz] [tx_hz] [seconds]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "core/predict.h"
+#include "core/quat.h"
+#include "core/resample.h"
+
+static const double kRe = 6378137.0;
+static const double kLat0 = -35.363261, kLon0 = 149.165230, kAlt0 = 584.0;
+
+static double g_jump_at = -1.0;
+
+static void attitude(double t, double& bank, double& pitch, double& hdg){
+    const double w = 0.25;
+    hdg = std::fmod(300.0 + w * t * 57.295779513082320877, 360.0);
+    bank = 25.0 + 10.0 * std::sin(1.3 * t);
+    pitch = 5.0 * std::sin(0.7 * t);
+}
+
+// Exact aircraft state at time t.
+static RawSensors truth(double t){
+    const double V = 50.0, w = 0.25;           // m/s, rad/s (200 m radius)
+    const double r = V / w;
+
+    double N = r * std::sin(w * t);
+    double E = r * (1.0 - std::cos(w * t));
+    double U = 6.0 * (1.0 - std::cos(0.5 * t));
+    if (g_jump_at >= 0.0 && t >= g_jump_at) N += 100.0;
+
+    RawSensors R{};
+    R.N_m = N; R.E_m = E; R.U_m = U;
+    R.vel_n_fps = V * std::cos(w * t) / 0.3048;
+    R.vel_e_fps = V * std::sin(w * t) / 0.3048;
+    R.vel_u_fps = 3.0 * std::sin(0.5 * t) / 0.3048;
+    R.lat_deg = kLat0 + N / kRe * 57.295779513082320877;
+    R.lon_deg = kLon0 + E / (kRe * std::cos(deg2rad(kLat0))) * 57.295779513082320877;
+    R.alt_msl_ft = (kAlt0 + U) / 0.3048;
+    attitude(t, R.bank_deg, R.pitch_deg, R.hdg_true_deg);
+
+    // Body rates from the attitude derivative, in the frame the predictor
+    // integrates them (roll = -bank, pitch = -pitch, FRD rates -p, -q, r).
+    const double e = 1e-5;
+    double b1, p1, h1;
+    attitude(t + e, b1, p1, h1);
+    Quat q0 = quat_from_euler(-R.bank_deg, -R.pitch_deg, R.hdg_true_deg);
+    Quat q1 = quat_from_euler(-b1, -p1, h1);
+    Quat dq = quat_mul(Quat{q0.w, -q0.x, -q0.y, -q0.z}, q1);
+    if (dq.w < 0.0) dq = Quat{-dq.w, -dq.x, -dq.y, -dq.z};
+    R.p_rads = -2.0 * dq.x / e;
+    R.q_rads = -2.0 * dq.y / e;
+    R.r_rads = 2.0 * dq.z / e;
+
+    R.ias_kt = V / 0.514444;
+    R.valid = true;
+    return R;
+}
+
+static double pos_error(const RawSensors& a, const RawSensors& b){
+    return std::sqrt(std::pow(a.N_m - b.N_m, 2) + std::pow(a.E_m - b.E_m, 2) + std::pow(a.U_m - b.U_m, 2));
+}
+
+static double att_error(const RawSensors& a, const RawSensors& b){
+    return quat_angle_deg(quat_from_euler(a.bank_deg, a.pitch_deg, a.hdg_true_deg),
+                          quat_from_euler(b.bank_deg, b.pitch_deg, b.hdg_true_deg));
+}
+
+struct ErrStats {
+    double sum2 = 0, max = 0;
+    size_t n = 0;
+    void add(double e){ sum2 += e * e; if (e > max) max = e; n++; }
+    double rms() const { return n ? std::sqrt(sum2 / (double)n) : 0.0; }
+};
+
+struct Accuracy { ErrStats pos, att; };
+
+struct Run {
+    Accuracy lin, cub, pred, look;
+    PredictorStats ps;
+    bool holding_at_end = false;
+};
+
+static Run run(double sim_hz, double tx_hz, double seconds, double horizon_s){
+    Run r;
+    const double dt = 1.0 / sim_hz;
+    SensorHistory h;
+    SensorPredictor pred;
+    pred.configure(horizon_s, 2.0);
+
+    int next_sample = 0;
+    const int steps = (int)(seconds * tx_hz);
+    for (int i = 0; i < steps; i++) {
+        const double t = i / tx_hz;
+        while (next_sample * dt <= t) {
+            h.push(next_sample * dt, truth(next_sample * dt));
+            pred.on_sample(h);
+            next_sample++;
+        }
+        if (h.size() < 2) continue;
+
+        const RawSensors x = truth(t);
+        const StampedSensors& b = h.newest(0);
+        const StampedSensors& a = h.newest(1);
+        const double alpha = clampd((t - b.t_s) / dt, 0.0, 1.0);
+
+        RawSensors out = b.R;
+        lerp_sensors(out, a.R, b.R, alpha);
+        r.lin.pos.add(pos_error(out, x));
+        r.lin.att.add(att_error(out, x));
+
+        out = b.R;
+        hermite_sensors(out, a.R, b.R, dt, alpha);
+        r.cub.pos.add(pos_error(out, x));
+        r.cub.att.add(att_error(out, x));
+
+        pred.predict(h, t, out);
+        r.pred.pos.add(pos_error(out, x));
+        r.pred.att.add(att_error(out, x));
+
+        const double tl = t - dt;
+        const bool across_jump = g_jump_at >= 0.0 && tl < g_jump_at + dt && tl > g_jump_at - 2.0 * dt;
+        if (!across_jump && h.sample_at(tl, out)) {
+            RawSensors xl = truth(tl);
+            r.look.pos.add(pos_error(out, xl));
+            r.look.att.add(att_error(out, xl));
+        }
+    }
+    r.ps = pred.stats();
+    r.holding_at_end = pred.holding();
+    return r;
+}
+
+static double time_ns(int n){
+    SensorHistory h;
+    SensorPredictor pred;
+    pred.configure(0.05, 2.0);
+    for (int i = 0; i < 8; i++) h.push(i / 30.0, truth(i / 30.0));
+    RawSensors out;
+    double sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        pred.predict(h, 7.0 / 30.0 + (i & 1023) * 3e-5, out);
+        sink += out.N_m;
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (sink == 12345.0) printf(" ");
+    return s * 1e9 / n;
+}
+
+int main(int argc, char** argv){
+    const double sim_hz = argc > 1 ? atof(argv[1]) : 30.0;
+    const double tx_hz = argc > 2 ? atof(argv[2]) : 1000.0;
+    const double seconds = argc > 3 ? atof(argv[3]) : 60.0;
+    const double horizon_s = 1.5 / sim_hz;
+
+    printf("%.0f Hz sim -> %.0f Hz TX, %.0f s, horizon %.1f ms\n", sim_hz, tx_hz, seconds, horizon_s * 1e3);
+    printf("%-8s %10s %10s %9s %9s\n", "mode", "pos rms m", "pos max m", "att rms", "att max");
+    auto row = [](const char* name, const Accuracy& a){
+        printf("%-8s %10.5f %10.5f %9.4f %9.4f\n", name, a.pos.rms(), a.pos.max, a.att.rms(), a.att.max);
+    };
+
+    Run smooth = run(sim_hz, tx_hz, seconds, horizon_s);
+    row("linear", smooth.lin);
+    row("cubic", smooth.cub);
+    row("predict", smooth.pred);
+    row("lookup", smooth.look);
+    printf("predictor: %llu scored, %llu fallbacks, max one-frame error %.4f m\n",
+    (unsigned long long)smooth.ps.scored, (unsigned long long)smooth.ps.fallbacks, smooth.ps.max_err_m);
+
+    g_jump_at = seconds * 0.5;
+    Run jump = run(sim_hz, tx_hz, seconds, horizon_s);
+    printf("100 m jump at %.1f s: %llu fallbacks, %s at end\n", g_jump_at,
+    (unsigned long long)jump.ps.fallbacks, jump.holding_at_end ? "holding" : "predicting");
+
+    bool ok = smooth.pred.pos.rms() < smooth.lin.pos.rms() && smooth.pred.att.rms() < smooth.lin.att.rms();
+    ok = ok && smooth.pred.pos.rms() < smooth.cub.pos.rms();
+    ok = ok && smooth.ps.fallbacks == 0 && smooth.look.pos.max < 0.01;
+    ok = ok && jump.ps.fallbacks >= 1 && !jump.holding_at_end;
+
+    printf("predict %7.1f ns/frame\n", time_ns(2000000));
+
+    return ok ? 0 : 1;
+}
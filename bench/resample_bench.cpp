@@ -0,0 +1,233 @@
+/*
+   MSFS 202x–ArduPilot Bridge - resampler accuracy harness and benchmark.
+
+   Samples two analytic trajectories at the sim rate: a climbing turn with
+   bank and pitch oscillations (heading wraps through 360 deg) and the
+   same turn with a continuous aileron roll (bank wraps through 180 deg).
+   Upsamples them to the TX rate with lerp_sensors() and hermite_sensors()
+   and compares every output against the exact state at that instant:
+   position and velocity error (m, m/s), attitude error (deg, angle of the
+   relative rotation) and position/velocity consistency (finite-difference
+   velocity of the output positions against the output velocities, m/s,
+   which is what an EKF sees as kinks). Then times both resamplers. Exits
+   nonzero if the cubic path is not the more accurate one.
+
+   A last case runs the bridge's blend (resample_blend() on a locked
+   FrameClock, arrivals with latency and jitter) through frames the sim
+   skipped, and compares the cubic output with the exact state at the sim
+   time it stands for: a blend over the pair's own spacing against one
+   over a single clock period. Exits nonzero if the spacing blend is not
+   the better one across the skips, or if it runs faster than real time.
+
+   Usage: resample_bench [sim_hz] [tx_hz] [seconds]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "core/resample.h"
+
+static const double kRe = 6378137.0;
+static const double kLat0 = -35.363261, kLon0 = 149.165230, kAlt0 = 584.0;
+
+static bool g_roll = false;
+
+// Exact aircraft state at time t.
+static RawSensors truth(double t){
+    const double V = 50.0, w = 0.25;           // m/s, rad/s (200 m radius)
+    const double r = V / w;
+
+    double N = r * std::sin(w * t);
+    double E = r * (1.0 - std::cos(w * t));
+    double U = 6.0 * (1.0 - std::cos(0.5 * t));
+    double vn = V * std::cos(w * t);
+    double ve = V * std::sin(w * t);
+    double vu = 3.0 * std::sin(0.5 * t);
+
+    RawSensors R{};
+    R.N_m = N; R.E_m = E; R.U_m = U;
+    R.vel_n_fps = vn / 0.3048; R.vel_e_fps = ve / 0.3048; R.vel_u_fps = vu / 0.3048;
+    R.lat_deg = kLat0 + N / kRe * 57.295779513082320877;
+    R.lon_deg = kLon0 + E / (kRe * std::cos(deg2rad(kLat0))) * 57.295779513082320877;
+    R.alt_msl_ft = (kAlt0 + U) / 0.3048;
+
+    // Start at 300 deg so the run crosses north.
+    R.hdg_true_deg = std::fmod(300.0 + w * t * 57.295779513082320877, 360.0);
+    R.bank_deg = 25.0 + 10.0 * std::sin(1.3 * t);
+    if (g_roll) R.bank_deg = std::remainder(R.bank_deg + 90.0 * t, 360.0);
+    R.pitch_deg = 5.0 * std::sin(0.7 * t);
+    R.ias_kt = V / 0.514444;
+    R.valid = true;
+    return R;
+}
+
+static double att_error_deg(const RawSensors& a, const RawSensors& b){
+    auto q = [](const RawSensors& R, double out[4]){
+        double r = deg2rad(R.bank_deg) * 0.5, p = deg2rad(R.pitch_deg) * 0.5, y = deg2rad(R.hdg_true_deg) * 0.5;
+        double cr = std::cos(r), sr = std::sin(r), cp = std::cos(p), sp = std::sin(p), cy = std::cos(y), sy = std::sin(y);
+        out[0] = cr * cp * cy + sr * sp * sy;
+        out[1] = sr * cp * cy - cr * sp * sy;
+        out[2] = cr * sp * cy + sr * cp * sy;
+        out[3] = cr * cp * sy - sr * sp * cy;
+    };
+    double qa[4], qb[4];
+    q(a, qa); q(b, qb);
+    double d = std::fabs(qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3]);
+    return 2.0 * std::acos(std::min(1.0, d)) * 57.295779513082320877;
+}
+
+struct ErrStats {
+    double sum2 = 0, max = 0;
+    size_t n = 0;
+    void add(double e){ sum2 += e * e; if (e > max) max = e; n++; }
+    double rms() const { return n ? std::sqrt(sum2 / (double)n) : 0.0; }
+};
+
+struct Accuracy { ErrStats pos, vel, att, kink; };
+
+typedef void (*ResampleFn)(RawSensors&, const RawSensors&, const RawSensors&, double, double);
+
+static void lerp_fn(RawSensors& o, const RawSensors& a, const RawSensors& b, double, double t){ lerp_sensors(o, a, b, t); }
+
+static Accuracy measure(ResampleFn fn, double sim_hz, double tx_hz, double seconds){
+    Accuracy acc;
+    const double dt = 1.0 / sim_hz;
+    const int steps = (int)(seconds * tx_hz);
+    RawSensors prev{};
+    for (int i = 0; i < steps; i++) {
+        double t = i / tx_hz;
+        double t0 = std::floor(t / dt) * dt;
+        RawSensors a = truth(t0), b = truth(t0 + dt), out = a;
+        fn(out, a, b, dt, (t - t0) / dt);
+
+        RawSensors x = truth(t);
+        acc.pos.add(std::sqrt(std::pow(out.N_m - x.N_m, 2) + std::pow(out.E_m - x.E_m, 2) + std::pow(out.U_m - x.U_m, 2)));
+        acc.vel.add(0.3048 * std::sqrt(std::pow(out.vel_n_fps - x.vel_n_fps, 2) + std::pow(out.vel_e_fps - x.vel_e_fps, 2) +
+                                       std::pow(out.vel_u_fps - x.vel_u_fps, 2)));
+        acc.att.add(att_error_deg(out, x));
+
+        if (i > 0) {
+            double fd_n = (out.N_m - prev.N_m) * tx_hz, fd_e = (out.E_m - prev.E_m) * tx_hz, fd_u = (out.U_m - prev.U_m) * tx_hz;
+            double vn = 0.3048 * 0.5 * (out.vel_n_fps + prev.vel_n_fps);
+            double ve = 0.3048 * 0.5 * (out.vel_e_fps + prev.vel_e_fps);
+            double vu = 0.3048 * 0.5 * (out.vel_u_fps + prev.vel_u_fps);
+            acc.kink.add(std::sqrt(std::pow(fd_n - vn, 2) + std::pow(fd_e - ve, 2) + std::pow(fd_u - vu, 2)));
+        }
+        prev = out;
+    }
+    return acc;
+}
+
+struct SkipAccuracy {
+    ErrStats pos, vel;
+    double rate_max = 0;            // sim seconds shown per real second
+};
+
+// Sim frames at sim_hz, every 'drop_every'th one missing, arriving 5 ms
+// late with +-1 ms jitter; TX at tx_hz. With per_period the blend is the
+// earlier one (clock phase over one period, period as the Hermite span).
+static SkipAccuracy measure_skips(bool per_period, double sim_hz, double tx_hz, double seconds, int drop_every){
+    SkipAccuracy acc;
+    const double P = 1.0 / sim_hz;
+    FrameClock clock(0.5, P);
+    double t_prev = 0, t_last = 0, s_prev = 0, s_last = 0;
+    int next_frame = 0;
+    uint32_t rng = 12345;
+    auto arrival = [&](int k){
+        rng = rng * 1664525u + 1013904223u;
+        return 1.0 + k * P + 0.005 + ((rng >> 8) / 16777216.0 - 0.5) * 0.002;
+    };
+    double t_arr = arrival(0);
+    double shown_prev = -1;
+    const int steps = (int)(seconds * tx_hz);
+    for (int i = 0; i < steps; i++) {
+        const double now = 1.0 + i / tx_hz;
+        while (t_arr <= now) {
+            if (next_frame == 0 || next_frame % drop_every != 0) {
+                clock.on_frame(t_arr);
+                t_prev = t_last; s_prev = s_last;
+                t_last = t_arr; s_last = next_frame * P;
+            }
+            t_arr = arrival(++next_frame);
+        }
+        double alpha, dt;
+        if (!resample_blend(clock, t_prev, t_last, now, alpha, dt) || !clock.locked()) continue;
+        if (per_period) { alpha = clock.phase(now); dt = clock.period(); }
+
+        RawSensors a = truth(s_prev), b = truth(s_last), out = a;
+        hermite_sensors(out, a, b, dt, alpha);
+        // The sim time the output stands for, on the samples' own timeline.
+        const double shown = s_prev + alpha * (s_last - s_prev);
+        if (s_last - s_prev < 1.5 * P) { shown_prev = -1; continue; }
+        RawSensors x = truth(shown);
+        acc.pos.add(std::sqrt(std::pow(out.N_m - x.N_m, 2) + std::pow(out.E_m - x.E_m, 2) + std::pow(out.U_m - x.U_m, 2)));
+        acc.vel.add(0.3048 * std::sqrt(std::pow(out.vel_n_fps - x.vel_n_fps, 2) + std::pow(out.vel_e_fps - x.vel_e_fps, 2) +
+                                       std::pow(out.vel_u_fps - x.vel_u_fps, 2)));
+        if (shown_prev >= 0) acc.rate_max = std::max(acc.rate_max, (shown - shown_prev) * tx_hz);
+        shown_prev = shown;
+    }
+    return acc;
+}
+
+static double time_ns(ResampleFn fn, int n){
+    RawSensors a = truth(1.0), b = truth(1.0 + 1.0 / 30.0), out = a;
+    double sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        fn(out, a, b, 1.0 / 30.0, (i & 1023) / 1024.0);
+        sink += out.N_m;
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (sink == 12345.0) printf(" ");
+    return s * 1e9 / n;
+}
+
+int main(int argc, char** argv){
+    const double sim_hz = argc > 1 ? atof(argv[1]) : 30.0;
+    const double tx_hz = argc > 2 ? atof(argv[2]) : 1000.0;
+    const double seconds = argc > 3 ? atof(argv[3]) : 60.0;
+
+    printf("%.0f Hz -> %.0f Hz, %.0f s per trajectory\n", sim_hz, tx_hz, seconds);
+    printf("%-6s %-7s %10s %10s %10s %10s %9s %9s %10s\n", "traj", "mode",
+    "pos rms m", "pos max m", "vel rms", "vel max", "att rms", "att max", "kink max");
+    auto row = [](const char* traj, const char* name, const Accuracy& a){
+        printf("%-6s %-7s %10.5f %10.5f %10.5f %10.5f %9.4f %9.4f %10.4f\n", traj, name,
+        a.pos.rms(), a.pos.max, a.vel.rms(), a.vel.max, a.att.rms(), a.att.max, a.kink.max);
+    };
+
+    bool ok = true;
+    for (int roll = 0; roll < 2; roll++) {
+        g_roll = roll != 0;
+        const char* traj = g_roll ? "roll" : "turn";
+        Accuracy lin = measure(lerp_fn, sim_hz, tx_hz, seconds);
+        Accuracy cub = measure(hermite_sensors, sim_hz, tx_hz, seconds);
+        row(traj, "linear", lin);
+        row(traj, "cubic", cub);
+
+        ok = ok && cub.pos.max < lin.pos.max && cub.vel.max < lin.vel.max && cub.kink.max < lin.kink.max;
+        // SLERP and Euler lerp agree on smooth attitude; SLERP must win
+        // once an angle wraps.
+        ok = ok && (g_roll ? cub.att.max < lin.att.max : cub.att.max < lin.att.max * 1.1);
+    }
+
+    g_roll = false;
+    const SkipAccuracy span = measure_skips(false, sim_hz, tx_hz, seconds, 7);
+    const SkipAccuracy period = measure_skips(true, sim_hz, tx_hz, seconds, 7);
+    printf("skipped frames (1 in 7), cubic, across the skips:\n");
+    printf("  %-8s pos max %.5f m, vel max %.5f m/s, up to %.2fx real time\n", "spacing", span.pos.max, span.vel.max, span.rate_max);
+    printf("  %-8s pos max %.5f m, vel max %.5f m/s, up to %.2fx real time\n", "period", period.pos.max, period.vel.max, period.rate_max);
+    ok = ok && span.pos.n > 0 && span.pos.max < period.pos.max && span.vel.max < period.vel.max && span.rate_max < 1.2;
+
+    const int n = 2000000;
+    printf("linear  %7.1f ns/frame\n", time_ns(lerp_fn, n));
+    printf("cubic   %7.1f ns/frame\n", time_ns(hermite_sensors, n));
+
+    return ok ? 0 : 1;
+}
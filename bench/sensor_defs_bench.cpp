@@ -0,0 +1,208 @@
+/*
+   MSFS 202x–ArduPilot Bridge - multi-rate sensor definition harness.
+
+   Builds the sensor definitions against a fake SimConnect that records
+   them, then plays a flight at 60 sim frames per second through the same
+   message formats SimConnect uses: the frame group as a plain FLOAT64
+   block every frame, the slow group as tagged (datum id, value) pairs
+   holding only the values that changed. Every merged sample is compared
+   with the values the fake sim held when it sent them, with and without
+   extra SimVars from the INI. Also checks the generated CSV log schema
+   against the fixed one it replaced. Reports payload bytes per frame and
+   merge time against the single 22-field definition. Exits nonzero on a
+   wrong definition, merged value or log column.
+
+   Usage: sensor_defs_bench [slow_frames] [seconds]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <chrono>
+#include <cstddef>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "core/sensor_defs.h"
+
+class FakeSim : public SimDataApi {
+public:
+    struct Field { std::string simvar; uint32_t datum; };
+    struct Request { uint32_t req_id, def_id; SimPeriod period; uint32_t interval, flags; };
+
+    std::vector<Field> defs[8];
+    std::vector<Request> reqs;
+
+    bool clear_definition(uint32_t def_id) override { defs[def_id & 7].clear(); return true; }
+    bool add_to_definition(uint32_t def_id, const char* simvar, const char*, uint32_t datum_id) override {
+        defs[def_id & 7].push_back({simvar, datum_id});
+        return true;
+    }
+    bool set_data(uint32_t, const double*, size_t) override { return true; }
+    bool request_data(uint32_t req_id, uint32_t def_id, SimPeriod period, uint32_t interval, uint32_t flags) override {
+        reqs.push_back({req_id, def_id, period, interval, flags});
+        return true;
+    }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what){
+    if (!ok) { printf("FAIL: %s\n", what); failures++; }
+}
+
+// Sim state at frame k: fast fields move every frame, engine and terrain
+// values step every few frames like the sim's own.
+static void sim_values(const SensorRegistry& reg, int k, double v[]){
+    const double t = k / 60.0;
+    for (size_t i = 0; i < reg.size(); i++) {
+        if (reg[i].group == SENSOR_GROUP_FRAME) v[i] = std::sin(0.3 * t + (double)i) * (10.0 + (double)i);
+        else v[i] = 1000.0 + (double)i + std::floor(t * 2.0 + (double)i * 0.25) * 5.0;
+    }
+}
+
+static double field(const SensorRegistry& reg, const RawSensors& r, size_t i){
+    double x;
+    memcpy(&x, (const char*)&r + reg[i].offset, sizeof(x));
+    return x;
+}
+
+struct Result {
+    uint64_t bytes = 0, messages = 0;
+    double merge_ns = 0.0;
+};
+
+static Result play(const SensorRegistry& reg, int slow_frames, double seconds){
+    Result r;
+    FakeSim sim;
+    SensorRequests sr;
+    check(sr.open(sim, reg, 1, 1, slow_frames), "open");
+
+    const int frames = (int)(seconds * 60.0);
+    const bool split = sr.groups() > 1;
+    std::vector<double> held(reg.size(), 0.0), sent_slow(reg.size(), std::nan(""));
+    std::vector<char> buf(1024);
+    double v[SensorRequests::kMaxVars];
+    double merge_s = 0.0;
+
+    for (int k = 0; k < frames; k++) {
+        sim_values(reg, k, v);
+
+        // Slow group first: SimConnect sends requests in request order,
+        // and the harness wants the fresh values in this frame's sample.
+        if (split && k % slow_frames == 0) {
+            uint32_t n = 0;
+            size_t off = 0;
+            for (const FakeSim::Field& f : sim.defs[2]) {
+                if (v[f.datum] == sent_slow[f.datum]) continue;
+                sent_slow[f.datum] = v[f.datum];
+                memcpy(&buf[off], &f.datum, 4);
+                memcpy(&buf[off + 4], &v[f.datum], 8);
+                off += 12;
+                n++;
+            }
+            if (n) {
+                const auto t0 = std::chrono::steady_clock::now();
+                sr.on_data(2, true, n, buf.data(), off);
+                merge_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                r.bytes += off; r.messages++;
+                for (const FakeSim::Field& f : sim.defs[2]) held[f.datum] = v[f.datum];
+            }
+        }
+
+        size_t off = 0;
+        for (const FakeSim::Field& f : sim.defs[1]) {
+            memcpy(&buf[off], &v[f.datum], 8);
+            off += 8;
+            if (!split || reg[f.datum].group == SENSOR_GROUP_FRAME) held[f.datum] = v[f.datum];
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool sample = sr.on_data(1, false, (uint32_t)sim.defs[1].size(), buf.data(), off);
+        merge_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        r.bytes += off; r.messages++;
+
+        check(sample, "frame group completes a sample");
+        for (size_t i = 0; i < reg.size(); i++) {
+            if (field(reg, sr.current(), i) != held[i]) { check(false, reg[i].simvar); return r; }
+        }
+    }
+    check(!sr.on_data(9, false, 0, buf.data(), 0) && sr.stats().rejected == 1, "foreign request rejected");
+    r.merge_ns = merge_s * 1e9 / frames;
+    return r;
+}
+
+int main(int argc, char** argv){
+    const int slow_frames = argc > 1 ? atoi(argv[1]) : 6;
+    const double seconds = argc > 2 ? atof(argv[2]) : 120.0;
+
+    // Definitions: every table row once, datum id = row, slow rows split off.
+    {
+        FakeSim sim;
+        SensorRequests sr;
+        sr.open(sim, default_sensor_registry(), 1, 1, slow_frames);
+        size_t slow_rows = 0;
+        for (size_t i = 0; i < kSensorVarCount; i++) if (kSensorVars[i].group == SENSOR_GROUP_SLOW) slow_rows++;
+        check(sim.defs[1].size() + sim.defs[2].size() == kSensorVarCount, "every SimVar defined once");
+        check(sim.defs[2].size() == (slow_frames > 1 ? slow_rows : 0), "slow definition");
+        check(sim.reqs.size() == (slow_frames > 1 ? 2u : 1u), "request count");
+        if (sim.reqs.size() == 2) {
+            const FakeSim::Request& q = sim.reqs[1];
+            check(q.req_id == 2 && q.def_id == 2 && q.interval == (uint32_t)(slow_frames - 1), "slow request");
+            check(q.flags == (SIM_REQ_CHANGED | SIM_REQ_TAGGED), "slow request flags");
+        }
+        check(!sim.reqs.empty() && sim.reqs[0].flags == 0 && sim.reqs[0].period == SIM_PERIOD_FRAME, "frame request");
+    }
+
+    // Log schema: the columns and formats of the hand-written logger this
+    // replaced, so old CSV files still replay.
+    {
+        const SensorRegistry& reg = default_sensor_registry();
+        char buf[2048];
+        reg.csv_header(buf, sizeof(buf));
+        check(!strcmp(buf, ",lat_deg,lon_deg,alt_msl_ft,alt_agl_ft,pitch_deg,bank_deg,hdg_true_deg,ias_kt,vel_e_fps,vel_n_fps,vel_u_fps,"
+                           "p_rads,q_rads,r_rads,accel_x_fps2,accel_y_fps2,accel_z_fps2,engine_rpm,prop_rpm,prop_pitch_rad,"
+                           "radio_height_ft,ground_alt_ft"), "csv header");
+        RawSensors R{};
+        R.lat_deg = 45.5; R.p_rads = 0.125; R.engine_rpm = 2400.0; R.ground_alt_ft = 312.25;
+        reg.csv_row(R, buf, sizeof(buf));
+        check(!strcmp(buf, ",45.5000000000,0.0000000000,0.0000,0.0000,0.0000,0.0000,0.0000,0.0000,0.00000,0.00000,0.00000,"
+                           "0.125000,0.000000,0.000000,0.00000,0.00000,0.00000,2400.00,0.00,0.000000,0.0000,312.2500"), "csv row");
+        check(reg.find_column("q_rads") >= 0 && reg[(size_t)reg.find_column("q_rads")].offset == offsetof(RawSensors, q_rads), "column lookup");
+    }
+
+    // INI extras: parsing, slots, and a run with them in both groups.
+    SensorRegistry ext;
+    check(ext.add_extra("FUEL TOTAL QUANTITY, gallons"), "extra, default group");
+    check(ext.add_extra("GENERAL ENG OIL TEMPERATURE:1,celsius,slow,oil_t"), "extra, named column");
+    check(ext.add_extra("AIRSPEED TRUE,knots,frame"), "extra, frame group");
+    check(!ext.add_extra("NO UNITS"), "extra without units rejected");
+    check(!ext.add_extra("X,y,sometimes"), "bad group rejected");
+    check(!ext.add_extra("Z,feet,slow,oil_t"), "duplicate column rejected");
+    check(ext.extras() == 3 && ext.size() == kSensorVarCount + 3, "extra count");
+    check(ext.find_column("fuel_total_quantity") == (int)kSensorVarCount, "generated column name");
+    check(ext[kSensorVarCount + 2].offset == offsetof(RawSensors, extra) + 2 * sizeof(double), "extra slot");
+    for (int i = ext.extras(); i < kSensorExtraMax; i++) {
+        char spec[64];
+        snprintf(spec, sizeof(spec), "FILL %d,number", i);
+        ext.add_extra(spec);
+    }
+    check(!ext.add_extra("ONE TOO MANY,number"), "extra slots full");
+    check(play(ext, slow_frames, 5.0).messages > 0, "extras run");
+
+    const Result single = play(default_sensor_registry(), 1, seconds);
+    const Result split = play(default_sensor_registry(), slow_frames, seconds);
+    const double frames = seconds * 60.0;
+
+    printf("60 sim frames/s, %.0f s, %zu sensor SimVars, slow group every %d frames\n", seconds, kSensorVarCount, slow_frames);
+    printf("%-20s %12s %12s %12s\n", "layout", "bytes/frame", "msgs/frame", "merge ns/fr");
+    printf("%-20s %12.1f %12.2f %12.1f\n", "one definition", single.bytes / frames, single.messages / frames, single.merge_ns);
+    printf("%-20s %12.1f %12.2f %12.1f\n", "frame + slow", split.bytes / frames, split.messages / frames, split.merge_ns);
+
+    if (slow_frames > 1) check(split.bytes < single.bytes, "split layout sends less");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor snapshot contention benchmark.
+
+   One writer publishes RawSensors, several readers take snapshots; once
+   through a mutex (the old G.m_tx + G.R) and once through SeqLock. Runs a
+   realistic load (writer at sim rate, readers at 1 kHz) and a stress load
+   (everyone flat out). Reports the writer's store latency, which is what
+   the SimConnect dispatch path pays, reader latency and torn snapshots.
+   Every sample has all fields set to the same counter, so any mix of two
+   samples is detected. Exits nonzero on a torn read.
+
+   Usage: seqlock_bench [seconds_per_run] [readers] [writer_hz]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/bridge_types.h"
+#include "core/seqlock.h"
+
+using clk = std::chrono::steady_clock;
+
+static const int kFields = (int)(offsetof(RawSensors, valid) / sizeof(double));
+
+static void fill(RawSensors& R, double v){
+    double* d = &R.lat_deg;
+    for (int i = 0; i < kFields; i++) d[i] = v;
+    R.valid = true;
+}
+
+static bool consistent(const RawSensors& R){
+    const double* d = &R.lat_deg;
+    for (int i = 1; i < kFields; i++) if (d[i] != d[0]) return false;
+    return true;
+}
+
+struct MutexBox {
+    std::mutex m;
+    RawSensors R{};
+    void store(const RawSensors& v){ std::lock_guard<std::mutex> lk(m); R = v; }
+    RawSensors load(){ std::lock_guard<std::mutex> lk(m); return R; }
+};
+
+struct SeqBox {
+    SeqLock<RawSensors> R;
+    void store(const RawSensors& v){ R.store(v); }
+    RawSensors load(){ return R.load(); }
+};
+
+struct Result {
+    double w_p50_ns, w_p99_ns, w_max_ns;
+    double r_p50_ns, r_p99_ns, r_max_ns;
+    uint64_t writes, reads, torn;
+};
+
+static double pct(std::vector<double>& v, double p){
+    if (v.empty()) return 0.0;
+    size_t i = std::min(v.size() - 1, (size_t)(p * (double)v.size()));
+    std::nth_element(v.begin(), v.begin() + (ptrdiff_t)i, v.end());
+    return v[i];
+}
+
+// writer_hz / reader_hz <= 0 means flat out.
+template <class Box>
+static Result run(double seconds, int readers, int writer_hz, int reader_hz){
+    Box box;
+    std::atomic<bool> go{true};
+    std::atomic<uint64_t> reads{0}, torn{0};
+    std::vector<std::vector<double>> r_lat(readers);
+
+    std::vector<std::thread> th;
+    for (int k = 0; k < readers; k++) {
+        th.emplace_back([&, k](){
+            auto next = clk::now();
+            std::vector<double>& lat = r_lat[k];
+            while (go.load(std::memory_order_relaxed)) {
+                auto t0 = clk::now();
+                RawSensors R = box.load();
+                auto t1 = clk::now();
+                if (lat.size() < 2000000) lat.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+                if (!consistent(R)) torn++;
+                reads++;
+                if (reader_hz > 0) {
+                    next += std::chrono::microseconds(1000000 / reader_hz);
+                    std::this_thread::sleep_until(next);
+                }
+            }
+        });
+    }
+
+    std::vector<double> w_lat;
+    RawSensors R{};
+    uint64_t writes = 0;
+    auto t_end = clk::now() + std::chrono::duration<double>(seconds);
+    auto next = clk::now();
+    while (clk::now() < t_end) {
+        fill(R, (double)++writes);
+        auto t0 = clk::now();
+        box.store(R);
+        auto t1 = clk::now();
+        if (w_lat.size() < 2000000) w_lat.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        if (writer_hz > 0) {
+            next += std::chrono::microseconds(1000000 / writer_hz);
+            std::this_thread::sleep_until(next);
+        }
+    }
+    go = false;
+    for (auto& t : th) t.join();
+
+    std::vector<double> all;
+    for (auto& v : r_lat) all.insert(all.end(), v.begin(), v.end());
+
+    Result r{};
+    r.w_p50_ns = pct(w_lat, 0.50);
+    r.w_p99_ns = pct(w_lat, 0.99);
+    r.w_max_ns = w_lat.empty() ? 0.0 : *std::max_element(w_lat.begin(), w_lat.end());
+    r.r_p50_ns = pct(all, 0.50);
+    r.r_p99_ns = pct(all, 0.99);
+    r.r_max_ns = all.empty() ? 0.0 : *std::max_element(all.begin(), all.end());
+    r.writes = writes;
+    r.reads = reads.load();
+    r.torn = torn.load();
+    return r;
+}
+
+static void print(const char* load, const char* kind, const Result& r){
+    printf("%-8s %-8s %10llu %11llu %8.0f %8.0f %9.0f %8.0f %8.0f %9.0f %5llu\n", load, kind,
+    (unsigned long long)r.writes, (unsigned long long)r.reads,
+    r.w_p50_ns, r.w_p99_ns, r.w_max_ns, r.r_p50_ns, r.r_p99_ns, r.r_max_ns,
+    (unsigned long long)r.torn);
+}
+
+int main(int argc, char** argv){
+    const double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    const int readers = argc > 2 ? atoi(argv[2]) : 4;
+    const int writer_hz = argc > 3 ? atoi(argv[3]) : 60;
+
+    printf("%-8s %-8s %10s %11s %8s %8s %9s %8s %8s %9s %5s\n", "load", "kind", "writes", "reads",
+    "w p50 ns", "w p99 ns", "w max ns", "r p50 ns", "r p99 ns", "r max ns", "torn");
+
+    uint64_t torn = 0;
+    Result r;
+    r = run<MutexBox>(seconds, readers, writer_hz, 1000); print("sim", "mutex", r); torn += r.torn;
+    r = run<SeqBox>(seconds, readers, writer_hz, 1000);   print("sim", "seqlock", r); torn += r.torn;
+    r = run<MutexBox>(seconds, readers, 0, 0);            print("stress", "mutex", r); torn += r.torn;
+    r = run<SeqBox>(seconds, readers, 0, 0);              print("stress", "seqlock", r); torn += r.torn;
+
+    return torn == 0 ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/*
+   MSFS 202x–ArduPilot Bridge - servo receive benchmark.
+
+   Plays a faster-than-real-time SITL against rx_loop over loopback UDP:
+   bursts of servo_packet_16 (frames stepped back to back) with a pause
+   between bursts. Some frame_counts are skipped, some packets are sent
+   twice and some pairs are swapped. Runs once with the drain receive and
+   once with the one-packet-at-a-time receive, and reports packets per
+   wakeup, packets applied, the delay from sending the last packet of a
+   burst to it reaching the sim thread's servo buffer, and the loss,
+   duplicate and reorder counters against the ones expected from the send
+   pattern. On Linux builds with io_uring the drain receive runs a second
+   time on the io_uring backend. Exits nonzero if a counter is off, the
+   drain receive applies stale frames or its median delay is over 2 ms.
+
+   Usage: servo_rx_bench [bursts] [burst_len] [port_rx]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+#include "core/net.h"
+#include "core/servo_seq.h"
+#include "core/uring_net.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct RunResult {
+    uint64_t datagrams, wakeups, applied, superseded;
+    uint64_t dropped, duplicated, reordered;
+    double p50_us, max_us;
+    int missed;                     // bursts whose last frame never showed up
+};
+
+// frame_counts in send order for one burst starting at 'first'.
+static std::vector<uint32_t> burst_frames(uint32_t first, int len, int burst){
+    std::vector<uint32_t> f;
+    for (int i = 0; i < len; i++) {
+        uint32_t fc = first + (uint32_t)i;
+        if (i > 0 && i < len - 1 && (fc % 50) == 7) continue;           // lost
+        f.push_back(fc);
+        if (i < len - 1 && (fc % 70) == 11) f.push_back(fc);           // duplicated
+    }
+    // Swap one pair in every third burst (never the last packet).
+    if (burst % 3 == 1 && f.size() > 4) std::swap(f[1], f[2]);
+    return f;
+}
+
+static RunResult run(bool drain, int backend, int bursts, int burst_len, uint16_t port_rx, ServoSeqStats& expect){
+    Shared S;
+    S.dest.port_rx = port_rx;
+    S.servo_rx_drain = drain;
+    S.net_backend = backend;
+    S.cfg.publish(snapshot_config(S));
+
+    BridgeHooks hooks;
+    std::atomic<bool> run_flag{true};
+    std::thread t_rx(rx_loop, std::ref(S), std::cref(hooks), std::cref(run_flag));
+
+    // Stands in for the sim thread: notes when each frame_count shows up.
+    std::atomic<uint32_t> want{0};
+    std::atomic<int64_t> want_sent_ns{0};
+    std::atomic<bool> cons_run{true};
+    std::vector<double> delay_us;
+    delay_us.reserve(bursts);
+    std::thread t_cons([&]{
+        uint64_t seen = 0;
+        uint32_t last_want = 0;
+        while (cons_run) {
+            uint64_t s = S.servo_seq.load(std::memory_order_acquire);
+            if (s == seen) { std::this_thread::yield(); continue; }
+            seen = s;
+            const uint32_t fc = S.servo.read().frame_count;
+            const uint32_t w = want.load(std::memory_order_acquire);
+            if (fc == w && w != last_want) {
+                last_want = w;
+                int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+                delay_us.push_back((now_ns - want_sent_ns.load()) / 1000.0);
+            }
+        }
+    });
+
+    UdpRxRaw sitl;
+    sitl.open((uint16_t)(port_rx + 1));
+    sockaddr_in bridge{};
+    bridge.sin_family = AF_INET;
+    bridge.sin_port = htons(port_rx);
+    inet_pton(AF_INET, "127.0.0.1", &bridge.sin_addr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    servo_packet_16 pkt{};
+    pkt.frame_rate = 1200;
+    for (int i = 0; i < 16; i++) pkt.pwm[i] = 1500;
+
+    ServoSeqTracker ref;
+    uint32_t next = 1;
+    for (int b = 0; b < bursts; b++) {
+        std::vector<uint32_t> frames = burst_frames(next, burst_len, b);
+        next += (uint32_t)burst_len;
+        for (size_t i = 0; i < frames.size(); i++) {
+            pkt.frame_count = frames[i];
+            ref.track(frames[i]);
+            if (i + 1 == frames.size()) {
+                want_sent_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+                want.store(frames[i], std::memory_order_release);
+            }
+            sitl.send_to(&pkt, sizeof(pkt), &bridge);
+        }
+        // SITL waiting on something else between bursts: longer than the
+        // blocking receive's timeout, so it has gone to sleep.
+        std::this_thread::sleep_for(std::chrono::milliseconds(12));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    run_flag = false;
+    t_rx.join();
+    cons_run = false;
+    t_cons.join();
+
+    expect = ref.stats();
+    RunResult r{};
+    r.datagrams = S.rx_stats.datagrams.load();
+    r.wakeups = S.rx_stats.wakeups.load();
+    r.applied = S.rx_stats.applied.load();
+    r.superseded = S.rx_stats.superseded.load();
+    r.dropped = S.rx_stats.dropped.load();
+    r.duplicated = S.rx_stats.duplicated.load();
+    r.reordered = S.rx_stats.reordered.load();
+    r.missed = bursts - (int)delay_us.size();
+    std::sort(delay_us.begin(), delay_us.end());
+    if (!delay_us.empty()) {
+        r.p50_us = delay_us[delay_us.size() / 2];
+        r.max_us = delay_us.back();
+    }
+    return r;
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    const int bursts = argc > 1 ? atoi(argv[1]) : 200;
+    const int burst_len = argc > 2 ? atoi(argv[2]) : 24;
+    const uint16_t port_rx = (uint16_t)(argc > 3 ? atoi(argv[3]) : 19502);
+
+    printf("%d bursts of %d frames, 12 ms apart\n", bursts, burst_len);
+    printf("%-8s %9s %8s %8s %8s %10s %10s %7s %5s %5s %5s\n", "mode", "packets", "wakeups", "applied",
+           "superseded", "p50 us", "max us", "missed", "lost", "dup", "late");
+
+    bool ok = true;
+    struct Mode { const char* name; bool drain; int backend; };
+    const Mode modes[] = {
+        { "drain", true, NET_SOCKETS },
+        { "io_uring", true, NET_IO_URING },
+        { "single", false, NET_SOCKETS },
+    };
+    for (const Mode& m : modes) {
+        if (m.backend == NET_IO_URING) {
+            // Same probe rx_loop does; skip the row where it would fall back.
+            UdpRxRaw probe;
+            UringUdpRx ring;
+            if (!probe.open((uint16_t)(port_rx + 2)) || !ring.open(probe.handle())) {
+                printf("%-8s unavailable\n", m.name);
+                continue;
+            }
+        }
+        ServoSeqStats want;
+        RunResult r = run(m.drain, m.backend, bursts, burst_len, port_rx, want);
+        printf("%-8s %9llu %8llu %8llu %10llu %10.1f %10.1f %7d %5llu %5llu %5llu\n", m.name,
+               (unsigned long long)r.datagrams, (unsigned long long)r.wakeups, (unsigned long long)r.applied,
+               (unsigned long long)r.superseded, r.p50_us, r.max_us, r.missed,
+               (unsigned long long)r.dropped, (unsigned long long)r.duplicated, (unsigned long long)r.reordered);
+
+        bool counts = r.datagrams == want.received && r.dropped == want.dropped &&
+                      r.duplicated == want.duplicated && r.reordered == want.reordered;
+        if (!counts) {
+            printf("  expected %llu packets, %llu lost, %llu dup, %llu late\n",
+                   (unsigned long long)want.received, (unsigned long long)want.dropped,
+                   (unsigned long long)want.duplicated, (unsigned long long)want.reordered);
+            ok = false;
+        }
+        if (m.drain) ok = ok && r.applied < r.datagrams && r.missed == 0 && r.p50_us <= 2000.0;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/*
+   MSFS 202x–ArduPilot Bridge - shared-memory link latency benchmark.
+
+   Round trips of a servo packet out and a binary sensor packet back, over
+   UDP loopback and over the shared-memory link (futex/event wakeups):
+     - transport: an echo thread answers each servo packet directly, so
+       only the transport is measured;
+     - bridge: a lockstep SITL (lockstep_tx, binary sensor format) steps
+       the real rx_loop/sim_loop, once over UDP and once over a link file.
+   Reports steps/s and p50/p99/max round trip. Exits nonzero if a reply
+   goes missing, a sensor packet does not decode, or the bridge's replies
+   over the link are not one per step with rising timestamps.
+
+   Usage: shm_link_bench [steps] [port_base]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+#include "core/net.h"
+#include "core/sensor_packet.h"
+#include "core/sensor_source.h"
+#include "core/shm_link.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Emits the same valid sample on every dispatch.
+class SyntheticSource : public SensorSource {
+public:
+    const char* name() const override { return "Synthetic"; }
+    bool open() override { return true; }
+    void close() override {}
+    bool dispatch(SensorTx& tx) override {
+        RawSensors R{};
+        R.lat_deg = -35.363261; R.lon_deg = 149.165230;
+        R.alt_msl_ft = 2000; R.ias_kt = 80; R.hdg_true_deg = 90;
+        tx.on_sample(R);
+        return true;
+    }
+};
+
+static sockaddr_in loopback(uint16_t port){
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &a.sin_addr);
+    return a;
+}
+
+struct Result {
+    std::vector<double> rt_us;
+    int missing = 0;
+    int bad = 0;
+    double seconds = 0;
+};
+
+static bool report(const char* name, Result& r, int steps){
+    std::sort(r.rt_us.begin(), r.rt_us.end());
+    auto pct = [&](double q){ return r.rt_us.empty() ? 0.0 : r.rt_us[(size_t)(q * (r.rt_us.size() - 1))]; };
+    printf("%-18s %10.0f %9.1f %9.1f %9.1f %8d %5d\n", name, steps / r.seconds, pct(0.5), pct(0.99),
+           r.rt_us.empty() ? 0.0 : r.rt_us.back(), r.missing, r.bad);
+    return r.missing == 0 && r.bad == 0;
+}
+
+static servo_packet_16 servo_packet(){
+    servo_packet_16 pkt{};
+    pkt.frame_rate = 1000;
+    for (int i = 0; i < 16; i++) pkt.pwm[i] = 1500;
+    return pkt;
+}
+
+// ---- transport only ----
+
+static Result udp_echo(int steps, uint16_t port_base){
+    Result r;
+    UdpRxRaw a, b;
+    a.open(port_base);
+    b.open((uint16_t)(port_base + 1));
+    const sockaddr_in to_a = loopback(port_base), to_b = loopback((uint16_t)(port_base + 1));
+    std::atomic<bool> run{true};
+    std::thread echo([&]{
+        uint8_t buf[1024], reply[SENSOR_PACKET_SIZE_V1] = {};
+        sockaddr_in from{};
+        while (run) {
+            if (b.recv(buf, sizeof(buf), &from) > 0) a.send_to(reply, sizeof(reply), &to_a);
+        }
+    });
+    servo_packet_16 pkt = servo_packet();
+    uint8_t buf[1024];
+    sockaddr_in from{};
+    auto t0 = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        pkt.frame_count = (uint32_t)i;
+        auto ts = Clock::now();
+        a.send_to(&pkt, sizeof(pkt), &to_b);
+        if (a.recv(buf, sizeof(buf), &from) <= 0) { r.missing++; continue; }
+        r.rt_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - ts).count());
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    run = false;
+    b.send_to(&pkt, sizeof(pkt), &to_b);
+    echo.join();
+    return r;
+}
+
+static Result shm_echo(int steps, const std::string& path){
+    Result r;
+    ShmLink bridge_end, sitl_end;
+    if (!bridge_end.open(path, true) || !sitl_end.open(path, false)) { r.missing = steps; r.seconds = 1; return r; }
+    std::atomic<bool> run{true};
+    std::thread echo([&]{
+        uint8_t buf[SHM_SLOT_DATA_BYTES], reply[SENSOR_PACKET_SIZE_V1] = {};
+        uint32_t seen = 0;
+        while (run) {
+            if (!bridge_end.wait(SHM_SLOT_SERVOS, seen, 20000)) continue;
+            if (bridge_end.read(SHM_SLOT_SERVOS, buf, sizeof(buf), &seen) > 0) bridge_end.publish(SHM_SLOT_SENSORS, reply, sizeof(reply));
+        }
+    });
+    servo_packet_16 pkt = servo_packet();
+    uint8_t buf[SHM_SLOT_DATA_BYTES];
+    uint32_t seen = 0;
+    sitl_end.read(SHM_SLOT_SENSORS, buf, sizeof(buf), &seen);
+    auto t0 = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        pkt.frame_count = (uint32_t)i;
+        auto ts = Clock::now();
+        sitl_end.publish(SHM_SLOT_SERVOS, &pkt, sizeof(pkt));
+        if (!sitl_end.wait(SHM_SLOT_SENSORS, seen, 1000000) ||
+            sitl_end.read(SHM_SLOT_SENSORS, buf, sizeof(buf), &seen) <= 0) { r.missing++; continue; }
+        r.rt_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - ts).count());
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    run = false;
+    echo.join();
+    return r;
+}
+
+// ---- through the bridge ----
+
+static void start_bridge(Shared& S, uint16_t port_rx, const std::string& shm_path){
+    S.dest.port_rx = port_rx;
+    S.lockstep_tx = true;
+    S.sitl_format = FRAME_BINARY;
+    S.shm_path = shm_path;
+    for (int i = 0; i < 12; i++) S.rc_out[i] = -1.0;
+    S.cfg.publish(snapshot_config(S));
+}
+
+// Checks one reply: decodes, and its timestamp moves forward.
+static bool good_reply(const uint8_t* buf, int len, double* last_ts){
+    sensor_packet p;
+    if (sensor_packet_decode(buf, (size_t)len, &p) != SENSOR_PACKET_OK || !(p.timestamp > *last_ts)) return false;
+    *last_ts = p.timestamp;
+    return true;
+}
+
+static Result bridge_udp(int steps, uint16_t port_base){
+    Result r;
+    const uint16_t port_rx = (uint16_t)(port_base + 2);
+    Shared S;
+    start_bridge(S, port_rx, "");
+    BridgeHooks hooks;
+    std::atomic<bool> run{true};
+    SyntheticSource src;
+    std::thread t_rx(rx_loop, std::ref(S), std::cref(hooks), std::cref(run));
+    std::thread t_sim(sim_loop, std::ref(S), std::cref(hooks), std::ref(src), std::cref(run));
+
+    UdpRxRaw sitl;
+    sitl.open((uint16_t)(port_base + 3));
+    const sockaddr_in bridge = loopback(port_rx);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    servo_packet_16 pkt = servo_packet();
+    uint8_t buf[4096];
+    sockaddr_in from{};
+    double last_ts = -1.0;
+    for (int i = 0; i < 20; i++) {
+        pkt.frame_count = (uint32_t)i;
+        sitl.send_to(&pkt, sizeof(pkt), &bridge);
+        sitl.recv(buf, sizeof(buf), &from);
+    }
+    auto t0 = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        pkt.frame_count = (uint32_t)(20 + i);
+        auto ts = Clock::now();
+        sitl.send_to(&pkt, sizeof(pkt), &bridge);
+        const int len = sitl.recv(buf, sizeof(buf), &from);
+        if (len <= 0) { r.missing++; continue; }
+        r.rt_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - ts).count());
+        if (!good_reply(buf, len, &last_ts)) r.bad++;
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    run = false;
+    t_sim.join();
+    t_rx.join();
+    return r;
+}
+
+static Result bridge_shm(int steps, uint16_t port_base, const std::string& path){
+    Result r;
+    Shared S;
+    start_bridge(S, (uint16_t)(port_base + 4), path);
+    BridgeHooks hooks;
+    std::atomic<bool> run{true};
+    SyntheticSource src;
+    std::thread t_rx(rx_loop, std::ref(S), std::cref(hooks), std::cref(run));
+    std::thread t_sim(sim_loop, std::ref(S), std::cref(hooks), std::ref(src), std::cref(run));
+
+    // The SITL end attaches once the bridge has created the file.
+    ShmLink sitl;
+    for (int i = 0; i < 200 && !sitl.open(path, false); i++) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    servo_packet_16 pkt = servo_packet();
+    uint8_t buf[SHM_SLOT_DATA_BYTES];
+    uint32_t seen = 0;
+    double last_ts = -1.0;
+    auto step = [&](uint32_t frame, bool timed){
+        pkt.frame_count = frame;
+        auto ts = Clock::now();
+        sitl.publish(SHM_SLOT_SERVOS, &pkt, sizeof(pkt));
+        int len = 0;
+        while (len <= 0 && sitl.wait(SHM_SLOT_SENSORS, seen, 1000000)) len = sitl.read(SHM_SLOT_SENSORS, buf, sizeof(buf), &seen);
+        if (!timed) return;
+        if (len <= 0) { r.missing++; return; }
+        r.rt_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - ts).count());
+        if (!good_reply(buf, len, &last_ts)) r.bad++;
+    };
+    sitl.read(SHM_SLOT_SENSORS, buf, sizeof(buf), &seen);
+    for (int i = 0; i < 20; i++) step((uint32_t)i, false);
+    auto t0 = Clock::now();
+    for (int i = 0; i < steps; i++) step((uint32_t)(20 + i), true);
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    run = false;
+    t_sim.join();
+    t_rx.join();
+
+    // One reply per step: every servo frame taken, every answer published.
+    const uint64_t answered = S.tx_stats.lockstep_answered.load();
+    if (!sitl.active() || S.rx_stats.shm.load() != (uint64_t)steps + 20 || answered != (uint64_t)steps + 20) {
+        printf("  link %s, %llu servo frames taken, %llu answered, expected %d\n", sitl.active() ? "attached" : "MISSING",
+               (unsigned long long)S.rx_stats.shm.load(), (unsigned long long)answered, steps + 20);
+        r.bad++;
+    }
+    return r;
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    const int steps = argc > 1 ? atoi(argv[1]) : 5000;
+    const uint16_t port_base = (uint16_t)(argc > 2 ? atoi(argv[2]) : 19950);
+    const std::string path = "shm_link_bench_" + std::to_string(port_base) + ".shm";
+
+    printf("%d round trips: servo packet out, %d byte sensor packet back\n", steps, SENSOR_PACKET_SIZE_V1);
+    printf("%-18s %10s %9s %9s %9s %8s %5s\n", "path", "steps/s", "p50 us", "p99 us", "max us", "missing", "bad");
+    bool ok = true;
+    { Result r = udp_echo(steps, port_base); ok = report("transport udp", r, steps) && ok; }
+    { Result r = shm_echo(steps, path); ok = report("transport shm", r, steps) && ok; }
+    // Left in place on purpose: the bridge must not take the stale servo
+    // frame the echo run leaves in it.
+    { Result r = bridge_udp(steps, port_base); ok = report("bridge udp", r, steps) && ok; }
+    { Result r = bridge_shm(steps, port_base, path); ok = report("bridge shm", r, steps) && ok; }
+    remove(path.c_str());
+    return ok ? 0 : 1;
+}
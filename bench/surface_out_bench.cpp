@@ -0,0 +1,137 @@
+/*
+   MSFS 202x–ArduPilot Bridge - control surface data output harness.
+
+   Runs SurfaceWriter against a SimDataApi that records every call instead
+   of talking to the sim. Checks the definition built for a typical
+   mapping (ailerons, elevator, rudder, all-engine throttle, spoilers, one
+   unmapped channel and one event without a SimVar), the values written
+   for a few servo positions, and counts the IPC calls per frame against
+   the one-event-per-channel output. Exits nonzero on any mismatch.
+
+   Usage: surface_out_bench [frames]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "core/surface_out.h"
+
+class RecordingSimApi : public SimDataApi {
+public:
+    struct Field { uint32_t def_id; std::string simvar, units; };
+
+    std::vector<Field> defs;
+    std::vector<std::vector<double>> sets;
+    uint64_t clears = 0, calls = 0;
+
+    bool clear_definition(uint32_t def_id) override {
+        calls++; clears++;
+        std::vector<Field> keep;
+        for (const Field& f : defs) if (f.def_id != def_id) keep.push_back(f);
+        defs.swap(keep);
+        return true;
+    }
+    bool add_to_definition(uint32_t def_id, const char* simvar, const char* units, uint32_t) override {
+        calls++;
+        defs.push_back({def_id, simvar, units});
+        return true;
+    }
+    bool set_data(uint32_t, const double* values, size_t count) override {
+        calls++;
+        sets.emplace_back(values, values + count);
+        return true;
+    }
+    bool request_data(uint32_t, uint32_t, SimPeriod, uint32_t, uint32_t) override { calls++; return true; }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what){
+    if (!ok) { printf("FAIL: %s\n", what); failures++; }
+}
+
+static bool near(double a, double b){ return std::fabs(a - b) < 1e-9; }
+
+int main(int argc, char** argv){
+    const int frames = argc > 1 ? atoi(argv[1]) : 100000;
+
+    const char* events[16] = {
+        "AXIS_AILERONS_SET", "AXIS_ELEVATOR_SET", "THROTTLE_AXIS_SET_EX1", "AXIS_RUDDER_SET",
+        "", "SPOILERS_SET", "AXIS_FLAPS_SET", nullptr,
+    };
+
+    RecordingSimApi api;
+    SurfaceWriter w;
+    const uint32_t mask = w.build(api, 7, events);
+
+    check(mask == 0x2Fu, "channel mask");
+    check(w.fields() == 8, "field count");
+    check(api.clears == 1, "definition cleared once");
+    const char* expect[] = {
+        "AILERON POSITION", "ELEVATOR POSITION",
+        "GENERAL ENG THROTTLE LEVER POSITION:1", "GENERAL ENG THROTTLE LEVER POSITION:2",
+        "GENERAL ENG THROTTLE LEVER POSITION:3", "GENERAL ENG THROTTLE LEVER POSITION:4",
+        "RUDDER POSITION", "SPOILERS HANDLE POSITION",
+    };
+    check(api.defs.size() == 8, "definition entries");
+    for (size_t i = 0; i < api.defs.size() && i < 8; i++) {
+        if (api.defs[i].simvar != expect[i] || api.defs[i].def_id != 7) check(false, expect[i]);
+    }
+
+    // Full right aileron, centred elevator, idle throttle, half left rudder,
+    // spoilers past their range.
+    long v[16]{};
+    v[0] = -16383; v[1] = 0; v[2] = -16383; v[3] = 8192; v[5] = 20000;
+    api.sets.clear();
+    check(w.write(api, v), "write");
+    check(api.sets.size() == 1, "one set_data per frame");
+    if (api.sets.size() == 1 && api.sets[0].size() == 8) {
+        const std::vector<double>& s = api.sets[0];
+        check(near(s[0], 1.0), "aileron value");
+        check(near(s[1], 0.0), "elevator value");
+        for (int k = 2; k < 6; k++) check(near(s[k], 0.0), "throttle value");
+        check(near(s[6], -8192.0 / 16383.0), "rudder value");
+        check(near(s[7], 100.0), "spoiler clamp");
+    } else {
+        check(false, "set_data payload");
+    }
+
+    // Remapping rebuilds from scratch.
+    const char* single[16] = { "THROTTLE2_AXIS_SET_EX1" };
+    check(w.build(api, 7, single) == 0x1u && api.defs.size() == 1 && api.defs[0].simvar == "GENERAL ENG THROTTLE LEVER POSITION:2", "rebuild");
+    check(w.build(api, 7, events) == mask, "rebuild back");
+
+    // IPC calls per frame when every mapped channel is due.
+    int mapped = 0, as_data = 0;
+    for (int i = 0; i < 16; i++) {
+        if (events[i] && *events[i]) mapped++;
+        if (mask & (1u << i)) as_data++;
+    }
+    const int event_calls = mapped;
+    const int data_calls = 1 + (mapped - as_data);
+
+    api.sets.clear();
+    api.sets.reserve(1);
+    const uint64_t calls0 = api.calls;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        v[0] = (long)(f % 32767) - 16383;
+        w.write(api, v);
+        if (api.sets.size() > 64) api.sets.clear();
+    }
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    check(api.calls - calls0 == (uint64_t)frames, "calls per frame");
+
+    printf("%d mapped channels, %zu data fields\n", mapped, w.fields());
+    printf("IPC calls/frame: events %d, data %d\n", event_calls, data_calls);
+    printf("write %6.1f ns/frame (incl. recorder)\n", s * 1e9 / frames);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,212 @@
+/*
+   MSFS 202x–ArduPilot Bridge - io_uring vs sockets UDP benchmark.
+
+   Loopback, two parts:
+     - TX: rounds of one 700-byte sensor frame to each of 1, 8 and 32
+       destinations, sent with one sendto() per frame or with one
+       UringUdpTx::send_batch() per round. The receivers are never read
+       (the kernel drops what overflows), so the process CPU time is the
+       sender's.
+     - RX: a thread sends servo_packet_16 bursts; the receiver drains them
+       with wait_readable() + recv() per packet, or with UringUdpRx's
+       multishot receive. Receiver thread CPU only.
+   Reports packets/s, CPU ns per packet and system calls per packet.
+   Exits nonzero if the io_uring path loses or corrupts packets the
+   sockets path delivers; prints a note and only the sockets rows when
+   the kernel refuses io_uring.
+
+   Usage: uring_net_bench [packets] [port_base]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <cstdio>
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "core/bridge_types.h"
+#include "core/net.h"
+#include "core/uring_net.h"
+
+static double cpu_s(clockid_t id){
+    timespec ts;
+    clock_gettime(id, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+struct Row {
+    double pps, cpu_ns, calls;
+    uint64_t packets, errors;
+};
+
+static void print_row(const char* name, int dests, const Row& r){
+    printf("%-10s %6d %12.0f %12.0f %10.2f %10llu %7llu\n", name, dests, r.pps, r.cpu_ns, r.calls,
+           (unsigned long long)r.packets, (unsigned long long)r.errors);
+}
+
+static Row run_tx(bool uring, int dests, int packets, uint16_t port_base, bool* unavailable){
+    Row r{};
+    std::vector<UdpRxRaw> sinks(dests);
+    std::vector<sockaddr_in> addr(dests);
+    for (int d = 0; d < dests; d++) {
+        sinks[d].open((uint16_t)(port_base + d));
+        addr[d] = sockaddr_in{};
+        addr[d].sin_family = AF_INET;
+        addr[d].sin_port = htons((uint16_t)(port_base + d));
+        inet_pton(AF_INET, "127.0.0.1", &addr[d].sin_addr);
+    }
+
+    UdpTx tx;
+    tx.open("127.0.0.1", port_base);
+    UringUdpTx ring;
+    if (uring && !ring.open(tx.handle())) { *unavailable = true; return r; }
+
+    char frame[700];
+    for (size_t i = 0; i < sizeof(frame); i++) frame[i] = (char)('a' + i % 26);
+    std::vector<UdpMsg> batch(dests);
+    for (int d = 0; d < dests; d++) batch[d] = UdpMsg{ frame, (int)sizeof(frame), &addr[d], 0 };
+
+    const int rounds = packets / dests;
+    uint64_t ok = 0;
+    const double c0 = cpu_s(CLOCK_PROCESS_CPUTIME_ID);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < rounds; k++) {
+        if (uring) ok += (uint64_t)ring.send_batch(batch.data(), dests);
+        else for (int d = 0; d < dests; d++) ok += tx.send_buffer(frame, (int)sizeof(frame), &addr[d]) ? 1 : 0;
+    }
+    if (uring) ring.close();
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double cpu = cpu_s(CLOCK_PROCESS_CPUTIME_ID) - c0;
+
+    const uint64_t n = (uint64_t)rounds * (uint64_t)dests;
+    r.packets = uring ? ring.stats().packets : ok;
+    r.errors = uring ? ring.stats().errors + (n - ok) : n - ok;
+    r.pps = n / wall;
+    r.cpu_ns = cpu * 1e9 / (double)n;
+    r.calls = uring ? (double)ring.stats().enters / (double)n : 1.0;
+    return r;
+}
+
+static Row run_rx(bool uring, int packets, uint16_t port, bool* unavailable, bool* intact){
+    Row r{};
+    UdpRxRaw rx;
+    rx.open(port);
+    rx.set_nonblocking(true);
+    UringUdpRx ring;
+    if (uring && !ring.open(rx.handle())) { *unavailable = true; return r; }
+
+    std::atomic<bool> done{false};
+    std::thread sender([&]{
+        UdpTx tx;
+        tx.open("127.0.0.1", port);
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &a.sin_addr);
+        servo_packet_16 pkt{};
+        pkt.frame_rate = 1200;
+        for (int i = 0; i < packets; i++) {
+            pkt.frame_count = (uint32_t)i;
+            for (int c = 0; c < 16; c++) pkt.pwm[c] = (uint16_t)(1000 + (i + c) % 1000);
+            tx.send_buffer((const char*)&pkt, sizeof(pkt), &a);
+            // Bursts of 16, like a fast SITL; the pause keeps the socket
+            // buffer from overflowing.
+            if ((i & 15) == 15) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        done = true;
+    });
+
+    uint8_t buf[2048];
+    sockaddr_in from{};
+    uint64_t got = 0, waits = 0;
+    int64_t last = -1;
+    *intact = true;
+    const double c0 = cpu_s(CLOCK_THREAD_CPUTIME_ID);
+    const auto t0 = std::chrono::steady_clock::now();
+    while (!done) {
+        int w = uring ? ring.wait(20) : rx.wait_readable(20);
+        waits++;
+        if (w <= 0) continue;
+        for (;;) {
+            int len = uring ? ring.recv(buf, sizeof(buf), &from) : rx.recv(buf, sizeof(buf), &from);
+            if (len <= 0) break;
+            got++;
+            servo_packet_16 pkt;
+            if (len != (int)sizeof(pkt)) { *intact = false; continue; }
+            memcpy(&pkt, buf, sizeof(pkt));
+            if ((int64_t)pkt.frame_count <= last || pkt.pwm[5] != (uint16_t)(1000 + (pkt.frame_count + 5) % 1000) ||
+                ntohs(from.sin_port) == 0) *intact = false;
+            last = pkt.frame_count;
+        }
+    }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double cpu = cpu_s(CLOCK_THREAD_CPUTIME_ID) - c0;
+    sender.join();
+
+    r.packets = got;
+    r.errors = uring ? ring.stats().errors : 0;
+    r.pps = got / wall;
+    r.cpu_ns = got ? cpu * 1e9 / (double)got : 0.0;
+    // Sockets: one wait plus one recv per packet and the empty recv that
+    // ends each drain.
+    r.calls = got ? (uring ? (double)ring.stats().enters : (double)(waits * 2 + got)) / (double)got : 0.0;
+    return r;
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    const int packets = argc > 1 ? atoi(argv[1]) : 200000;
+    const uint16_t port_base = (uint16_t)(argc > 2 ? atoi(argv[2]) : 19600);
+
+    bool ok = true, unavailable = false;
+    printf("TX: 700-byte frames, %d packets per run\n", packets);
+    printf("%-10s %6s %12s %12s %10s %10s %7s\n", "path", "dests", "packets/s", "cpu ns/pkt", "calls/pkt", "sent", "errors");
+    const int dests[] = { 1, 8, 32 };
+    for (int d : dests) {
+        Row s = run_tx(false, d, packets, port_base, &unavailable);
+        print_row("sockets", d, s);
+        if (unavailable) continue;
+        Row u = run_tx(true, d, packets, port_base, &unavailable);
+        if (unavailable) continue;
+        print_row("io_uring", d, u);
+        ok = ok && u.errors == 0 && u.packets == s.packets;
+    }
+
+    const int rx_packets = packets / 4;
+    printf("\nRX: servo_packet_16 in bursts of 16, %d packets per run\n", rx_packets);
+    printf("%-10s %6s %12s %12s %10s %10s %7s\n", "path", "", "packets/s", "cpu ns/pkt", "calls/pkt", "received", "errors");
+    bool intact_s = true, intact_u = true;
+    Row s = run_rx(false, rx_packets, (uint16_t)(port_base + 100), &unavailable, &intact_s);
+    print_row("sockets", 1, s);
+    if (!unavailable) {
+        Row u = run_rx(true, rx_packets, (uint16_t)(port_base + 101), &unavailable, &intact_u);
+        if (!unavailable) {
+            print_row("io_uring", 1, u);
+            ok = ok && intact_u && u.errors == 0 && u.packets * 100 >= s.packets * 99;
+        }
+    }
+    ok = ok && intact_s;
+
+    if (unavailable) printf("\nio_uring unavailable here (kernel, sandbox or build): sockets only\n");
+    return ok ? 0 : 1;
+}
+
+#else
+
+int main(){
+    printf("io_uring is Linux only\n");
+    return 0;
+}
+
+#endif
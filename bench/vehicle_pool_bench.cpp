@@ -0,0 +1,314 @@
+/*
+   MSFS 202x–ArduPilot Bridge - multi-vehicle throughput benchmark.
+
+   Bridges 1, 4, 16 and 64 vehicles, each replaying the same recorded
+   flight (written to a temporary CSV at 30 Hz) at 'rate' Hz, against one
+   loopback peer standing in for all their SITL instances. The peer sends
+   each vehicle a servo packet every 5 ms and counts the sensor frames
+   that come back. Every count runs twice: on a VehiclePool (one worker
+   per core) and with two threads per vehicle (sim_loop + rx_loop).
+   Reports frames/s against the target, deadlines dropped, process CPU per
+   frame, and threads. Exits nonzero if a pooled run delivers less than
+   90% of its target while the thread-per-vehicle run of the same size
+   manages it, or if a pooled vehicle never applies a servo frame.
+
+   A last run checks isolation: 8 vehicles on 4 workers, each flying its
+   own airspeed and latitude, half sending JSON and half binary frames,
+   each to its own peer socket. Exits nonzero if a frame carries another
+   vehicle's state or a vehicle sends nothing.
+
+   Usage: vehicle_pool_bench [seconds] [rate] [port_base]
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+#include "core/net.h"
+#include "core/sensor_defs.h"
+#include "core/sensor_packet.h"
+#include "core/sensor_source.h"
+#include "core/vehicle_pool.h"
+
+// A 60 s circuit around the default origin, 30 samples per second.
+static bool write_replay(const char* path){
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    const SensorRegistry& reg = default_sensor_registry();
+    char buf[4096];
+    reg.csv_header(buf, sizeof(buf));
+    fprintf(f, "utc_ms%s\n", buf);
+    for (int i = 0; i < 1800; i++) {
+        const double t = i / 30.0, a = t * 0.1;
+        RawSensors R{};
+        R.lat_deg = -35.363261 + 0.002 * sin(a);
+        R.lon_deg = 149.165230 + 0.002 * cos(a);
+        R.alt_msl_ft = 2000 + 50 * sin(a * 3);
+        R.ias_kt = 80;
+        R.hdg_true_deg = fmod(90 + a * 57.29578, 360.0);
+        R.bank_deg = 15;
+        R.vel_n_fps = 130 * cos(a); R.vel_e_fps = -130 * sin(a);
+        R.engine_rpm = 2400;
+        reg.csv_row(R, buf, sizeof(buf));
+        fprintf(f, "%llu%s\n", (unsigned long long)(1000000 + i * 1000 / 30), buf);
+    }
+    fclose(f);
+    return true;
+}
+
+struct Row {
+    double fps, target_fps, cpu_us;
+    uint64_t dropped;
+    int threads;
+    int starved;                    // vehicles that never applied a servo frame
+};
+
+static Row run(bool pooled, int vehicles, double seconds, int rate, uint16_t port_base, const char* replay){
+    const uint16_t port_peer = port_base;
+    std::vector<std::unique_ptr<Shared>> S;
+    std::vector<std::unique_ptr<ReplaySource>> src;
+    BridgeHooks hooks;
+    for (int i = 0; i < vehicles; i++) {
+        S.emplace_back(new Shared);
+        Shared& v = *S.back();
+        v.dest.port_rx = (uint16_t)(port_base + 10 + i);
+        v.rate_hz = rate;
+        for (int c = 0; c < 12; c++) v.rc_out[c] = -1.0;
+        BridgeConfig c = snapshot_config(v);
+        for (int k = 0; k < 16; k++) c.axis_evt[k] = 1;
+        v.cfg.publish(c);
+        src.emplace_back(new ReplaySource(replay, 1.0, true));
+    }
+
+    UdpRxRaw peer;
+    peer.open(port_peer);
+    peer.set_nonblocking(true);
+
+    VehiclePool pool;
+    std::atomic<bool> run_flag{true};
+    std::vector<std::thread> threads;
+    const double c0 = (double)clock() / CLOCKS_PER_SEC;
+    if (pooled) {
+        for (int i = 0; i < vehicles; i++) pool.add(*S[i], *src[i], hooks);
+        pool.start(0);
+    } else {
+        for (int i = 0; i < vehicles; i++) {
+            threads.emplace_back(rx_loop, std::ref(*S[i]), std::cref(hooks), std::cref(run_flag));
+            threads.emplace_back(sim_loop, std::ref(*S[i]), std::cref(hooks), std::ref(*src[i]), std::cref(run_flag));
+        }
+    }
+
+    // The peer: servo packets out every 5 ms, sensor frames counted back.
+    std::vector<sockaddr_in> bridge(vehicles);
+    for (int i = 0; i < vehicles; i++) {
+        bridge[i] = sockaddr_in{};
+        bridge[i].sin_family = AF_INET;
+        bridge[i].sin_port = htons((uint16_t)(port_base + 10 + i));
+        inet_pton(AF_INET, "127.0.0.1", &bridge[i].sin_addr);
+    }
+    servo_packet_16 pkt{};
+    pkt.frame_rate = 200;
+    for (int c = 0; c < 16; c++) pkt.pwm[c] = 1500;
+
+    uint8_t buf[4096];
+    sockaddr_in from{};
+    uint64_t received = 0;
+    // Frames are counted after a warm-up that lets every vehicle connect
+    // and learn the peer.
+    const auto t_start = std::chrono::steady_clock::now();
+    const auto t_count = t_start + std::chrono::milliseconds(500);
+    const auto t_end = t_count + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    auto next_servo = t_start;
+    uint64_t dropped0 = 0;
+    bool counting = false;
+    for (;;) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= t_end) break;
+        if (!counting && now >= t_count) {
+            counting = true;
+            received = 0;
+            for (auto& v : S) dropped0 += v->tx_stats.pace_dropped.load();
+        }
+        if (now >= next_servo) {
+            pkt.frame_count++;
+            for (int i = 0; i < vehicles; i++) peer.send_to(&pkt, sizeof(pkt), &bridge[i]);
+            next_servo += std::chrono::milliseconds(5);
+        }
+        if (peer.wait_readable(1) > 0) {
+            while (peer.recv(buf, sizeof(buf), &from) > 0) received++;
+        }
+    }
+    const double cpu = (double)clock() / CLOCKS_PER_SEC - c0;
+
+    Row r{};
+    r.threads = pooled ? pool.workers() : 2 * vehicles;
+    run_flag = false;
+    if (pooled) pool.stop();
+    for (auto& t : threads) t.join();
+
+    r.fps = received / seconds;
+    r.target_fps = (double)vehicles * rate;
+    r.cpu_us = received ? cpu * 1e6 / (double)received : 0.0;
+    for (auto& v : S) {
+        r.dropped += v->tx_stats.pace_dropped.load();
+        if (v->rx_stats.applied.load() == 0) r.starved++;
+    }
+    r.dropped -= dropped0;
+    return r;
+}
+
+// Holds one vehicle's pose: airspeed and latitude tell the vehicles apart.
+class SteadySource : public SensorSource {
+public:
+    explicit SteadySource(int id) : id_(id) {}
+    const char* name() const override { return "Steady"; }
+    bool open() override { return true; }
+    void close() override {}
+    bool dispatch(SensorTx& tx) override {
+        tx.on_sample(sample(id_));
+        return true;
+    }
+    static RawSensors sample(int id){
+        RawSensors R{};
+        R.lat_deg = -35.363261 + 0.001 * id; R.lon_deg = 149.165230;
+        R.alt_msl_ft = 2000; R.ias_kt = 40 + 5 * id; R.hdg_true_deg = 90;
+        return R;
+    }
+private:
+    int id_;
+};
+
+// Airspeed (m/s) and latitude carried by one sensor frame, either format.
+static bool frame_state(const uint8_t* buf, int len, double* airspeed, double* lat){
+    sensor_packet p;
+    if (sensor_packet_decode(buf, (size_t)len, &p) == SENSOR_PACKET_OK) {
+        *airspeed = p.airspeed;
+        *lat = p.lla[0];
+        return true;
+    }
+    const std::string text((const char*)buf, (size_t)len);
+    const size_t at = text.find("\"airspeed\":");
+    if (at == std::string::npos) return false;
+    *airspeed = atof(text.c_str() + at + 11);
+    *lat = NAN;
+    return true;
+}
+
+struct Isolation {
+    uint64_t frames = 0;
+    uint64_t foreign = 0;           // frames carrying another vehicle's state
+    int silent = 0;                 // vehicles that sent nothing
+    int threads = 0;
+};
+
+static Isolation isolation(int vehicles, int workers, double seconds, uint16_t port_base){
+    std::vector<std::unique_ptr<Shared>> S;
+    std::vector<std::unique_ptr<SteadySource>> src;
+    std::vector<std::unique_ptr<UdpRxRaw>> peer;
+    std::vector<sockaddr_in> bridge(vehicles);
+    BridgeHooks hooks;
+    VehiclePool pool;
+    for (int i = 0; i < vehicles; i++) {
+        S.emplace_back(new Shared);
+        Shared& v = *S.back();
+        v.dest.port_rx = (uint16_t)(port_base + 10 + i);
+        v.rate_hz = 400;
+        v.sitl_format = (i & 1) ? FRAME_BINARY : FRAME_JSON;
+        for (int c = 0; c < 12; c++) v.rc_out[c] = -1.0;
+        v.cfg.publish(snapshot_config(v));
+        src.emplace_back(new SteadySource(i));
+        pool.add(v, *src.back(), hooks);
+
+        peer.emplace_back(new UdpRxRaw);
+        peer.back()->open((uint16_t)(port_base + 100 + i));
+        peer.back()->set_nonblocking(true);
+        bridge[i] = sockaddr_in{};
+        bridge[i].sin_family = AF_INET;
+        bridge[i].sin_port = htons(v.dest.port_rx);
+        inet_pton(AF_INET, "127.0.0.1", &bridge[i].sin_addr);
+    }
+    pool.start(workers);
+
+    servo_packet_16 pkt{};
+    pkt.frame_rate = 200;
+    for (int c = 0; c < 16; c++) pkt.pwm[c] = 1500;
+    std::vector<uint64_t> got(vehicles, 0);
+    Isolation r;
+    uint8_t buf[4096];
+    sockaddr_in from{};
+    const auto t_end = std::chrono::steady_clock::now() +
+                       std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    auto next_servo = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() < t_end) {
+        if (std::chrono::steady_clock::now() >= next_servo) {
+            pkt.frame_count++;
+            for (int i = 0; i < vehicles; i++) peer[i]->send_to(&pkt, sizeof(pkt), &bridge[i]);
+            next_servo += std::chrono::milliseconds(5);
+        }
+        for (int i = 0; i < vehicles; i++) {
+            const RawSensors want = SteadySource::sample(i);
+            int len;
+            while ((len = peer[i]->recv(buf, sizeof(buf), &from)) > 0) {
+                double airspeed, lat;
+                got[i]++;
+                r.frames++;
+                if (!frame_state(buf, len, &airspeed, &lat) || fabs(airspeed - want.ias_kt * 0.514444) > 1e-3 ||
+                    (!std::isnan(lat) && fabs(lat - want.lat_deg) > 1e-9)) r.foreign++;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    r.threads = pool.workers();
+    pool.stop();
+    for (int i = 0; i < vehicles; i++) if (got[i] == 0) r.silent++;
+    return r;
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    const double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    const int rate = argc > 2 ? atoi(argv[2]) : 400;
+    const uint16_t port_base = (uint16_t)(argc > 3 ? atoi(argv[3]) : 19800);
+
+    char replay[64];
+    snprintf(replay, sizeof(replay), "vehicle_pool_bench_%u.csv", (unsigned)port_base);
+    if (!write_replay(replay)) { fprintf(stderr, "Cannot write %s\n", replay); return 1; }
+
+    printf("%d Hz per vehicle, %.1f s per run, %u cores\n", rate, seconds, std::thread::hardware_concurrency());
+    printf("%-8s %8s %8s %12s %12s %9s %11s %8s\n", "mode", "vehicles", "threads", "frames/s", "target/s",
+           "dropped", "cpu us/frm", "no servo");
+    bool ok = true;
+    const int counts[] = { 1, 4, 16, 64 };
+    for (int n : counts) {
+        Row p = run(true, n, seconds, rate, port_base, replay);
+        Row t = run(false, n, seconds, rate, port_base, replay);
+        const Row* rows[] = { &p, &t };
+        for (int k = 0; k < 2; k++) {
+            const Row& r = *rows[k];
+            printf("%-8s %8d %8d %12.0f %12.0f %9llu %11.2f %8d\n", k ? "threads" : "pool", n, r.threads,
+                   r.fps, r.target_fps, (unsigned long long)r.dropped, r.cpu_us, r.starved);
+        }
+        const bool pool_ok = p.fps >= 0.9 * p.target_fps || t.fps < 0.9 * t.target_fps;
+        ok = ok && pool_ok && p.starved == 0;
+    }
+    remove(replay);
+
+    const Isolation iso = isolation(8, 4, seconds, port_base);
+    printf("isolation: 8 vehicles on %d workers, %llu frames, %llu with another vehicle's state, %d silent\n",
+           iso.threads, (unsigned long long)iso.frames, (unsigned long long)iso.foreign, iso.silent);
+    ok = ok && iso.threads >= 2 && iso.frames > 0 && iso.foreign == 0 && iso.silent == 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+/*
+   MSFS 202x–ArduPilot Bridge - servo -> sim event scheduler.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/axis_sched.h"
+
+#include <cstdlib>
+
+static int popcount16(uint32_t m){
+    int n = 0;
+    for (; m; m &= m - 1) n++;
+    return n;
+}
+
+uint32_t AxisScheduler::schedule(const long sim_val[16], uint32_t mapped, bool new_frame, double frame_ms, Clock::time_point now){
+    mapped &= 0xFFFFu;
+    if (!mapped) return 0;
+
+    if (frame_align_) {
+        // A sim frame opens the slot; without frames (paused sim, slow
+        // source) fall back to one slot per measured frame interval. The
+        // fallback waits a half frame longer so frame jitter does not
+        // open two slots per frame.
+        const double ms = frame_ms > 1.0 ? frame_ms : 1.0;
+        if (!new_frame && now < next_slot_) {
+            stats_.suppressed += (uint64_t)popcount16(mapped);
+            return 0;
+        }
+        next_slot_ = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms * 1.5));
+    }
+
+    uint32_t send = 0;
+    for (int i = 0; i < 16; i++) {
+        const uint32_t bit = 1u << i;
+        if (!(mapped & bit)) continue;
+
+        bool due = !(have_mask_ & bit) || std::labs(sim_val[i] - last_sent_[i]) > deadband_ ||
+                   (keepalive_.count() > 0 && now - last_tx_[i] >= keepalive_);
+        if (!due) continue;
+
+        send |= bit;
+        last_sent_[i] = sim_val[i];
+        last_tx_[i] = now;
+    }
+    have_mask_ |= send;
+
+    stats_.sent += (uint64_t)popcount16(send);
+    stats_.suppressed += (uint64_t)popcount16(mapped & ~send);
+    return send;
+}
@@ -0,0 +1,64 @@
+/*
+   MSFS 202x–ArduPilot Bridge - servo -> sim event scheduler.
+
+   The sim loop turns SITL's servo outputs into one SimConnect axis event
+   per mapped channel. Sending all of them every 1 ms loop iteration is up
+   to 16000 IPC calls per second, almost all repeating the previous value,
+   while the sim only reads its inputs once per frame. AxisScheduler
+   decides which channels actually go out:
+     - at most once per sim frame (or per measured frame interval when no
+       frame arrives), when frame alignment is on;
+     - only channels whose value moved by more than the deadband since it
+       was last sent;
+     - every channel again after the keep-alive interval, so the sim never
+       holds a value we stopped asserting.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+struct AxisSchedStats {
+    uint64_t sent = 0;              // events handed to the source
+    uint64_t suppressed = 0;        // events the unscheduled loop would have sent
+};
+
+class AxisScheduler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // deadband in sim axis units (+-16383); keepalive_ms <= 0 disables the
+    // refresh.
+    void configure(int deadband, int keepalive_ms, bool frame_align){
+        deadband_ = deadband < 0 ? 0 : deadband;
+        keepalive_ = std::chrono::milliseconds(keepalive_ms > 0 ? keepalive_ms : 0);
+        frame_align_ = frame_align;
+    }
+
+    // Send every mapped channel on the next call (new SITL session,
+    // reconnected sim).
+    void reset(){ have_mask_ = 0; }
+
+    // Channels to transmit now, as a bit mask over 'mapped'. 'new_frame'
+    // is true when a sim frame arrived since the previous call; frame_ms
+    // is the measured frame interval.
+    uint32_t schedule(const long sim_val[16], uint32_t mapped, bool new_frame, double frame_ms, Clock::time_point now);
+
+    const AxisSchedStats& stats() const { return stats_; }
+
+private:
+    int deadband_ = 0;
+    Clock::duration keepalive_ = std::chrono::milliseconds(250);
+    bool frame_align_ = true;
+
+    uint32_t have_mask_ = 0;        // channels with a valid last_sent_
+    long last_sent_[16]{};
+    Clock::time_point last_tx_[16]{};
+    Clock::time_point next_slot_{};
+    AxisSchedStats stats_;
+};
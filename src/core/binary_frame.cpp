@@ -0,0 +1,101 @@
+/*
+   MSFS 202x–ArduPilot Bridge - binary sensor frame encoder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/binary_frame.h"
+
+#include <cstring>
+
+namespace {
+
+// Version 1 as laid out on the wire; natural alignment gives exactly the
+// documented offsets, only the tail padding is not sent.
+struct WireV1 {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;
+    uint32_t seq;
+    uint32_t flags;
+    double timestamp;
+    double lla[3];
+    double position[3];
+    float quaternion[4];
+    float velocity[3];
+    float gyro[3];
+    float accel_body[3];
+    float airspeed;
+    float rng_1;
+    float rc[12];
+};
+
+static_assert(offsetof(WireV1, timestamp) == 16, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, lla) == 24, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, position) == 48, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, quaternion) == 72, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, velocity) == 88, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, gyro) == 100, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, accel_body) == 112, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, airspeed) == 124, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, rng_1) == 128, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, rc) == 132, "sensor_packet.h layout");
+static_assert(offsetof(WireV1, rc) + sizeof(float) * 12 == SENSOR_PACKET_SIZE_V1, "sensor_packet.h layout");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static void swap_bytes(uint8_t* p, size_t width, size_t count){
+    for (size_t k = 0; k < count; k++, p += width) {
+        for (size_t i = 0; i < width / 2; i++) {
+            uint8_t t = p[i];
+            p[i] = p[width - 1 - i];
+            p[width - 1 - i] = t;
+        }
+    }
+}
+
+// The wire is little-endian: turn every field around in place.
+static void to_little_endian(uint8_t* p){
+    swap_bytes(p, 4, 1);
+    swap_bytes(p + 4, 2, 2);
+    swap_bytes(p + 8, 4, 2);
+    swap_bytes(p + 16, 8, 7);
+    swap_bytes(p + 72, 4, 27);
+}
+#endif
+
+} // namespace
+
+int encode_binary_frame(void* buf, size_t cap, const SensorFrame& f, const JsonOptions& o, uint32_t seq){
+    if (cap < SENSOR_PACKET_SIZE_V1) return -1;
+
+    WireV1 w;
+    w.magic = SENSOR_PACKET_MAGIC;
+    w.version = SENSOR_PACKET_VERSION;
+    w.length = SENSOR_PACKET_SIZE_V1;
+    w.seq = seq;
+    w.flags = (o.no_lockstep ? SENSOR_PACKET_F_NO_LOCKSTEP : 0u) |
+              (o.use_time_sync ? 0u : SENSOR_PACKET_F_NO_TIME_SYNC) |
+              (o.pos_mode == 2 ? SENSOR_PACKET_F_LLA : 0u);
+    w.timestamp = f.timestamp;
+    w.lla[0] = f.latitude;
+    w.lla[1] = f.longitude;
+    w.lla[2] = f.altitude;
+    for (int i = 0; i < 3; i++) {
+        w.position[i] = f.position[i];
+        w.velocity[i] = (float)f.velocity[i];
+        w.gyro[i] = (float)f.gyro[i];
+        w.accel_body[i] = (float)f.accel_body[i];
+    }
+    for (int i = 0; i < 4; i++) w.quaternion[i] = f.quaternion[i];
+    w.airspeed = (float)f.airspeed;
+    w.rng_1 = (float)f.rng_1;
+    for (int i = 0; i < 12; i++) w.rc[i] = f.rc[i];
+
+    memcpy(buf, &w, SENSOR_PACKET_SIZE_V1);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    to_little_endian((uint8_t*)buf);
+#endif
+    return SENSOR_PACKET_SIZE_V1;
+}
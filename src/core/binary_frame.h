@@ -0,0 +1,23 @@
+/*
+   MSFS 202x–ArduPilot Bridge - binary sensor frame encoder.
+
+   Writes a SensorFrame in the sensor_packet.h layout: the fields are
+   stored into a struct with the wire offsets and copied out in one go,
+   with no formatting at all. About a quarter of the JSON frame's size.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "core/json_frame.h"
+#include "core/sensor_packet.h"
+
+// Encode 'f' with sequence number 'seq'; the JSON options become packet
+// flags. Returns the length (SENSOR_PACKET_SIZE_V1), or -1 when cap is
+// too small.
+int encode_binary_frame(void* buf, size_t cap, const SensorFrame& f, const JsonOptions& o, uint32_t seq);
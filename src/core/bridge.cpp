@@ -0,0 +1,1003 @@
+/*
+   MSFS 202x–ArduPilot Bridge - platform-neutral bridge pipeline.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/bridge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "core/binary_frame.h"
+#include "core/json_encode.h"
+#include "core/json_frame.h"
+#include "core/platform.h"
+#include "core/resample.h"
+#include "core/sensor_source.h"
+
+void bridge_status(const BridgeHooks& hooks, const char* fmt, ...){
+    if (!hooks.status_text) return;
+    char buf[1024];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    hooks.status_text(buf);
+}
+
+BridgeConfig snapshot_config(Shared& S){
+    BridgeConfig c;
+    std::lock_guard<std::mutex> lk(S.m_tx);
+    c.dest = S.dest;
+    c.rate_hz = S.rate_hz;
+    c.match_sim_rate = S.match_sim_rate;
+    c.resample_mode = S.resample_mode;
+    c.use_time_sync = S.use_time_sync;
+    c.no_lockstep = S.no_lockstep;
+    c.json_pos_mode = S.json_pos_mode;
+    c.geodesy_mode = S.geodesy_mode;
+    c.lockstep_tx = S.lockstep_tx;
+    c.tx_spin_us = S.tx_spin_us;
+    c.predict_ms = S.predict_ms;
+    c.predict_max_err_m = S.predict_max_err_m;
+    c.axis_deadband = S.axis_deadband;
+    c.axis_keepalive_ms = S.axis_keepalive_ms;
+    c.axis_frame_align = S.axis_frame_align;
+    c.axis_output = S.axis_output;
+    c.sensor_slow_frames = S.sensor_slow_frames;
+    c.sim_event_dispatch = S.sim_event_dispatch;
+    c.servo_rx_drain = S.servo_rx_drain;
+    c.net_backend = S.net_backend;
+    c.n_listeners = parse_endpoint_list(S.sensor_listeners, c.listeners, kSensorDestMax, nullptr, c.listener_format);
+    c.sitl_shadows = S.sitl_shadows;
+    c.sitl_format = S.sitl_format;
+    c.shm_path = S.shm_path;
+    for (int i = 0; i < 16; i++) c.invsim_ch[i] = S.invsim_ch[i];
+    return c;
+}
+
+bool servo_link_active(Shared& S, size_t* channels){
+    const ServoFrame& f = S.servo.read();
+    bool have_pwm = (f.seq != 0) && (std::chrono::duration<double>(std::chrono::steady_clock::now()-f.t_rx).count() < 0.3);
+    if (channels) *channels = have_pwm ? f.channels : 0;
+    return have_pwm;
+}
+
+void servo_to_sim_axes(Shared& S, const BridgeConfig& c, long sim_val[16]){
+    double norm_pwm[16];
+    const bool* inv_ch = c.invsim_ch;
+    const ServoFrame& f = S.servo.read();
+    for(int i=0; i<16; i++) norm_pwm[i] = f.norm[i];
+
+    for (int i = 0; i < 16; i++) {
+        if (inv_ch[i]) {
+            if (servo_ch_bipolar(i)) {
+                norm_pwm[i] = -norm_pwm[i];
+            } else {
+                norm_pwm[i] = 1.0 - norm_pwm[i];
+            }
+        }
+
+        if (servo_ch_bipolar(i)) {
+            sim_val[i] = (long)llround(norm_pwm[i] * 16383.0);
+        } else {
+            sim_val[i] = (long)llround((norm_pwm[i] * 2.0 - 1.0) * 16383.0);
+        }
+    }
+}
+
+static bool sane_pos(double la, double lo){
+    return std::isfinite(la) && std::isfinite(lo) &&
+    fabs(la) <= 90 && fabs(lo) <= 180 &&
+    !(fabs(la) < 1e-9 && fabs(lo) < 1e-9);
+}
+
+SensorTx::SensorTx(Shared& S, const BridgeHooks& hooks)
+: S_(S), hooks_(hooks), cfg_(S.cfg.acquire()) {
+    last_status_update_ = std::chrono::steady_clock::now();
+    last_tx_calc_ms_ = _now_ms();
+    tx_.open("", 0);
+}
+
+void SensorTx::on_sim_lost(){
+    origin_captured_ = false;
+    history_.clear();
+    predictor_.reset();
+    frame_clock_.reset();
+}
+
+void SensorTx::close(){
+    publish_pacer_stats();
+    if (ring_tx_.active()) note_ring_failures();
+    publish_dest_status();
+    ring_tx_.close();
+    tx_.close();
+}
+
+void SensorTx::begin_iteration(){
+    cfg_ = S_.cfg.acquire();
+    const BridgeConfig& c = *cfg_;
+
+    // Derived state (destination, frame program, pacer) is rebuilt only
+    // when the host publishes a new configuration.
+    if (c.version != cfg_version_) {
+        cfg_version_ = c.version;
+        const bool was_lockstep = lockstep_snap_;
+
+        d_now_ = c.dest;
+        match_sim_rate_snap_ = c.match_sim_rate;
+        cfg_rate_hz_ = c.rate_hz;
+        resample_mode_snap_ = c.resample_mode;
+        pos_mode_snap_ = c.json_pos_mode;
+        geodesy_snap_ = c.geodesy_mode;
+        lockstep_snap_ = c.lockstep_tx;
+        predict_snap_ = c.predict_ms > 0;
+        if (c.net_backend != net_backend_snap_) {
+            net_backend_snap_ = c.net_backend;
+            ring_tx_.close();
+            ring_tx_tried_ = false;
+        }
+        predictor_.configure(iclamp(c.predict_ms, 0, 500) / 1000.0, std::max(0.01, c.predict_max_err_m));
+
+        n_listeners_ = c.n_listeners;
+        memcpy(listeners_, c.listeners, sizeof(listeners_));
+        memcpy(listener_format_, c.listener_format, sizeof(listener_format_));
+        sitl_format_ = c.sitl_format;
+        if (c.shm_path != shm_path_) {
+            shm_path_ = c.shm_path;
+            shm_.close();
+            if (!shm_path_.empty()) {
+                if (shm_.open(shm_path_, true)) bridge_status(hooks_, "TX (Sensor): shared memory link at %s", shm_path_.c_str());
+                else bridge_status(hooks_, "TX (Sensor): cannot map shared memory at %s", shm_path_.c_str());
+            }
+            S_.shm_session.store(shm_.session());
+        }
+        dest_version_ = ~0ull;
+
+        opts_.pos_mode = c.json_pos_mode;
+        opts_.use_time_sync = c.use_time_sync;
+        opts_.no_lockstep = c.no_lockstep;
+        program_ = &json_program_for(opts_);
+
+        pacer_.set_spin_budget(std::chrono::microseconds(iclamp(c.tx_spin_us, 0, 5000)));
+        if (was_lockstep && !lockstep_snap_) pacer_.restart();
+
+        if (pos_mode_snap_ != last_pos_mode_) {
+            origin_captured_ = false;
+            last_pos_mode_ = pos_mode_snap_;
+        }
+    }
+
+    sim_dt_ms_snap_ = S_.sim_dt_ms.load(std::memory_order_relaxed);
+    rate_hz_snap_ = match_sim_rate_snap_ ? iclamp((int)std::round(1000.0/std::max(5.0, sim_dt_ms_snap_)), 10, 1000) : cfg_rate_hz_;
+    target_dt_ = 1.0 / (double)iclamp(rate_hz_snap_, 10, 1000);
+    pacer_.set_period(std::chrono::nanoseconds((int64_t)std::llround(target_dt_ * 1e9)));
+}
+
+void SensorTx::on_sample(RawSensors raw){
+    // Arrival stamp at full clock resolution; with an event-driven source
+    // this is within microseconds of SimConnect delivering the frame.
+    const double now_s = _now_s();
+    const uint64_t now_ms = (uint64_t)(now_s * 1000.0);
+    sample_count_++;
+
+    // Only this thread writes sim_dt_ms.
+    frame_clock_.on_frame(now_s);
+    S_.sim_dt_ms.store(frame_clock_.period() * 1000.0, std::memory_order_relaxed);
+    const FrameClockStats& fs = frame_clock_.stats();
+    S_.tx_stats.sim_jitter_us = (uint32_t)std::min(frame_clock_.jitter() * 1e6, 4e9);
+    S_.tx_stats.sim_frames_skipped = fs.skipped;
+    S_.tx_stats.sim_stalls = fs.stalls;
+
+    RawSensors& R = R_receive_buffer_;
+    R = raw;
+
+    if (std::isfinite(R.radio_height_ft) && R.radio_height_ft>=0 && R.radio_height_ft<=3000)
+    R.alt_agl_ft=R.radio_height_ft;
+    else if (std::isfinite(R.ground_alt_ft))
+    R.alt_agl_ft = std::max(R.alt_msl_ft-R.ground_alt_ft,0.0);
+
+    R.valid = sane_pos(R.lat_deg, R.lon_deg);
+
+    bool origin_moved = false;
+    double lat0, lon0, alt0, re;
+    {
+        std::lock_guard<std::mutex> lk(S_.m_tx);
+
+        if (pos_mode_snap_ == 0 && !origin_captured_ && R.valid) {
+            S_.sim_origin_lat = R.lat_deg;
+            S_.sim_origin_lon = R.lon_deg;
+            S_.sim_origin_alt_m = ft2m(R.alt_msl_ft);
+            S_.sim_origin_set = true;
+            origin_captured_ = true;
+            origin_moved = true;
+        } else if (pos_mode_snap_ != 0 && !S_.sim_origin_set && R.valid) {
+            S_.sim_origin_lat = R.lat_deg;
+            S_.sim_origin_lon = R.lon_deg;
+            S_.sim_origin_alt_m = ft2m(R.alt_msl_ft);
+            S_.sim_origin_set = true;
+            origin_moved = true;
+        }
+
+        origin_set_ = S_.sim_origin_set;
+        lat0 = S_.sim_origin_lat;
+        lon0 = S_.sim_origin_lon;
+        alt0 = S_.sim_origin_alt_m;
+        re = S_.sim_earth_radius;
+    }
+
+    double ned[3];
+    if (geodesy_snap_ == GEODESY_WGS84) {
+        // The host may also edit the origin, so compare rather than rely
+        // on origin_moved.
+        if (!geo_.has_origin(lat0, lon0, alt0)) geo_.set_origin(lat0, lon0, alt0);
+        geo_.to_ned(R.lat_deg, R.lon_deg, ft2m(R.alt_msl_ft), ned);
+    } else {
+        flat_earth_to_ned(lat0, lon0, alt0, re, R.lat_deg, R.lon_deg, ft2m(R.alt_msl_ft), ned);
+    }
+    R.N_m = ned[0];
+    R.E_m = ned[1];
+    // Up stays height above the origin in both modes: ArduPilot reads it
+    // as height above home, and the tangent plane's down would drop away
+    // from a level flight by d^2/2R (31 m at 20 km).
+    R.U_m = ft2m(R.alt_msl_ft) - alt0;
+
+    // This thread is the only writer, so the load below never retries.
+    R_prev_sample_ = S_.R.load();
+    R_prev_s_ = R_last_s_;
+    S_.R.store(R);
+    R_last_s_ = now_s;
+    blk_prev_ = blk_last_;
+    sensor_block_pack(blk_last_, R);
+
+    // A new origin moves N/E/U: restart the history rather than score
+    // the jump as a prediction error.
+    if (origin_moved) { history_.clear(); predictor_.reset(); }
+    history_.push(now_s, R);
+    predictor_.on_sample(history_);
+    const PredictorStats& ps = predictor_.stats();
+    S_.tx_stats.predict_fallbacks = ps.fallbacks;
+    S_.tx_stats.predict_err_max_mm = (uint32_t)std::min(ps.max_err_m * 1000.0, 4e9);
+
+    if (hooks_.log_sample) {
+        const int hz = (rate_hz_snap_ > 0 ? rate_hz_snap_ : 50);
+        const uint64_t period = (uint64_t)(1000 / hz);
+
+        if (now_ms >= next_log_ms_) {
+            hooks_.log_sample(R);
+            next_log_ms_ = now_ms + period;
+        }
+    }
+}
+
+void SensorTx::pump(){
+    if (tx_.needs_reopen(d_now_.ip, d_now_.port_tx)) {
+        ring_tx_.close();
+        ring_tx_tried_ = false;
+        tx_.open(d_now_.ip, d_now_.port_tx);
+    }
+    if (net_backend_snap_ == NET_IO_URING && !ring_tx_tried_) {
+        ring_tx_tried_ = true;
+        if (ring_tx_.open(tx_.handle())) bridge_status(hooks_, "TX (Sensors): io_uring backend");
+        else bridge_status(hooks_, "TX (Sensors): io_uring unavailable, using sockets");
+    }
+
+    // Catches a deadline that passed while the source was being serviced
+    // (and paces free-running sources, which never call pace()).
+    if (!lockstep_snap_) {
+        send_ticks(pacer_.poll());
+    }
+
+    auto now_status = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now_status - last_status_update_).count() >= 0.5){
+        last_status_update_ = now_status;
+        post_status();
+    }
+
+    uint64_t calc_now = _now_ms();
+    if (calc_now - last_tx_calc_ms_ > 1000) {
+        double dt_s = (calc_now - last_tx_calc_ms_) / 1000.0;
+        if (dt_s > 0) {
+            tx_rate_hz_ = (double)tx_frame_count_ / dt_s;
+        }
+        dests_.update_rates(dt_s);
+        tx_frame_count_ = 0;
+        last_tx_calc_ms_ = calc_now;
+    }
+}
+
+void SensorTx::pace(WaitEvent* wake){
+    if (lockstep_snap_) return;
+    send_ticks(wake ? pacer_.wait(*wake) : pacer_.wait());
+}
+
+// One frame per tick; dropped deadlines still advance the timestamp so it
+// keeps tracking wall time.
+void SensorTx::send_ticks(int n){
+    if (n <= 0) return;
+    t_phys_acc_ += target_dt_ * n;
+    send_frame(t_phys_acc_);
+}
+
+void SensorTx::publish_pacer_stats(){
+    PacerStats ps = pacer_.total_stats();
+    S_.tx_stats.pace_dropped = ps.dropped;
+    S_.tx_stats.pace_p50_us = ps.p50_us;
+    S_.tx_stats.pace_p99_us = ps.p99_us;
+    S_.tx_stats.pace_max_us = ps.max_us;
+}
+
+bool SensorTx::wait_servo(std::chrono::microseconds timeout){
+    auto fresh = [&]{ return S_.servo_seq.load(std::memory_order_acquire) != answered_seq_; };
+    if (fresh()) return true;
+    if (timeout.count() <= 0) return false;
+    std::unique_lock<std::mutex> lk(S_.m_rx);
+    return S_.cv_servo.wait_for(lk, timeout, fresh);
+}
+
+void SensorTx::answer_servo(){
+    const ServoFrame& sf = S_.servo.read();
+    const uint64_t seq = sf.seq;
+    const uint32_t frame = sf.frame_count;
+    const uint16_t frame_rate = sf.frame_rate;
+    const auto t_rx = sf.t_rx;
+    if (seq == answered_seq_) return;
+    answered_seq_ = seq;
+
+    // A repeated frame_count is SITL re-sending after a lost reply: answer
+    // with the same timestamp. Gaps are frames SITL stepped without us.
+    bool resend = have_answered_ && frame == answered_frame_;
+    if (!resend) {
+        if (have_answered_ && frame > answered_frame_ + 1) {
+            S_.tx_stats.lockstep_skipped += frame - answered_frame_ - 1;
+        }
+        t_phys_acc_ += (frame_rate > 0) ? 1.0 / (double)frame_rate : target_dt_;
+    }
+
+    if (!send_frame(t_phys_acc_)) return;
+
+    if (resend) S_.tx_stats.lockstep_resent++;
+    else S_.tx_stats.lockstep_answered++;
+    answered_frame_ = frame;
+    have_answered_ = true;
+
+    uint64_t rt_us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t_rx).count();
+    rt_window_sum_us_ += rt_us;
+    rt_window_n_++;
+    if (rt_us > rt_window_max_us_) rt_window_max_us_ = rt_us;
+    S_.tx_stats.turnaround_sum_us += rt_us;
+    if (rt_us > S_.tx_stats.turnaround_max_us.load()) S_.tx_stats.turnaround_max_us = rt_us;
+}
+
+bool SensorTx::send_frame(double t_sec){
+    RawSensors R = S_.R.load();
+    // >= 0 when the linear blend is left to the frame kernel.
+    double lerp_alpha = -1.0;
+
+    if (predict_snap_) {
+        // Dead-reckon the newest sample to now instead of showing SITL a
+        // blend that lags by a sim frame.
+        predictor_.predict(history_, _now_s(), R);
+    }
+    else if (!match_sim_rate_snap_ && (resample_mode_snap_ == RESAMPLE_LINEAR || resample_mode_snap_ == RESAMPLE_CUBIC)) {
+        double alpha, dt_s;
+        if (resample_blend(frame_clock_, R_prev_s_, R_last_s_, _now_s(), alpha, dt_s)) {
+            if (resample_mode_snap_ == RESAMPLE_CUBIC) hermite_sensors(R, R_prev_sample_, R_receive_buffer_, dt_s, alpha);
+            else lerp_alpha = alpha;
+        }
+    }
+
+    if (!R.valid || !origin_set_) return false;
+
+    double rc_copy[12];
+    {
+        std::lock_guard<std::mutex> lk(S_.m_gui);
+        for(int i=0; i<12; i++) rc_copy[i] = S_.rc_out[i];
+    }
+
+    refresh_dests();
+    const int n_dest = dests_.size();
+    const bool to_shm = shm_.active();
+    if (n_dest == 0 && !to_shm) return false;
+
+    SensorFrame f;
+    if (lerp_alpha >= 0.0) build_sensor_frame_lerp(f, blk_prev_, blk_last_, lerp_alpha, t_sec, rc_copy);
+    else build_sensor_frame(f, R, t_sec, rc_copy);
+
+    // Encoded once per format in use, sent to every destination.
+    const char* frame[2] = { json_buf_, packet_buf_ };
+    int len[2] = { 0, 0 };
+    if (dests_.uses(FRAME_JSON) && (len[FRAME_JSON] = program_->encode(json_buf_, sizeof(json_buf_), f)) <= 0) return false;
+    if (dests_.uses(FRAME_BINARY) || to_shm) {
+        len[FRAME_BINARY] = encode_binary_frame(packet_buf_, sizeof(packet_buf_), f, opts_, packet_seq_++);
+        if (len[FRAME_BINARY] <= 0) return false;
+    }
+    if (to_shm) {
+        shm_.publish(SHM_SLOT_SENSORS, packet_buf_, (size_t)len[FRAME_BINARY]);
+        S_.tx_stats.shm_frames++;
+    }
+
+    // Every destination in one batch: one io_uring submission, whose
+    // failures come back with later batches, or one sendmmsg() on the
+    // socket (a sendto() each off Linux).
+    UdpMsg batch[kSensorDestMax];
+    for (int i = 0; i < n_dest; i++) {
+        const int fmt = dests_.format(i);
+        batch[i] = UdpMsg{ frame[fmt], len[fmt], &dests_.addr(i), (uint32_t)i };
+        dests_.on_sent(i);
+    }
+    if (ring_tx_.active()) {
+        ring_tx_.send_batch(batch, n_dest);
+        note_ring_failures();
+    }
+    else {
+        const uint32_t failed = tx_.send_batch(batch, n_dest);
+        for (int i = 0; failed && i < n_dest; i++) {
+            if (failed & (1u << i)) dests_.on_error(i);
+        }
+    }
+    tx_frame_count_++;
+    S_.tx_stats.frames_sent++;
+    last_tx_time_ms_ = _now_ms();
+    return true;
+}
+
+void SensorTx::note_ring_failures(){
+    const uint32_t failed = ring_tx_.take_failed();
+    for (int i = 0; failed && i < dests_.size(); i++) {
+        if (failed & (1u << i)) dests_.on_error(i);
+    }
+}
+
+void SensorTx::publish_dest_status(){
+    std::lock_guard<std::mutex> lk(S_.m_gui);
+    S_.dest_status_n = dests_.status(S_.dest_status, kSensorDestMax);
+}
+
+void SensorTx::refresh_dests(){
+    if (S_.dest_version.load(std::memory_order_acquire) == dest_version_) return;
+
+    struct sockaddr_in primary, shadows[kSensorDestMax];
+    bool known;
+    int n_shadows;
+    {
+        std::lock_guard<std::mutex> lk(S_.m_addr);
+        dest_version_ = S_.dest_version.load(std::memory_order_relaxed);
+        primary = S_.sitl_addr;
+        known = S_.sitl_addr_known;
+        n_shadows = S_.sitl_shadow_n;
+        memcpy(shadows, S_.sitl_shadow, sizeof(shadows));
+    }
+    // Failures still pending belong to the old indices.
+    if (ring_tx_.active()) note_ring_failures();
+    dests_.rebuild(known ? &primary : nullptr, shadows, n_shadows, sitl_format_, listeners_, listener_format_, n_listeners_);
+}
+
+void SensorTx::post_status(){
+    refresh_dests();
+    char sitl_ip_str[INET_ADDRSTRLEN] = "?.?.?.?";
+    const bool addr_known = dests_.has_primary();
+    uint16_t sitl_port = 0;
+    if (addr_known) {
+        inet_ntop(AF_INET, &dests_.addr(0).sin_addr, sitl_ip_str, INET_ADDRSTRLEN);
+        sitl_port = ntohs(dests_.addr(0).sin_port);
+    }
+    // "+N" after the SITL address: shadows and listeners also fed.
+    char extra_dests[16] = "";
+    const int n_extra = dests_.size() - (addr_known ? 1 : 0);
+    if (n_extra > 0) snprintf(extra_dests, sizeof(extra_dests), " +%d", n_extra);
+    publish_dest_status();
+
+    double sim_dt_ms_now = S_.sim_dt_ms.load(std::memory_order_relaxed);
+    double sim_fps = (sim_dt_ms_now > 0) ? (1000.0 / sim_dt_ms_now) : 0.0;
+    if (frame_clock_.stalled(_now_s())) sim_fps = 0.0;
+
+    if (hooks_.sim_status) hooks_.sim_status(S_.sim_ok.load(), sim_fps);
+
+    bool valid_data = S_.R.load().valid;
+    const char* data_status = valid_data ? "Data: VALID" : "Data: NO";
+
+    const char* joy_status = S_.joy_ok.load() ? "Joy: OK" : "Joy: ---";
+
+    bool sitl_is_alive = addr_known && S_.servo.read().seq != 0 &&
+    (std::chrono::duration<double>(std::chrono::steady_clock::now() - S_.servo.read().t_rx).count() < 2.0);
+    const char* sitl_rx_status = sitl_is_alive ? "SITL RX: OK" : "SITL RX: ---";
+
+    bool tx_ok = (dests_.size() > 0 || shm_.active()) && (_now_ms() - last_tx_time_ms_ < 2000);
+    if (hooks_.tx_status) hooks_.tx_status(tx_ok, tx_rate_hz_);
+
+    const char* mode = sitl_format_ == FRAME_BINARY ? "BINARY" : "JSON";
+    if (lockstep_snap_) {
+        double rt_avg = rt_window_n_ ? (double)rt_window_sum_us_ / (double)rt_window_n_ : 0.0;
+        bridge_status(hooks_, "Sim fps: %.1f | %s | %s | %s (RX:%u) | TX: %s:%u%s | LOCKSTEP %.0f/%.0f us | %s MODE",
+        sim_fps,
+        data_status,
+        joy_status,
+        sitl_rx_status,
+        (unsigned)d_now_.port_rx,
+        sitl_ip_str, (unsigned)sitl_port, extra_dests,
+        rt_avg, (double)rt_window_max_us_, mode);
+        rt_window_sum_us_ = rt_window_max_us_ = rt_window_n_ = 0;
+        return;
+    }
+
+    PacerStats ps = pacer_.window_stats(true);
+    publish_pacer_stats();
+    bridge_status(hooks_, "Sim fps: %.1f | %s | %s | %s (RX:%u) | TX: %s:%u%s | %dHz JIT %u/%u us DROP %llu | %s MODE",
+    sim_fps,
+    data_status,
+    joy_status,
+    sitl_rx_status,
+    (unsigned)d_now_.port_rx,
+    sitl_ip_str, (unsigned)sitl_port, extra_dests,
+    rate_hz_snap_,
+    ps.p50_us, ps.p99_us, (unsigned long long)ps.dropped, mode);
+}
+
+SimLoop::SimLoop(Shared& S, const BridgeHooks& hooks, SensorSource& src)
+: S_(S), hooks_(hooks), src_(src), stage_(S, hooks) {
+    next_try_ = std::chrono::steady_clock::now();
+}
+
+bool SimLoop::step(){
+    stage_.begin_iteration();
+
+    if (!S_.sim_ok.load() && std::chrono::steady_clock::now() >= next_try_){
+        attempts_++;
+
+        if (src_.open()) {
+            S_.sim_ok.store(true);
+            attempts_ = 0;
+            bridge_status(hooks_, "%s connected.", src_.name());
+        }
+        else {
+            if (src_.finished()) return false;
+            next_try_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(2000);
+            if (attempts_ % 3 == 0) {
+                bridge_status(hooks_, "%s not found (attempt %d)...", src_.name(), attempts_);
+            }
+            if (hooks_.sim_status) hooks_.sim_status(false, 0.0);
+        }
+    }
+
+    if (S_.sim_ok.load() && !src_.dispatch(stage_)) {
+        bridge_status(hooks_, "%s disconnected.", src_.name());
+        src_.close();
+        S_.sim_ok.store(false);
+        stage_.on_sim_lost();
+        axis_out_.reset();
+        if (hooks_.sim_status) hooks_.sim_status(false, 0.0);
+        next_try_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        if (src_.finished()) return false;
+    }
+
+    size_t pwm_channels = 0;
+    bool have_pwm = servo_link_active(S_, &pwm_channels);
+
+    if (S_.sim_ok.load()) {
+        if (have_pwm && !intercept_enabled_) {
+            src_.set_intercept(true);
+            intercept_enabled_ = true;
+            axis_out_.reset();
+            bridge_status(hooks_, "HW axes: suppressed (SITL active)");
+        } else if (!have_pwm && intercept_enabled_) {
+            src_.set_intercept(false);
+            intercept_enabled_ = false;
+            bridge_status(hooks_, "HW axes: restored (SITL inactive)");
+        }
+    }
+
+    const uint64_t samples = stage_.sample_count();
+    const bool new_frame = samples != axis_frame_seen_;
+    axis_frame_seen_ = samples;
+
+    if (S_.sim_ok.load() && have_pwm && pwm_channels >= 16) {
+        const BridgeConfig& c = stage_.config();
+        uint32_t mapped = 0;
+        for (int i = 0; i < 16; i++) if (c.axis_evt[i] != 0) mapped |= 1u << i;
+
+        long sim_val[16];
+        servo_to_sim_axes(S_, c, sim_val);
+        axis_out_.configure(c.axis_deadband, c.axis_keepalive_ms, c.axis_frame_align);
+        uint32_t mask = axis_out_.schedule(sim_val, mapped, new_frame,
+                                           S_.sim_dt_ms.load(std::memory_order_relaxed), std::chrono::steady_clock::now());
+        if (mask) src_.send_axes(sim_val, mask, c);
+
+        S_.axis_stats.events_sent.store(axis_out_.stats().sent, std::memory_order_relaxed);
+        S_.axis_stats.events_suppressed.store(axis_out_.stats().suppressed, std::memory_order_relaxed);
+    }
+
+    stage_.pump();
+    return true;
+}
+
+void SimLoop::wait(){
+    if (stage_.lockstep()) {
+        // Sleep on the servo channel so a SITL step is answered as soon
+        // as it lands instead of at the next pacing tick.
+        auto timeout = src_.free_running() ? std::chrono::microseconds(0) : std::chrono::microseconds(1000);
+        if (stage_.wait_servo(timeout)) stage_.answer_servo();
+    }
+    else if (!src_.free_running()) {
+        // An event-driven source cuts the sleep short when a sim frame
+        // arrives, so it is dispatched right away.
+        stage_.pace(src_.data_event());
+    }
+}
+
+void SimLoop::serve(){
+    if (stage_.lockstep() && stage_.wait_servo(std::chrono::microseconds(0))) stage_.answer_servo();
+}
+
+std::chrono::steady_clock::time_point SimLoop::next_deadline() const {
+    if (stage_.lockstep()) return std::chrono::steady_clock::time_point::max();
+    return stage_.next_deadline();
+}
+
+bool SimLoop::free_running() const { return src_.free_running(); }
+
+void SimLoop::close(){
+    stage_.close();
+
+    if(S_.sim_ok.load()) {
+        src_.close();
+    }
+    S_.sim_ok.store(false);
+    if (hooks_.sim_status) hooks_.sim_status(false, 0.0);
+    if (hooks_.tx_status) hooks_.tx_status(false, 0.0);
+}
+
+void sim_loop(Shared& S, const BridgeHooks& hooks, SensorSource& src, const std::atomic<bool>& run){
+    SimLoop loop(S, hooks, src);
+    while (run && loop.step()) loop.wait();
+    loop.close();
+}
+
+static double normalize_pwm(uint16_t pwm, bool is_throttle_or_aux){
+    if (is_throttle_or_aux) {
+        return clampd(((double)pwm - 1000.0) / 1000.0, 0.0, 1.0);
+    } else {
+        return clampd(((double)pwm - 1500.0) / 500.0, -1.0, 1.0);
+    }
+}
+
+// Servo packet header: magic, frame_rate, frame_count, then the PWM
+// values. Returns the channel count, or 0 for anything else.
+static size_t servo_channels(const uint8_t* p, int len){
+    uint16_t magic;
+    memcpy(&magic, p, sizeof(magic));
+    if (len >= (int)sizeof(servo_packet_16) && magic == 18458) return 16;
+    if (len >= (int)sizeof(servo_packet_32) && magic == 29569) return 32;
+    return 0;
+}
+
+static uint32_t servo_frame_count(const uint8_t* p){
+    uint32_t frame_count;
+    memcpy(&frame_count, p + offsetof(servo_packet_16, frame_count), sizeof(frame_count));
+    return frame_count;
+}
+
+ServoRx::ServoRx(Shared& S, const BridgeHooks& hooks)
+: S_(S), hooks_(hooks), buf_(8192) {
+    last_rx_time_ms_ = _now_ms();
+    last_rx_status_post_ = std::chrono::steady_clock::now();
+}
+
+void ServoRx::publish(const uint8_t* p, size_t n, const struct sockaddr_in* from){
+    // The SITL address only changes when SITL restarts (or a shadow
+    // takes over); skip the lock on every other packet. Frames from the
+    // shared-memory link have none.
+    if (from && (!addr_published_ || !same_endpoint(*from, published_addr_))) {
+        const struct sockaddr_in& addr = *from;
+        for (int i = 0; i < n_shadows_; i++) {
+            if (same_endpoint(shadows_[i].addr, addr)) { shadows_[i] = shadows_[--n_shadows_]; break; }
+        }
+        std::lock_guard<std::mutex> lk(S_.m_addr);
+        S_.sitl_addr = addr;
+        S_.sitl_addr_known = true;
+        for (int i = 0; i < n_shadows_; i++) S_.sitl_shadow[i] = shadows_[i].addr;
+        S_.sitl_shadow_n = n_shadows_;
+        S_.dest_version.fetch_add(1, std::memory_order_release);
+        published_addr_ = addr;
+        addr_published_ = true;
+    }
+    uint16_t frame_rate;
+    memcpy(&frame_rate, p + offsetof(servo_packet_16, frame_rate), sizeof(frame_rate));
+
+    ServoFrame& f = S_.servo.write_slot();
+    f.seq = ++servo_seq_;
+    f.frame_count = servo_frame_count(p);
+    f.frame_rate = frame_rate;
+    f.channels = (uint16_t)n;
+    memcpy(f.pwm, p + offsetof(servo_packet_16, pwm), n * sizeof(uint16_t));
+    for (size_t i = 0; i < n; i++) f.norm[i] = normalize_pwm(f.pwm[i], !servo_ch_bipolar((int)i));
+    f.t_rx = std::chrono::steady_clock::now();
+    S_.servo.publish();
+    S_.servo_seq.store(servo_seq_, std::memory_order_release);
+    applied_++;
+
+    // Taking m_rx orders the store above against a waiter that has
+    // checked servo_seq but not yet gone to sleep.
+    { std::lock_guard<std::mutex> lk(S_.m_rx); }
+    S_.cv_servo.notify_one();
+
+    {
+        std::lock_guard<std::mutex> lk_gui(S_.m_gui);
+        for(int i=0; i<16; i++) {
+            S_.sitl_out_pwm[i] = f.norm[i];
+            S_.sitl_has_ch[i] = true;
+        }
+    }
+}
+
+ServoSeqVerdict ServoRx::track(const uint8_t* p){
+    const uint32_t frame_count = servo_frame_count(p);
+    ServoSeqVerdict v = seq_.track(frame_count);
+    if (v == SEQ_RESTART) bridge_status(hooks_, "RX (Servo): SITL frame_count restarted at %u", (unsigned)frame_count);
+    return v;
+}
+
+void ServoRx::publish_shadows(){
+    std::lock_guard<std::mutex> lk(S_.m_addr);
+    for (int i = 0; i < n_shadows_; i++) S_.sitl_shadow[i] = shadows_[i].addr;
+    S_.sitl_shadow_n = n_shadows_;
+    S_.dest_version.fetch_add(1, std::memory_order_release);
+}
+
+// True for a packet from a shadow: with sitl_shadows, any source other
+// than the primary while the primary is still sending. Shadows are fed
+// sensor frames but never drive the servo path.
+bool ServoRx::from_shadow(const struct sockaddr_in& a, uint64_t now_ms){
+    if (!shadows_on_ || !addr_published_ || same_endpoint(a, published_addr_) || now_ms - primary_seen_ms_ > 1000) {
+        primary_seen_ms_ = now_ms;
+        return false;
+    }
+    shadow_pkts_++;
+    for (int i = 0; i < n_shadows_; i++) {
+        if (same_endpoint(shadows_[i].addr, a)) { shadows_[i].seen_ms = now_ms; return true; }
+    }
+    // One entry is kept for the primary.
+    if (n_shadows_ < kSensorDestMax - 1) {
+        shadows_[n_shadows_++] = ShadowSrc{ a, now_ms };
+        publish_shadows();
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &a.sin_addr, ip, sizeof(ip));
+        bridge_status(hooks_, "RX (Servo): shadow SITL at %s:%u", ip, (unsigned)ntohs(a.sin_port));
+    }
+    return true;
+}
+
+// Forget shadows silent for 3 s (all of them when the option is off).
+void ServoRx::expire_shadows(){
+    if (n_shadows_ == 0) return;
+    const uint64_t now_ms = _now_ms();
+    if (shadows_on_ && now_ms < shadow_check_ms_) return;
+    shadow_check_ms_ = now_ms + 500;
+    int kept = 0;
+    for (int i = 0; i < n_shadows_; i++) {
+        if (shadows_on_ && now_ms - shadows_[i].seen_ms <= 3000) shadows_[kept++] = shadows_[i];
+    }
+    if (kept == n_shadows_) return;
+    n_shadows_ = kept;
+    publish_shadows();
+}
+
+void ServoRx::post_stats(){
+    const ServoSeqStats& st = seq_.stats();
+    S_.rx_stats.datagrams.store(st.received, std::memory_order_relaxed);
+    S_.rx_stats.wakeups.store(wakeups_, std::memory_order_relaxed);
+    S_.rx_stats.applied.store(applied_, std::memory_order_relaxed);
+    S_.rx_stats.superseded.store(superseded_, std::memory_order_relaxed);
+    S_.rx_stats.dropped.store(st.dropped, std::memory_order_relaxed);
+    S_.rx_stats.duplicated.store(st.duplicated, std::memory_order_relaxed);
+    S_.rx_stats.reordered.store(st.reordered, std::memory_order_relaxed);
+    S_.rx_stats.restarts.store(st.restarts, std::memory_order_relaxed);
+    S_.rx_stats.shadow.store(shadow_pkts_, std::memory_order_relaxed);
+    S_.rx_stats.shm.store(shm_frames_, std::memory_order_relaxed);
+}
+
+void ServoRx::on_received(int n, std::chrono::steady_clock::time_point now_tp){
+    rx_frame_count_ += n;
+    uint64_t now_ms = _now_ms();
+    uint64_t dt = now_ms - last_rx_time_ms_;
+    if (dt > 1000) {
+        rx_rate_hz_ = (double)rx_frame_count_ / (dt / 1000.0);
+        rx_frame_count_ = 0;
+        last_rx_time_ms_ = now_ms;
+    }
+    if (std::chrono::duration<double>(now_tp - last_rx_status_post_).count() > 0.5) {
+         post_stats();
+         if (hooks_.rx_status) hooks_.rx_status(true, rx_rate_hz_);
+         rx_ok_posted_ = true;
+         last_rx_status_post_ = now_tp;
+    }
+}
+
+void ServoRx::on_idle(std::chrono::steady_clock::time_point now_tp){
+    if (std::chrono::duration<double>(now_tp - last_rx_status_post_).count() > 1.0) {
+        if (rx_ok_posted_ && hooks_.rx_status) {
+            hooks_.rx_status(false, 0.0);
+        }
+        rx_ok_posted_ = false;
+        last_rx_status_post_ = now_tp;
+    }
+}
+
+int ServoRx::poll(int timeout_ms){
+    uint16_t port_now;
+    bool drain_now, ring_now;
+    {
+        auto cfg = S_.cfg.acquire();
+        port_now = cfg->dest.port_rx;
+        drain_now = cfg->servo_rx_drain;
+        ring_now = drain_now && cfg->net_backend == NET_IO_URING;
+        shadows_on_ = cfg->sitl_shadows;
+        if (cfg->shm_path != shm_path_) {
+            shm_path_ = cfg->shm_path;
+            shm_.close();
+            shm_retry_ms_ = 0;
+        }
+    }
+    expire_shadows();
+
+    const uint64_t session = S_.shm_session.load();
+    if (shm_.active() && shm_.session() != session) shm_.close();
+    if (!shm_path_.empty() && session != 0 && !shm_.active() && _now_ms() >= shm_retry_ms_) {
+        shm_retry_ms_ = _now_ms() + 200;
+        if (shm_.open(shm_path_, false) && shm_.session() == session) {
+            shm_seen_ = 0;
+            bridge_status(hooks_, "RX (Servo): shared memory link at %s", shm_path_.c_str());
+        }
+        else shm_.close();
+    }
+
+    if(rx_.needs_reopen(port_now)){
+        ring_rx_.close();
+        ring_tried_ = false;
+        rx_.open(port_now);
+        seq_.reset();
+        drain_ = false;
+        bridge_status(hooks_, "RX (Servo) settings updated: listening on port %u", (unsigned)port_now);
+    }
+    if (drain_now != drain_) {
+        rx_.set_nonblocking(drain_now);
+        drain_ = drain_now;
+    }
+    if (!ring_now) {
+        ring_rx_.close();
+        ring_tried_ = false;
+    }
+    else if (!ring_tried_) {
+        ring_tried_ = true;
+        if (ring_rx_.open(rx_.handle())) bridge_status(hooks_, "RX (Servo): io_uring backend");
+        else bridge_status(hooks_, "RX (Servo): io_uring unavailable, using sockets");
+    }
+
+    if (shm_.active()) {
+        const int got = poll_shm(timeout_ms);
+        if (got > 0) return got;
+        timeout_ms = 0;
+    }
+    return drain_ ? poll_drain(timeout_ms) : poll_single(timeout_ms);
+}
+
+// Newest servo frame from the shared-memory link; waits up to 2 ms for
+// one so the UDP socket is still looked at regularly.
+int ServoRx::poll_shm(int timeout_ms){
+    uint8_t p[SHM_SLOT_DATA_BYTES];
+    int len = shm_.read(SHM_SLOT_SERVOS, p, sizeof(p), &shm_seen_);
+    if (len <= 0 && timeout_ms > 0 && shm_.wait(SHM_SLOT_SERVOS, shm_seen_, std::min(timeout_ms, 2) * 1000)) {
+        len = shm_.read(SHM_SLOT_SERVOS, p, sizeof(p), &shm_seen_);
+    }
+    if (len <= 0) return 0;
+    wakeups_++;
+    shm_frames_++;
+    on_received(1, std::chrono::steady_clock::now());
+
+    const size_t n = servo_channels(p, len);
+    if (n == 0) return 1;
+    track(p);
+    publish(p, n, nullptr);
+    return 1;
+}
+
+int ServoRx::poll_single(int timeout_ms){
+    struct sockaddr_in from_addr = {};
+    // The blocking socket waits up to its receive timeout; check first
+    // when the caller cannot wait.
+    int len = (timeout_ms > 0 || rx_.wait_readable(0) > 0) ? rx_.recv(buf_.data(), (int)buf_.size(), &from_addr) : 0;
+
+    auto now_tp = std::chrono::steady_clock::now();
+    if (len <= 0) {
+        on_idle(now_tp);
+        if (timeout_ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(std::min(timeout_ms, 5)));
+        return 0;
+    }
+
+    const size_t n = servo_channels(buf_.data(), len);
+    if (n > 0 && from_shadow(from_addr, _now_ms())) return 1;
+
+    wakeups_++;
+    on_received(1, now_tp);
+
+    if (n == 0) return 1;
+    track(buf_.data());
+    publish(buf_.data(), n, &from_addr);
+    return 1;
+}
+
+int ServoRx::poll_drain(int timeout_ms){
+    // Sleep until SITL sends something (or the timeout lets the caller
+    // notice setting changes and shutdown), then take everything queued.
+    const bool ring = ring_rx_.active();
+    if ((ring ? ring_rx_.wait(timeout_ms) : rx_.wait_readable(timeout_ms)) <= 0) {
+        on_idle(std::chrono::steady_clock::now());
+        return 0;
+    }
+    wakeups_++;
+
+    // Newest packet of the batch.
+    uint8_t best[sizeof(servo_packet_32)];
+    size_t best_n = 0;
+    struct sockaddr_in best_addr = {};
+    struct sockaddr_in from_addr = {};
+
+    int got = 0, fresh = 0, shadow = 0;
+    bool resend = false;
+    const uint64_t batch_ms = _now_ms();
+    for (;;) {
+        int len = ring ? ring_rx_.recv(buf_.data(), (int)buf_.size(), &from_addr)
+                       : rx_.recv(buf_.data(), (int)buf_.size(), &from_addr);
+        if (len <= 0) break;
+
+        const size_t n = servo_channels(buf_.data(), len);
+        if (n > 0 && from_shadow(from_addr, batch_ms)) { shadow++; continue; }
+        got++;
+        if (n == 0) continue;
+
+        // Keep a packet when it is the newest frame so far, or when it
+        // repeats the newest frame and nothing newer came with it: a
+        // lockstep SITL re-sending after a lost reply must be answered.
+        ServoSeqVerdict v = track(buf_.data());
+        bool keep = v == SEQ_NEW || v == SEQ_RESTART;
+        if (keep) fresh++;
+        else if (v == SEQ_DUPLICATE && fresh == 0) {
+            keep = resend = servo_frame_count(buf_.data()) == seq_.newest();
+        }
+        if (!keep) continue;
+        memcpy(best, buf_.data(), n * sizeof(uint16_t) + offsetof(servo_packet_16, pwm));
+        best_n = n;
+        best_addr = from_addr;
+    }
+    if (got == 0) return shadow;
+
+    if (fresh > 1) superseded_ += (uint64_t)(fresh - 1);
+    if (best_n > 0 && (fresh > 0 || resend)) publish(best, best_n, &best_addr);
+    on_received(got, std::chrono::steady_clock::now());
+    return got + shadow;
+}
+
+void ServoRx::close(){
+    if (closed_) return;
+    closed_ = true;
+    post_stats();
+    ring_rx_.close();
+    rx_.close();
+    shm_.close();
+    if (hooks_.rx_status) hooks_.rx_status(false, 0.0);
+}
+
+void rx_loop(Shared& S, const BridgeHooks& hooks, const std::atomic<bool>& run){
+    ServoRx rx(S, hooks);
+    while (run) rx.poll(20);
+    rx.close();
+}
@@ -0,0 +1,525 @@
+/*
+   MSFS 202x–ArduPilot Bridge - platform-neutral bridge pipeline.
+
+   The sensor -> JSON -> UDP stage and the UDP servo receiver live here so
+   that the Win32 GUI and the headless runner drive exactly the same code.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/axis_sched.h"
+#include "core/bridge_types.h"
+#include "core/frame_clock.h"
+#include "core/frame_kernel.h"
+#include "core/geodesy.h"
+#include "core/json_frame.h"
+#include "core/net.h"
+#include "core/pacer.h"
+#include "core/predict.h"
+#include "core/rcu.h"
+#include "core/sensor_dest.h"
+#include "core/sensor_packet.h"
+#include "core/seqlock.h"
+#include "core/servo_seq.h"
+#include "core/shm_link.h"
+#include "core/surface_out.h"
+#include "core/triple_buffer.h"
+#include "core/uring_net.h"
+
+class JsonProgram;
+class SensorSource;
+class WaitEvent;
+
+// Status sinks provided by the host application; any of them may be null.
+struct BridgeHooks {
+    void (*status_text)(const char* text) = nullptr;
+    void (*sim_status)(bool ok, double rate_hz) = nullptr;
+    void (*tx_status)(bool ok, double rate_hz) = nullptr;
+    void (*rx_status)(bool ok, double rate_hz) = nullptr;
+    void (*log_sample)(const RawSensors& R) = nullptr;
+};
+
+// printf-style helper that formats a status line and hands it to the host.
+void bridge_status(const BridgeHooks& hooks, const char* fmt, ...);
+
+// Counters published by the TX stage for status displays and benchmarks.
+struct TxStats {
+    std::atomic<uint64_t> frames_sent{0};
+    std::atomic<uint64_t> lockstep_answered{0};
+    std::atomic<uint64_t> lockstep_resent{0};
+    std::atomic<uint64_t> lockstep_skipped{0};
+    std::atomic<uint64_t> turnaround_sum_us{0};
+    std::atomic<uint64_t> turnaround_max_us{0};
+    // Free-running pacer, whole run: inter-frame error and dropped deadlines.
+    std::atomic<uint64_t> pace_dropped{0};
+    std::atomic<uint32_t> pace_p50_us{0}, pace_p99_us{0}, pace_max_us{0};
+    // Predictor: times it fell back to hold, worst one-frame-ahead error.
+    std::atomic<uint64_t> predict_fallbacks{0};
+    std::atomic<uint32_t> predict_err_max_mm{0};
+    // Sim frame clock: arrival jitter, frames the sim skipped, stalls.
+    std::atomic<uint32_t> sim_jitter_us{0};
+    std::atomic<uint64_t> sim_frames_skipped{0};
+    std::atomic<uint64_t> sim_stalls{0};
+    // Frames published to the shared-memory link.
+    std::atomic<uint64_t> shm_frames{0};
+};
+
+// Servo -> sim event counters, published by the sim loop's AxisScheduler.
+struct AxisStats {
+    std::atomic<uint64_t> events_sent{0};
+    std::atomic<uint64_t> events_suppressed{0};
+};
+
+// Servo receive counters, published by rx_loop. 'superseded' are frames
+// received but not applied because a newer one was queued behind them.
+struct RxStats {
+    std::atomic<uint64_t> datagrams{0};
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<uint64_t> applied{0};
+    std::atomic<uint64_t> superseded{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> duplicated{0};
+    std::atomic<uint64_t> reordered{0};
+    std::atomic<uint64_t> restarts{0};
+    // Packets from shadow SITL instances (not applied).
+    std::atomic<uint64_t> shadow{0};
+    // Servo frames taken from the shared-memory link.
+    std::atomic<uint64_t> shm{0};
+};
+
+// Immutable settings snapshot read by the sim and RX threads. Built from
+// the editable fields in Shared by snapshot_config() and published through
+// Shared::cfg whenever the host changes a setting.
+struct BridgeConfig {
+    uint64_t version = 0;
+    Dest dest{};
+    int rate_hz = 1000;
+    bool match_sim_rate = false;
+    int resample_mode = 0;
+    bool use_time_sync = true;
+    bool no_lockstep = false;
+    int json_pos_mode = 0;
+    int geodesy_mode = GEODESY_WGS84;
+    bool lockstep_tx = false;
+    int tx_spin_us = 200;
+    int predict_ms = 0;
+    double predict_max_err_m = 2.0;
+    int axis_deadband = 0;
+    int axis_keepalive_ms = 250;
+    bool axis_frame_align = true;
+    int axis_output = AXIS_OUT_EVENTS;
+    int sensor_slow_frames = 6;
+    bool sim_event_dispatch = true;
+    bool servo_rx_drain = true;
+    int net_backend = NET_SOCKETS;
+    struct sockaddr_in listeners[kSensorDestMax]{};
+    int listener_format[kSensorDestMax]{};
+    int n_listeners = 0;
+    bool sitl_shadows = false;
+    int sitl_format = FRAME_JSON;
+    std::string shm_path;
+    bool invsim_ch[16]{};
+    // Host-specific sim event per servo channel; 0 = channel not sent.
+    int axis_evt[16]{};
+};
+
+// Shared state between the sim, networking and host (GUI/CLI) threads.
+struct Shared {
+    // Editable settings, owned by the host thread (GUI/CLI) and guarded by
+    // m_tx. Hot threads never read these; they use the published 'cfg'.
+    bool invsim_ch[16]{};
+
+    std::mutex m_tx;
+    Dest dest{};
+    int rate_hz=1000;
+    bool match_sim_rate=false;
+    int resample_mode=0;
+    bool use_time_sync=true;
+    bool no_lockstep=false;
+    int json_pos_mode=0;
+    // How N/E are derived from lat/lon (GeodesyMode); U is always the
+    // height above the origin. sim_earth_radius only applies to
+    // GEODESY_FLAT.
+    int geodesy_mode=GEODESY_WGS84;
+    // Answer every SITL servo packet with exactly one sensor frame instead
+    // of free-running at rate_hz.
+    bool lockstep_tx=false;
+    // Busy-wait this long before each TX deadline instead of sleeping.
+    int tx_spin_us=200;
+    // Extrapolate the newest sim sample up to this far to the TX instant
+    // (0 = off, use the resampler); hold instead while the one-frame-ahead
+    // error exceeds predict_max_err_m.
+    int predict_ms=0;
+    double predict_max_err_m=2.0;
+    // Servo -> sim events: resend a channel only when it moves by more than
+    // axis_deadband (sim units) or every axis_keepalive_ms, and at most
+    // once per sim frame with axis_frame_align.
+    int axis_deadband=0;
+    int axis_keepalive_ms=250;
+    bool axis_frame_align=true;
+    // AxisOutputMode: per-channel client events, or one data definition
+    // written once per frame for the channels that have a SimVar.
+    int axis_output=AXIS_OUT_EVENTS;
+    // Engine/terrain SimVars are requested every this many sim frames, and
+    // only on change; <= 1 requests every sensor SimVar every frame. Takes
+    // effect on the next SimConnect connect.
+    int sensor_slow_frames=6;
+    // Wake the sim loop from SimConnect's event handle when data arrives
+    // instead of polling GetNextDispatch every iteration. Takes effect on
+    // the next SimConnect connect.
+    bool sim_event_dispatch=true;
+    // Servo receive: wait for the socket to become readable, drain every
+    // queued packet and apply only the newest frame_count, instead of
+    // handling each packet as it is read.
+    bool servo_rx_drain=true;
+    // NetBackend for the UDP sockets: plain socket calls, or io_uring on
+    // Linux builds that have it (sockets are used when it is unavailable).
+    // The servo side only uses io_uring with servo_rx_drain.
+    int net_backend=NET_SOCKETS;
+    // Passive listeners ("ip:port,ip:port") that get a copy of every sensor
+    // frame, on top of the SITL instance; "ip:port/binary" sends them the
+    // binary packet instead of JSON.
+    std::string sensor_listeners;
+    // A second SITL sending servo packets becomes a shadow (fed the same
+    // sensor frames, its servo outputs ignored) instead of taking over;
+    // it only takes over once the primary has been silent for a second.
+    bool sitl_shadows=false;
+    // SensorFrameFormat sent to the SITL instances: ArduPilot's JSON, or
+    // the binary packet of sensor_packet.h for SITL builds that read it.
+    int sitl_format=FRAME_JSON;
+    // Shared-memory link file (shm_layout.h) for a SITL on this host; empty
+    // = off. Sensor frames go to it as binary packets on top of any UDP
+    // destination, and servo frames are taken from it. While it is mapped
+    // the UDP servo socket is checked between waits of at most 2 ms.
+    std::string shm_path;
+
+    RcuCell<BridgeConfig> cfg;
+
+    // Sim frame interval estimated by the sim thread's FrameClock.
+    std::atomic<double> sim_dt_ms{33.3};
+
+    // Session of the shared-memory link the sensor thread created (0 =
+    // none yet). The servo thread only attaches to that session, never to
+    // a file left over from an earlier run.
+    std::atomic<uint64_t> shm_session{0};
+
+    // Local origin; captured by the sim thread in MP SITL mode, so it is
+    // state rather than configuration and stays under m_tx.
+    bool sim_origin_set = true;
+
+    double sim_origin_lat = -35.363261;
+    double sim_origin_lon = 149.165230;
+    double sim_origin_alt_m = 584.0;
+    double sim_earth_radius = 6378137.0;
+
+    // Latest sensor sample. Written only by the sim thread; readers (TX,
+    // GUI, status) take lock-free snapshots and never block the dispatch.
+    SeqLock<RawSensors> R;
+
+    // Servo packets, rx_loop -> sim thread (the only consumer). servo_seq
+    // mirrors the newest ServoFrame::seq; cv_servo (with m_rx) is signalled
+    // after each publish for the lockstep waiter.
+    TripleBuffer<ServoFrame> servo;
+    std::atomic<uint64_t> servo_seq{0};
+    std::mutex m_rx;
+    std::condition_variable cv_servo;
+
+    std::mutex m_gui;
+    double rc_out[12]{};
+    // Display copy of the normalized servo outputs for the GUI and the log.
+    double sitl_out_pwm[16]{};
+    bool sitl_has_ch[16]{};
+    // Sensor frame destinations with their send counters, refreshed by
+    // the sim thread with each status update.
+    SensorDestStatus dest_status[kSensorDestMax]{};
+    int dest_status_n = 0;
+
+    // Addresses of the primary SITL instance and of any shadows, learned
+    // from their servo packets. dest_version is bumped (under m_addr) on
+    // every change so the sim thread only takes the lock when it must.
+    std::mutex m_addr;
+    struct sockaddr_in sitl_addr = {};
+    bool sitl_addr_known = false;
+    struct sockaddr_in sitl_shadow[kSensorDestMax] = {};
+    int sitl_shadow_n = 0;
+    std::atomic<uint64_t> dest_version{0};
+
+    std::atomic<bool> sim_ok{false};
+    std::atomic<bool> joy_ok{false};
+
+    TxStats tx_stats;
+    AxisStats axis_stats;
+    RxStats rx_stats;
+};
+
+// Channels 1, 2 and 4 (aileron, elevator, rudder) are centred, the others
+// (throttle and aux) run from 0 to 1.
+static inline bool servo_ch_bipolar(int i){ return i == 0 || i == 1 || i == 3; }
+
+// Copy the editable settings into a BridgeConfig (under m_tx). The host
+// fills any host-specific fields and publishes it with S.cfg.publish().
+BridgeConfig snapshot_config(Shared& S);
+
+// True while SITL keeps sending servo frames (last one younger than 300 ms);
+// 'channels' receives the width of that frame. Sim thread only.
+bool servo_link_active(Shared& S, size_t* channels);
+
+// Map the normalized SITL outputs to SimConnect axis units (+-16383),
+// applying the per-channel reversal flags of 'c'. Sim thread only.
+void servo_to_sim_axes(Shared& S, const BridgeConfig& c, long sim_val[16]);
+
+// Sensor -> JSON -> UDP stage. The owning thread calls begin_iteration()
+// once per loop, feeds every new sim sample through on_sample() and then
+// calls pump() to send a frame whose deadline has already passed, then
+// pace() to sleep until the next deadline and send it on time, or until
+// the source signals new data. In lockstep mode neither sends; the thread
+// blocks in wait_servo() and calls answer_servo() for each new servo
+// packet instead.
+class SensorTx {
+public:
+    SensorTx(Shared& S, const BridgeHooks& hooks);
+
+    void begin_iteration();
+    void on_sample(RawSensors raw);
+    void on_sim_lost();
+    void pump();
+    // Sleep until the next TX deadline and send it; returns early, without
+    // sending, when 'wake' (if any) is signalled first.
+    void pace(WaitEvent* wake);
+    void close();
+
+    // The configuration snapshot taken by the last begin_iteration(), for
+    // the rest of the owning loop's iteration.
+    const BridgeConfig& config() const { return *cfg_; }
+
+    bool lockstep() const { return lockstep_snap_; }
+    bool wait_servo(std::chrono::microseconds timeout);
+    void answer_servo();
+
+    // When the next free-running frame is due.
+    std::chrono::steady_clock::time_point next_deadline() const { return pacer_.next_deadline(); }
+
+    int rate_hz() const { return rate_hz_snap_; }
+    int pos_mode() const { return pos_mode_snap_; }
+    // Sim samples received so far.
+    uint64_t sample_count() const { return sample_count_; }
+
+    // Recent samples with their arrival time (steady-clock seconds), for
+    // time-aligned lookups through SensorHistory::sample_at().
+    const SensorHistory& history() const { return history_; }
+
+private:
+    bool send_frame(double t_sec);
+    void refresh_dests();
+    void note_ring_failures();
+    void publish_dest_status();
+    void send_ticks(int n);
+    void publish_pacer_stats();
+    void post_status();
+
+    Shared& S_;
+    const BridgeHooks& hooks_;
+    std::shared_ptr<const BridgeConfig> cfg_;
+    UdpTx tx_;
+    // io_uring path for tx_'s socket when net_backend asks for it; tried
+    // once per socket, sockets stay in use if it cannot be set up.
+    UringUdpTx ring_tx_;
+    bool ring_tx_tried_ = false;
+    int net_backend_snap_ = NET_SOCKETS;
+
+    // Where each frame goes: the SITL instances from Shared (as of
+    // dest_version_) plus the configured listeners.
+    SensorDestSet dests_;
+    uint64_t dest_version_ = ~0ull;
+    struct sockaddr_in listeners_[kSensorDestMax]{};
+    int listener_format_[kSensorDestMax]{};
+    int n_listeners_ = 0;
+    int sitl_format_ = FRAME_JSON;
+    // Sequence number of the next binary packet.
+    uint32_t packet_seq_ = 0;
+    // Encoded frames, one per format; per instance since pooled vehicles
+    // send from several workers at once.
+    char json_buf_[4096];
+    char packet_buf_[SENSOR_PACKET_SIZE_V1];
+    // Shared-memory link (created here, sensor slot), for shm_path_.
+    ShmLink shm_;
+    std::string shm_path_;
+
+    RawSensors R_receive_buffer_{};
+    RawSensors R_prev_sample_{};
+    // The same two samples packed for the linear frame kernel.
+    SensorBlock blk_prev_{}, blk_last_{};
+    // Arrival times of those two samples, steady-clock s.
+    double R_prev_s_ = 0.0, R_last_s_ = 0.0;
+    // Sim frame period and phase from the arrival stamps.
+    FrameClock frame_clock_;
+    uint64_t sample_count_ = 0;
+    uint64_t next_log_ms_ = 0;
+
+    double t_phys_acc_ = 0.0;
+    TxPacer pacer_;
+    std::chrono::steady_clock::time_point last_status_update_;
+
+    uint64_t last_tx_time_ms_ = 0;
+    int tx_frame_count_ = 0;
+    double tx_rate_hz_ = 0.0;
+    uint64_t last_tx_calc_ms_ = 0;
+
+    bool origin_captured_ = false;
+    // S_.sim_origin_set as of the last sample, read with the origin under m_tx.
+    bool origin_set_ = false;
+    int last_pos_mode_ = -1;
+    // Tangent plane at the current origin, rebuilt when the origin moves.
+    LocalFrame geo_;
+
+    // Derived from the config snapshot with version cfg_version_.
+    uint64_t cfg_version_ = ~0ull;
+    int cfg_rate_hz_ = 0;
+    int resample_mode_snap_ = 0;
+    int rate_hz_snap_ = 0;
+    Dest d_now_;
+    bool match_sim_rate_snap_ = false;
+    double sim_dt_ms_snap_ = 0.0;
+    int pos_mode_snap_ = 0;
+    int geodesy_snap_ = GEODESY_WGS84;
+    double target_dt_ = 0.001;
+    bool lockstep_snap_ = false;
+    bool predict_snap_ = false;
+
+    SensorHistory history_;
+    SensorPredictor predictor_;
+
+    // Lockstep bookkeeping: last servo packet answered and its frame_count,
+    // plus turnaround over the current status window.
+    uint64_t answered_seq_ = 0;
+    uint32_t answered_frame_ = 0;
+    bool have_answered_ = false;
+    uint64_t rt_window_sum_us_ = 0, rt_window_max_us_ = 0, rt_window_n_ = 0;
+
+    // Frame layout for the current options.
+    JsonOptions opts_;
+    const JsonProgram* program_ = nullptr;
+};
+
+// One vehicle's sim side: keeps the source connected (retrying every 2 s),
+// feeds its samples to a SensorTx and forwards the SITL servo outputs back
+// to the source through an AxisScheduler. step() is one pass that never
+// sleeps and sends any frame already due; wait() then sleeps until the
+// next TX deadline (or servo packet in lockstep) and sends it. A thread
+// that runs several vehicles calls serve() instead of wait() and sleeps
+// until the earliest next_deadline() itself.
+class SimLoop {
+public:
+    SimLoop(Shared& S, const BridgeHooks& hooks, SensorSource& src);
+
+    // Returns false once the source has finished.
+    bool step();
+    void wait();
+    // wait() without the sleep: answers a servo packet already received.
+    void serve();
+    // time_point::max() in lockstep, where only servo packets are served.
+    std::chrono::steady_clock::time_point next_deadline() const;
+    bool free_running() const;
+    void close();
+
+private:
+    Shared& S_;
+    const BridgeHooks& hooks_;
+    SensorSource& src_;
+    SensorTx stage_;
+
+    std::chrono::steady_clock::time_point next_try_;
+    int attempts_ = 0;
+    bool intercept_enabled_ = false;
+    AxisScheduler axis_out_;
+    uint64_t axis_frame_seen_ = 0;
+};
+
+// Sim loop thread: runs a SimLoop until 'run' drops or the source finishes.
+void sim_loop(Shared& S, const BridgeHooks& hooks, SensorSource& src, const std::atomic<bool>& run);
+
+// One vehicle's servo receiver: listens on dest.port_rx, learns the SITL
+// address (and shadows) and publishes the PWM frames. poll() applies
+// setting changes, waits up to timeout_ms for packets and takes what is
+// queued; it returns the datagrams received.
+class ServoRx {
+public:
+    ServoRx(Shared& S, const BridgeHooks& hooks);
+    ~ServoRx(){ close(); }
+    ServoRx(const ServoRx&) = delete;
+    ServoRx& operator=(const ServoRx&) = delete;
+
+    int poll(int timeout_ms);
+    void close();
+    // The servo socket, for waiting on several vehicles at once; packets
+    // taken by the io_uring receive do not make it readable.
+    socket_t handle() const { return rx_.handle(); }
+
+private:
+    int poll_single(int timeout_ms);
+    int poll_drain(int timeout_ms);
+    int poll_shm(int timeout_ms);
+    void publish(const uint8_t* p, size_t n, const struct sockaddr_in* addr);
+    ServoSeqVerdict track(const uint8_t* p);
+    void publish_shadows();
+    bool from_shadow(const struct sockaddr_in& a, uint64_t now_ms);
+    void expire_shadows();
+    void post_stats();
+    void on_received(int n, std::chrono::steady_clock::time_point now_tp);
+    void on_idle(std::chrono::steady_clock::time_point now_tp);
+
+    Shared& S_;
+    const BridgeHooks& hooks_;
+    UdpRxRaw rx_;
+    std::vector<uint8_t> buf_;
+    bool drain_ = false;
+    bool closed_ = false;
+
+    // io_uring receive for rx_'s socket (drain mode with NET_IO_URING),
+    // tried once per socket.
+    UringUdpRx ring_rx_;
+    bool ring_tried_ = false;
+
+    // Servo slot of the shared-memory link, attached once SensorTx has
+    // created it (retried every 200 ms).
+    ShmLink shm_;
+    std::string shm_path_;
+    uint64_t shm_retry_ms_ = 0;
+    uint32_t shm_seen_ = 0;
+    uint64_t shm_frames_ = 0;
+
+    struct sockaddr_in published_addr_ = {};
+    bool addr_published_ = false;
+    uint64_t servo_seq_ = 0;
+    ServoSeqTracker seq_;
+    uint64_t applied_ = 0, superseded_ = 0, wakeups_ = 0;
+
+    // Shadow SITL instances (sitl_shadows) and when each was last heard.
+    struct ShadowSrc { struct sockaddr_in addr; uint64_t seen_ms; };
+    ShadowSrc shadows_[kSensorDestMax];
+    int n_shadows_ = 0;
+    bool shadows_on_ = false;
+    uint64_t primary_seen_ms_ = 0, shadow_check_ms_ = 0, shadow_pkts_ = 0;
+
+    uint64_t last_rx_time_ms_ = 0;
+    int rx_frame_count_ = 0;
+    double rx_rate_hz_ = 0.0;
+    bool rx_ok_posted_ = false;
+    std::chrono::steady_clock::time_point last_rx_status_post_;
+};
+
+// Servo receive thread: runs a ServoRx until 'run' drops to false.
+void rx_loop(Shared& S, const BridgeHooks& hooks, const std::atomic<bool>& run);
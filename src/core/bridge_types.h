@@ -0,0 +1,90 @@
+/*
+   MSFS 202x–ArduPilot Bridge - portable core types.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <string>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static inline double deg2rad(double deg) { return deg * (M_PI / 180.0); }
+static inline double ft2m(double ft) { return ft * 0.3048; }
+static inline double kt2ms(double kt) { return kt * 0.514444; }
+
+static inline double clampd(double v,double lo,double hi){ return v<lo?lo:(v>hi?hi:v); }
+template<typename T>
+static inline T iclamp(T v, T lo, T hi){ return v<lo?lo:(v>hi?hi:v); }
+
+#pragma pack(push,1)
+
+// Compact UDP packet carrying 16 PWM servo channels.
+struct servo_packet_16 {
+    uint16_t magic = 18458;
+    uint16_t frame_rate;
+    uint32_t frame_count;
+    uint16_t pwm[16];
+};
+static_assert(sizeof(servo_packet_16) == (4 + 4 + 16*2), "servo_packet_16 size mismatch");
+
+// Compact UDP packet carrying 32 PWM servo channels.
+struct servo_packet_32 {
+    uint16_t magic = 29569;
+    uint16_t frame_rate;
+    uint32_t frame_count;
+    uint16_t pwm[32];
+};
+static_assert(sizeof(servo_packet_32) == (4 + 4 + 32*2), "servo_packet_32 size mismatch");
+
+#pragma pack(pop)
+
+// Configuration of the remote SITL endpoint (IP and ports).
+struct Dest {
+    std::string ip="127.0.0.1";
+    uint16_t port_tx=9003;
+    uint16_t port_rx=9002;
+};
+
+static const int kSensorExtraMax = 8;
+
+// Sensor snapshot populated from SimConnect for the current aircraft state.
+struct RawSensors {
+    double lat_deg=0, lon_deg=0;
+    double alt_msl_ft=0, alt_agl_ft=0;
+    double pitch_deg=0, bank_deg=0, hdg_true_deg=0;
+    double ias_kt=0;
+    double vel_e_fps=0, vel_n_fps=0, vel_u_fps=0;
+    double p_rads=0, q_rads=0, r_rads=0;
+    double accel_x_fps2=0, accel_y_fps2=0, accel_z_fps2=0;
+    double engine_rpm=0, prop_rpm=0, prop_pitch_rad=0;
+    double radio_height_ft=0, ground_alt_ft=0;
+    // User SimVars from the INI ([sensors] extraN), logged and shown only.
+    double extra[kSensorExtraMax]{};
+
+    double N_m=0, E_m=0, U_m=0;
+
+    bool valid=false;
+};
+
+static const int kServoMaxChannels = 32;
+
+// One SITL servo packet as handed from rx_loop to the sim output stage:
+// raw PWM, the normalized values the sim axes use, and timing metadata.
+// Fixed size, so publishing it never allocates.
+struct ServoFrame {
+    uint64_t seq = 0;               // packets published so far, 0 = none yet
+    uint32_t frame_count = 0;
+    uint16_t frame_rate = 0;
+    uint16_t channels = 0;          // 16 or 32
+    uint16_t pwm[kServoMaxChannels]{};
+    double norm[kServoMaxChannels]{};
+    std::chrono::steady_clock::time_point t_rx{};
+};
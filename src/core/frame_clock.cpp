@@ -0,0 +1,126 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sim frame clock estimator.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/frame_clock.h"
+
+#include <cmath>
+
+// Frames used to measure the period before the loop closes.
+static const int kAcquireFrames = 8;
+// Frame rates outside this range are not a sim frame clock.
+static const double kMinPeriod = 1.0 / 1000.0, kMaxPeriod = 0.5;
+
+FrameClock::FrameClock(double bandwidth_hz, double initial_period_s)
+: bw_hz_(bandwidth_hz), seed_period_(initial_period_s), period_(initial_period_s) {}
+
+void FrameClock::reset(){
+    const FrameClockStats keep = stats_;
+    *this = FrameClock(bw_hz_, seed_period_);
+    stats_ = keep;
+}
+
+void FrameClock::relock(double t_s){
+    t_next_ = t_s + period_;
+    acq_n_ = 0;
+    acq_t0_ = t_s;
+    acq_sk_ = acq_st_ = acq_skk_ = acq_skt_ = 0.0;
+    outlier_run_ = 0;
+    locked_ = false;
+}
+
+void FrameClock::on_frame(double t_s){
+    stats_.frames++;
+    if (!have_) {
+        have_ = true;
+        t_last_ = t_s;
+        relock(t_s);
+        return;
+    }
+
+    const double gap = t_s - t_last_;
+    if (gap > kStallPeriods * period_) {
+        // Resume on the period we had: after a pause the sim usually runs
+        // at its old rate, and re-measuring it from a few frames is worse.
+        stats_.stalls++;
+        t_last_ = t_s;
+        const bool was_locked = locked_;
+        relock(t_s);
+        locked_ = was_locked;
+        return;
+    }
+    t_last_ = t_s;
+
+    if (!locked_) {
+        // Acquire: least-squares line through the frames so far (the first
+        // one at k = 0, t = 0), so one late frame does not set the phase.
+        acq_n_++;
+        const double k = acq_n_, t = t_s - acq_t0_;
+        acq_sk_ += k; acq_st_ += t; acq_skk_ += k * k; acq_skt_ += k * t;
+        const double n = acq_n_ + 1;
+        const double den = n * acq_skk_ - acq_sk_ * acq_sk_;
+        if (den > 0.0) {
+            const double p = (n * acq_skt_ - acq_sk_ * acq_st_) / den;
+            const double a = (acq_st_ - p * acq_sk_) / n;
+            if (p >= kMinPeriod && p <= kMaxPeriod) {
+                period_ = p;
+                t_next_ = acq_t0_ + a + (k + 1.0) * p;
+            }
+        }
+        if (acq_n_ >= kAcquireFrames) locked_ = true;
+        return;
+    }
+
+    double e = t_s - t_next_;
+
+    // Earlier than half a period before the slot: a second frame handed
+    // over together with the previous one. Its slot is already used.
+    if (e < -0.5 * period_) {
+        stats_.outliers++;
+        return;
+    }
+
+    // Whole periods the sim skipped since the predicted frame. Up to 3/4
+    // of a period late still counts as this slot's frame, arriving late.
+    const double n = std::floor(e / period_ + 0.25);
+    if (n >= 1.0) {
+        stats_.skipped += (uint64_t)n;
+        t_next_ += n * period_;
+        e = t_s - t_next_;
+    }
+
+    // Far off the slot (a late wake-up): use the slot but do not steer.
+    if (std::fabs(e) > 0.25 * period_ && ++outlier_run_ < 3) {
+        stats_.outliers++;
+        t_next_ += period_;
+        return;
+    }
+    outlier_run_ = 0;
+
+    // Second-order loop with damping 1/sqrt(2) (b = sqrt(2)*w, c = w^2):
+    // the usual DLL choice, a little faster to settle than critical
+    // damping. Natural frequency 2*pi*bw in units of frames.
+    const double w = 2.0 * 3.14159265358979323846 * bw_hz_ * period_;
+    const double b = std::sqrt(2.0) * w;
+    const double c = w * w;
+    t_next_ += period_ + b * e;
+    period_ += c * e;
+    if (period_ < kMinPeriod) period_ = kMinPeriod;
+    if (period_ > kMaxPeriod) period_ = kMaxPeriod;
+
+    err_var_ += 0.05 * (e * e - err_var_);
+}
+
+double FrameClock::phase(double t_s) const {
+    if (!have_ || period_ <= 0.0) return 0.0;
+    double a = (t_s - last_frame()) / period_;
+    return a < 0.0 ? 0.0 : (a > 1.0 ? 1.0 : a);
+}
+
+double FrameClock::jitter() const {
+    return std::sqrt(err_var_);
+}
@@ -0,0 +1,85 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sim frame clock estimator.
+
+   Sim frames arrive as a periodic process whose period drifts with the
+   sim's load and whose arrival times carry scheduling jitter. FrameClock
+   tracks it with a second-order phase-locked loop over the arrival stamps:
+   it predicts the next frame time, and each arrival's phase error nudges
+   the phase (gain b) and the period (gain c). The result is a smooth
+   period and a de-jittered time for each frame, which is what the
+   resampler's alpha and rate matching need, instead of a raw interval
+   average.
+
+   Frames the sim skipped (an interval of about n periods) advance the
+   prediction by n periods without disturbing the period. An interval
+   longer than kStallPeriods periods is a stall (paused sim, loading
+   screen, hitch): the loop relocks on the next frame and keeps the
+   period it had.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+
+struct FrameClockStats {
+    uint64_t frames = 0;
+    uint64_t skipped = 0;           // frames the sim did not deliver
+    uint64_t stalls = 0;            // gaps that forced a relock
+    uint64_t outliers = 0;          // early or late arrivals not fed to the loop
+};
+
+class FrameClock {
+public:
+    static constexpr double kStallPeriods = 8.0;
+
+    // bandwidth_hz sets how fast the loop follows period changes (and how
+    // much jitter gets through); the initial period is only a seed.
+    explicit FrameClock(double bandwidth_hz = 0.5, double initial_period_s = 1.0 / 30.0);
+
+    // Forget the lock (sim reconnected); the counters are kept.
+    void reset();
+
+    // One frame arrived at t_s (steady-clock seconds, non-decreasing).
+    void on_frame(double t_s);
+
+    bool locked() const { return locked_; }
+    // Estimated frame period, seconds.
+    double period() const { return period_; }
+    // De-jittered time of the newest frame and the predicted next one.
+    double last_frame() const { return t_next_ - period_; }
+    double next_frame() const { return t_next_; }
+    // Position of t_s inside the current frame interval, 0..1 (clamped).
+    double phase(double t_s) const;
+    // RMS arrival error against the prediction, seconds.
+    double jitter() const;
+    // True when no frame arrived for kStallPeriods periods by t_s.
+    bool stalled(double t_s) const { return have_ && t_s - t_last_ > kStallPeriods * period_; }
+
+    const FrameClockStats& stats() const { return stats_; }
+
+private:
+    void relock(double t_s);
+
+    double bw_hz_;
+    double seed_period_;
+
+    double period_;
+    double t_next_ = 0.0;
+    double t_last_ = 0.0;
+    double err_var_ = 0.0;
+    bool have_ = false;
+    bool locked_ = false;
+    // Line fit t = a + k*p over the frames seen while acquiring, before
+    // the loop takes over.
+    int acq_n_ = 0;
+    double acq_t0_ = 0.0;
+    double acq_sk_ = 0.0, acq_st_ = 0.0, acq_skk_ = 0.0, acq_skt_ = 0.0;
+    // Outliers in a row; a run of them means the loop is off, not the frames.
+    int outlier_run_ = 0;
+
+    FrameClockStats stats_;
+};
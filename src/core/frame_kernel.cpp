@@ -0,0 +1,224 @@
+/*
+   MSFS 202x–ArduPilot Bridge - vectorized sensor frame kernel.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/frame_kernel.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FRAME_KERNEL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRAME_KERNEL_SSE2 1
+#endif
+
+static_assert(offsetof(SensorFrame, position) - offsetof(SensorFrame, velocity) == SL_POS_N * sizeof(double),
+              "SensorFrame fields from velocity to position must be contiguous in lane order");
+static_assert(kSensorLanes % 4 == 0, "lane count must fill whole AVX vectors");
+
+// Source-unit -> frame-unit factor per lane, NED/FRD sign flips included.
+// Same constants and operation order as build_sensor_frame(), so the
+// products round identically.
+alignas(32) static const double kLaneScale[kSensorLanes] = {
+    0.3048, 0.3048, -0.3048,                    // velocity ft/s, up -> down
+    -1.0, -1.0, 1.0,                            // gyro -p, -q, r
+    0.3048, 0.3048, -0.3048,                    // accel_body ft/s^2
+    0.514444,                                   // airspeed kt
+    0.3048,                                     // rng_1 ft (AGL)
+    1.0, 1.0,                                   // lat, lon deg
+    0.3048,                                     // altitude ft
+    1.0, 1.0, -1.0,                             // position N, E, -U
+    -(M_PI / 180.0) * 0.5, -(M_PI / 180.0) * 0.5, (M_PI / 180.0) * 0.5,
+};
+
+void sensor_block_pack(SensorBlock& b, const RawSensors& R){
+    double* v = b.v;
+    v[SL_VEL_N] = R.vel_n_fps;    v[SL_VEL_E] = R.vel_e_fps;    v[SL_VEL_D] = R.vel_u_fps;
+    v[SL_GYRO_X] = R.p_rads;      v[SL_GYRO_Y] = R.q_rads;      v[SL_GYRO_Z] = R.r_rads;
+    v[SL_ACC_X] = R.accel_x_fps2; v[SL_ACC_Y] = R.accel_y_fps2; v[SL_ACC_Z] = R.accel_z_fps2;
+    v[SL_AIRSPEED] = R.ias_kt;
+    v[SL_RNG] = R.alt_agl_ft;
+    v[SL_LAT] = R.lat_deg;        v[SL_LON] = R.lon_deg;        v[SL_ALT] = R.alt_msl_ft;
+    v[SL_POS_N] = R.N_m;          v[SL_POS_E] = R.E_m;          v[SL_POS_D] = R.U_m;
+    v[SL_HALF_ROLL] = R.bank_deg; v[SL_HALF_PITCH] = R.pitch_deg; v[SL_HALF_YAW] = R.hdg_true_deg;
+}
+
+// fdlibm: pi/2 split for Cody-Waite reduction, and the __kernel_sin /
+// __kernel_cos minimax polynomials on [-pi/4, pi/4].
+static const double kInvPio2 = 6.36619772367581382433e-01;
+static const double kPio2Hi = 1.57079632673412561417e+00;
+static const double kPio2Lo = 6.07710050650619224932e-11;
+static const double S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03,
+                    S3 = -1.98412698298579493134e-04, S4 = 2.75573137070700676789e-06,
+                    S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+static const double C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                    C3 = 2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                    C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+
+// Adding 1.5 * 2^52 rounds to the nearest integer and leaves it in the low
+// mantissa bits (exact for |x| < 2^51), so no floor() call and the
+// quadrant is read straight from the bits.
+static const double kRound = 6755399441055744.0;
+
+#if defined(FRAME_KERNEL_AVX2)
+
+static inline __m256d poly6(__m256d z, double k1, double k2, double k3, double k4, double k5, double k6){
+    __m256d p = _mm256_add_pd(_mm256_set1_pd(k5), _mm256_mul_pd(z, _mm256_set1_pd(k6)));
+    p = _mm256_add_pd(_mm256_set1_pd(k4), _mm256_mul_pd(z, p));
+    p = _mm256_add_pd(_mm256_set1_pd(k3), _mm256_mul_pd(z, p));
+    p = _mm256_add_pd(_mm256_set1_pd(k2), _mm256_mul_pd(z, p));
+    return _mm256_add_pd(_mm256_set1_pd(k1), _mm256_mul_pd(z, p));
+}
+
+void sincos4(const double x[4], double s[4], double c[4]){
+    const __m256d vx = _mm256_loadu_pd(x);
+    const __m256d nr = _mm256_add_pd(_mm256_mul_pd(vx, _mm256_set1_pd(kInvPio2)), _mm256_set1_pd(kRound));
+    const __m256d n = _mm256_sub_pd(nr, _mm256_set1_pd(kRound));
+    const __m256d r = _mm256_sub_pd(_mm256_sub_pd(vx, _mm256_mul_pd(n, _mm256_set1_pd(kPio2Hi))),
+                                    _mm256_mul_pd(n, _mm256_set1_pd(kPio2Lo)));
+    const __m256d z = _mm256_mul_pd(r, r);
+    const __m256d sr = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, z), poly6(z, S1, S2, S3, S4, S5, S6)));
+    const __m256d cr = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), z)),
+                                     _mm256_mul_pd(_mm256_mul_pd(z, z), poly6(z, C1, C2, C3, C4, C5, C6)));
+
+    // Odd quadrants swap sin and cos; bit 1 of q (sin) and of q + 1 (cos)
+    // is the sign.
+    const __m256i q = _mm256_castpd_si256(nr);
+    const __m256i one = _mm256_set1_epi64x(1), two = _mm256_set1_epi64x(2);
+    const __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q, one), one));
+    const __m256d ssgn = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(q, two), 62));
+    const __m256d csgn = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(q, one), two), 62));
+    _mm256_storeu_pd(s, _mm256_xor_pd(_mm256_blendv_pd(sr, cr, swap), ssgn));
+    _mm256_storeu_pd(c, _mm256_xor_pd(_mm256_blendv_pd(cr, sr, swap), csgn));
+}
+
+#elif defined(FRAME_KERNEL_SSE2)
+
+static inline __m128d poly6(__m128d z, double k1, double k2, double k3, double k4, double k5, double k6){
+    __m128d p = _mm_add_pd(_mm_set1_pd(k5), _mm_mul_pd(z, _mm_set1_pd(k6)));
+    p = _mm_add_pd(_mm_set1_pd(k4), _mm_mul_pd(z, p));
+    p = _mm_add_pd(_mm_set1_pd(k3), _mm_mul_pd(z, p));
+    p = _mm_add_pd(_mm_set1_pd(k2), _mm_mul_pd(z, p));
+    return _mm_add_pd(_mm_set1_pd(k1), _mm_mul_pd(z, p));
+}
+
+static inline void sincos2(const double* x, double* s, double* c){
+    const __m128d vx = _mm_loadu_pd(x);
+    const __m128d nr = _mm_add_pd(_mm_mul_pd(vx, _mm_set1_pd(kInvPio2)), _mm_set1_pd(kRound));
+    const __m128d n = _mm_sub_pd(nr, _mm_set1_pd(kRound));
+    const __m128d r = _mm_sub_pd(_mm_sub_pd(vx, _mm_mul_pd(n, _mm_set1_pd(kPio2Hi))), _mm_mul_pd(n, _mm_set1_pd(kPio2Lo)));
+    const __m128d z = _mm_mul_pd(r, r);
+    const __m128d sr = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, z), poly6(z, S1, S2, S3, S4, S5, S6)));
+    const __m128d cr = _mm_add_pd(_mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(_mm_set1_pd(0.5), z)),
+                                  _mm_mul_pd(_mm_mul_pd(z, z), poly6(z, C1, C2, C3, C4, C5, C6)));
+
+    // As in the AVX2 path; SSE2 has no 64-bit compare, so the low dword of
+    // each lane is copied to both halves first.
+    const __m128i q = _mm_castpd_si128(nr);
+    const __m128i one = _mm_set1_epi64x(1), two = _mm_set1_epi64x(2);
+    const __m128i odd = _mm_shuffle_epi32(_mm_and_si128(q, one), _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128d swap = _mm_castsi128_pd(_mm_cmpeq_epi32(odd, _mm_set1_epi32(1)));
+    const __m128d ssgn = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(q, two), 62));
+    const __m128d csgn = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(_mm_add_epi64(q, one), two), 62));
+    const __m128d sv = _mm_or_pd(_mm_and_pd(swap, cr), _mm_andnot_pd(swap, sr));
+    const __m128d cv = _mm_or_pd(_mm_and_pd(swap, sr), _mm_andnot_pd(swap, cr));
+    _mm_storeu_pd(s, _mm_xor_pd(sv, ssgn));
+    _mm_storeu_pd(c, _mm_xor_pd(cv, csgn));
+}
+
+void sincos4(const double x[4], double s[4], double c[4]){
+    sincos2(x, s, c);
+    sincos2(x + 2, s + 2, c + 2);
+}
+
+#else
+
+void sincos4(const double x[4], double s[4], double c[4]){
+    static const double kSinSign[4] = {1.0, 1.0, -1.0, -1.0};
+    static const double kCosSign[4] = {1.0, -1.0, -1.0, 1.0};
+    for (int i = 0; i < 4; i++) {
+        const double n = (x[i] * kInvPio2 + kRound) - kRound;
+        const double r = (x[i] - n * kPio2Hi) - n * kPio2Lo;
+        const double z = r * r;
+        const double sc[2] = {
+            r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6))))),
+            1.0 - 0.5 * z + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6))))),
+        };
+        const int q = (int)n & 3;
+        s[i] = sc[q & 1] * kSinSign[q];
+        c[i] = sc[(q & 1) ^ 1] * kCosSign[q];
+    }
+}
+
+#endif
+
+// out = (a + (b - a) * t) * kLaneScale, every lane.
+static void lerp_scale(double* out, const double* a, const double* b, double t){
+#if defined(FRAME_KERNEL_AVX2)
+    const __m256d vt = _mm256_set1_pd(t);
+    for (int i = 0; i < kSensorLanes; i += 4) {
+        __m256d va = _mm256_load_pd(a + i);
+        __m256d vb = _mm256_load_pd(b + i);
+        __m256d v = _mm256_add_pd(va, _mm256_mul_pd(_mm256_sub_pd(vb, va), vt));
+        _mm256_store_pd(out + i, _mm256_mul_pd(v, _mm256_load_pd(kLaneScale + i)));
+    }
+#elif defined(FRAME_KERNEL_SSE2)
+    const __m128d vt = _mm_set1_pd(t);
+    for (int i = 0; i < kSensorLanes; i += 2) {
+        __m128d va = _mm_load_pd(a + i);
+        __m128d vb = _mm_load_pd(b + i);
+        __m128d v = _mm_add_pd(va, _mm_mul_pd(_mm_sub_pd(vb, va), vt));
+        _mm_store_pd(out + i, _mm_mul_pd(v, _mm_load_pd(kLaneScale + i)));
+    }
+#else
+    for (int i = 0; i < kSensorLanes; i++) {
+        out[i] = (a[i] + (b[i] - a[i]) * t) * kLaneScale[i];
+    }
+#endif
+}
+
+void build_sensor_frame_lerp(SensorFrame& f, const SensorBlock& a, const SensorBlock& b, double alpha,
+                             double t_sec, const double rc[12]){
+    alignas(32) double out[kSensorLanes];
+    lerp_scale(out, a.v, b.v, alpha);
+
+    // Heading takes the short way round 360 deg, as in lerp_sensors().
+    const double ha = a.v[SL_HALF_YAW];
+    const double dh = std::fmod(b.v[SL_HALF_YAW] - ha + 540.0, 360.0) - 180.0;
+    out[SL_HALF_YAW] = (ha + dh * alpha) * kLaneScale[SL_HALF_YAW];
+
+    f.timestamp = t_sec;
+    memcpy(reinterpret_cast<char*>(&f) + offsetof(SensorFrame, velocity), out, SL_HALF_ROLL * sizeof(double));
+
+    alignas(32) double x[4] = {out[SL_HALF_ROLL], out[SL_HALF_PITCH], out[SL_HALF_YAW], 0.0};
+    alignas(32) double s[4], c[4];
+    sincos4(x, s, c);
+    const double sr = s[0], cr = c[0], sp = s[1], cp = c[1], sy = s[2], cy = c[2];
+
+    f.quaternion[0] = (float)(cr * cp * cy + sr * sp * sy);
+    f.quaternion[1] = (float)(sr * cp * cy - cr * sp * sy);
+    f.quaternion[2] = (float)(cr * sp * cy + sr * cp * sy);
+    f.quaternion[3] = (float)(cr * cp * sy - sr * sp * cy);
+
+    for(int i=0; i<12; i++) {
+        f.rc[i] = (rc[i] < 0.0) ? 1500.0f : (float)(rc[i] * 1000.0 + 1000.0);
+    }
+}
+
+const char* frame_kernel_isa(){
+#if defined(FRAME_KERNEL_AVX2)
+    return "avx2";
+#elif defined(FRAME_KERNEL_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,54 @@
+/*
+   MSFS 202x–ArduPilot Bridge - vectorized sensor frame kernel.
+
+   The per-frame work of the linear resample path (blend two sim samples,
+   convert units, flip to NED/FRD, build the quaternion) done on a flat
+   block of doubles instead of field by field. A SensorBlock holds only
+   the raw values the frame needs, in SensorFrame order, so blending and
+   unit conversion are one multiply-add pass over 20 lanes (AVX2, SSE2 or
+   scalar, chosen at compile time) and the quaternion needs one shared
+   range reduction for all three half-angle sines and cosines.
+
+   Output matches lerp_sensors() + build_sensor_frame() to the last bit
+   except the quaternion, whose sincos is within an ulp of libm.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include "core/bridge_types.h"
+#include "core/json_frame.h"
+
+// Lanes of a SensorBlock. 0..16 map one to one onto SensorFrame from
+// 'velocity' to 'position'; the last three are the Euler half-angles.
+enum SensorLane {
+    SL_VEL_N, SL_VEL_E, SL_VEL_D,
+    SL_GYRO_X, SL_GYRO_Y, SL_GYRO_Z,
+    SL_ACC_X, SL_ACC_Y, SL_ACC_Z,
+    SL_AIRSPEED, SL_RNG,
+    SL_LAT, SL_LON, SL_ALT,
+    SL_POS_N, SL_POS_E, SL_POS_D,
+    SL_HALF_ROLL, SL_HALF_PITCH, SL_HALF_YAW,
+    kSensorLanes
+};
+
+// One sim sample in source units (ft, kt, deg, sim axes), lane order.
+struct alignas(32) SensorBlock {
+    double v[kSensorLanes];
+};
+
+// Gather the frame fields of R into a block. Done once per sim sample.
+void sensor_block_pack(SensorBlock& b, const RawSensors& R);
+
+// sin and cos of x[0..3] with one range reduction.
+void sincos4(const double x[4], double s[4], double c[4]);
+
+// build_sensor_frame() of lerp_sensors(a, b, alpha), in one pass.
+void build_sensor_frame_lerp(SensorFrame& f, const SensorBlock& a, const SensorBlock& b, double alpha,
+                             double t_sec, const double rc[12]);
+
+// Instruction set the kernel was compiled for ("avx2", "sse2", "scalar").
+const char* frame_kernel_isa();
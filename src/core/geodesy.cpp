@@ -0,0 +1,93 @@
+/*
+   MSFS 202x–ArduPilot Bridge - WGS-84 geodesy.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/geodesy.h"
+
+#include <cmath>
+
+#include "core/bridge_types.h"
+
+static const double kRad2Deg = 57.295779513082320877;
+
+void geodetic_to_ecef(double lat_deg, double lon_deg, double alt_m, double ecef[3]){
+    const double lat = deg2rad(lat_deg), lon = deg2rad(lon_deg);
+    const double sl = std::sin(lat), cl = std::cos(lat);
+    const double n = kWgs84A / std::sqrt(1.0 - kWgs84E2 * sl * sl);
+    ecef[0] = (n + alt_m) * cl * std::cos(lon);
+    ecef[1] = (n + alt_m) * cl * std::sin(lon);
+    ecef[2] = (n * (1.0 - kWgs84E2) + alt_m) * sl;
+}
+
+void ecef_to_geodetic(const double ecef[3], double& lat_deg, double& lon_deg, double& alt_m){
+    const double x = ecef[0], y = ecef[1], z = ecef[2];
+    const double p = std::sqrt(x * x + y * y);
+    double lat = std::atan2(z, p * (1.0 - kWgs84E2));
+    double h = 0.0;
+    // Converges to double precision in a handful of steps near the surface.
+    for (int i = 0; i < 6; i++) {
+        const double sl = std::sin(lat);
+        const double n = kWgs84A / std::sqrt(1.0 - kWgs84E2 * sl * sl);
+        h = (p > 1e-9) ? p / std::cos(lat) - n : std::fabs(z) - n * (1.0 - kWgs84E2);
+        lat = std::atan2(z, p * (1.0 - kWgs84E2 * n / (n + h)));
+    }
+    lat_deg = lat * kRad2Deg;
+    lon_deg = std::atan2(y, x) * kRad2Deg;
+    alt_m = h;
+}
+
+void flat_earth_to_ned(double lat0_deg, double lon0_deg, double alt0_m, double re,
+                       double lat_deg, double lon_deg, double alt_m, double ned[3]){
+    constexpr double DEG2RAD=0.01745329251994329577;
+
+    double dLat=(lat_deg - lat0_deg) * DEG2RAD;
+    double dLon=(lon_deg - lon0_deg) * DEG2RAD;
+    double latm=((lat_deg + lat0_deg)/2.0)*DEG2RAD;
+
+    ned[0] = dLat*re;
+    ned[1] = dLon*re*std::cos(latm);
+    ned[2] = alt0_m - alt_m;
+}
+
+void LocalFrame::set_origin(double lat_deg, double lon_deg, double alt_m){
+    lat0_ = lat_deg;
+    lon0_ = lon_deg;
+    alt0_ = alt_m;
+    geodetic_to_ecef(lat_deg, lon_deg, alt_m, ecef0_);
+
+    const double sl = std::sin(deg2rad(lat_deg)), cl = std::cos(deg2rad(lat_deg));
+    const double so = std::sin(deg2rad(lon_deg)), co = std::cos(deg2rad(lon_deg));
+    // Rows are the north, east and down unit vectors in ECEF.
+    rot_[0] = -sl * co; rot_[1] = -sl * so; rot_[2] = cl;
+    rot_[3] = -so;      rot_[4] = co;       rot_[5] = 0.0;
+    rot_[6] = -cl * co; rot_[7] = -cl * so; rot_[8] = -sl;
+    valid_ = true;
+}
+
+void LocalFrame::to_ned(double lat_deg, double lon_deg, double alt_m, double ned[3]) const {
+    double p[3];
+    geodetic_to_ecef(lat_deg, lon_deg, alt_m, p);
+    const double dx = p[0] - ecef0_[0], dy = p[1] - ecef0_[1], dz = p[2] - ecef0_[2];
+    ned[0] = rot_[0] * dx + rot_[1] * dy + rot_[2] * dz;
+    ned[1] = rot_[3] * dx + rot_[4] * dy + rot_[5] * dz;
+    ned[2] = rot_[6] * dx + rot_[7] * dy + rot_[8] * dz;
+}
+
+void LocalFrame::to_geodetic(const double ned[3], double& lat_deg, double& lon_deg, double& alt_m) const {
+    // The rotation is orthonormal, so its transpose takes NED back to ECEF.
+    double p[3];
+    for (int i = 0; i < 3; i++) {
+        p[i] = ecef0_[i] + rot_[i] * ned[0] + rot_[3 + i] * ned[1] + rot_[6 + i] * ned[2];
+    }
+    ecef_to_geodetic(p, lat_deg, lon_deg, alt_m);
+}
+
+void LocalFrame::to_ned_batch(const double* lat_deg, const double* lon_deg, const double* alt_m, size_t n, double* ned) const {
+    for (size_t i = 0; i < n; i++) {
+        to_ned(lat_deg[i], lon_deg[i], alt_m[i], ned + 3 * i);
+    }
+}
@@ -0,0 +1,56 @@
+/*
+   MSFS 202x–ArduPilot Bridge - WGS-84 geodesy.
+
+   Geodetic (lat, lon, height above the ellipsoid) <-> ECEF <-> local NED
+   about a fixed origin. LocalFrame computes the origin's ECEF point and
+   the ECEF->NED rotation once in set_origin(); after that a conversion is
+   one geodetic->ECEF step (a sin/cos pair per angle and a sqrt) and a
+   3x3 rotation. Exact at any range, unlike the flat-earth approximation
+   kept in flat_earth_to_ned() for the "geodesy=flat" setting.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+
+// N/E computation, as stored in the "geodesy" INI key.
+enum GeodesyMode { GEODESY_FLAT=0, GEODESY_WGS84=1 };
+
+static const double kWgs84A = 6378137.0;
+static const double kWgs84F = 1.0 / 298.257223563;
+static const double kWgs84E2 = kWgs84F * (2.0 - kWgs84F);
+
+void geodetic_to_ecef(double lat_deg, double lon_deg, double alt_m, double ecef[3]);
+
+// Iterative inverse; sub-micrometre for heights from -10 km to 100 km.
+void ecef_to_geodetic(const double ecef[3], double& lat_deg, double& lon_deg, double& alt_m);
+
+// The bridge's original approximation: spherical radius 're', longitude
+// scaled by the cosine of the mean latitude, height difference as up.
+void flat_earth_to_ned(double lat0_deg, double lon0_deg, double alt0_m, double re,
+                       double lat_deg, double lon_deg, double alt_m, double ned[3]);
+
+// Local tangent plane (north, east, down) at a geodetic origin.
+class LocalFrame {
+public:
+    void set_origin(double lat_deg, double lon_deg, double alt_m);
+    bool has_origin(double lat_deg, double lon_deg, double alt_m) const {
+        return valid_ && lat_deg == lat0_ && lon_deg == lon0_ && alt_m == alt0_;
+    }
+
+    void to_ned(double lat_deg, double lon_deg, double alt_m, double ned[3]) const;
+    void to_geodetic(const double ned[3], double& lat_deg, double& lon_deg, double& alt_m) const;
+
+    // Convert n points (for logs and replays); ned receives n x {N, E, D}.
+    void to_ned_batch(const double* lat_deg, const double* lon_deg, const double* alt_m, size_t n, double* ned) const;
+
+private:
+    bool valid_ = false;
+    double lat0_ = 0.0, lon0_ = 0.0, alt0_ = 0.0;
+    double ecef0_[3]{};
+    double rot_[9]{};           // ECEF -> NED, row-major
+};
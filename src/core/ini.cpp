@@ -0,0 +1,83 @@
+/*
+   MSFS 202x–ArduPilot Bridge - minimal portable INI reader.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/ini.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+static std::string trim(const std::string& s){
+    size_t b = 0, e = s.size();
+    while (b < e && isspace((unsigned char)s[b])) b++;
+    while (e > b && isspace((unsigned char)s[e-1])) e--;
+    return s.substr(b, e - b);
+}
+
+static std::string lower(std::string s){
+    for (auto& c : s) c = (char)tolower((unsigned char)c);
+    return s;
+}
+
+static std::string make_key(const char* section, const char* key){
+    return lower(section) + "." + lower(key);
+}
+
+bool IniFile::load(const std::string& path){
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+
+    values_.clear();
+    std::string section;
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        std::string s = trim(line);
+        if (s.empty() || s[0] == ';' || s[0] == '#') continue;
+
+        if (s[0] == '[') {
+            size_t close = s.find(']');
+            if (close != std::string::npos) section = lower(trim(s.substr(1, close - 1)));
+            continue;
+        }
+
+        size_t eq = s.find('=');
+        if (eq == std::string::npos) continue;
+
+        std::string value = s.substr(eq + 1);
+        for (size_t i = 1; i < value.size(); i++) {
+            if ((value[i] == ';' || value[i] == '#') && isspace((unsigned char)value[i-1])) {
+                value.resize(i);
+                break;
+            }
+        }
+        values_[section + "." + lower(trim(s.substr(0, eq)))] = trim(value);
+    }
+    fclose(f);
+    return true;
+}
+
+bool IniFile::has(const char* section, const char* key) const {
+    return values_.count(make_key(section, key)) != 0;
+}
+
+std::string IniFile::get_string(const char* section, const char* key, const char* def) const {
+    auto it = values_.find(make_key(section, key));
+    return it == values_.end() ? std::string(def) : it->second;
+}
+
+int IniFile::get_int(const char* section, const char* key, int def) const {
+    auto it = values_.find(make_key(section, key));
+    if (it == values_.end() || it->second.empty()) return def;
+    return atoi(it->second.c_str());
+}
+
+double IniFile::get_double(const char* section, const char* key, double def) const {
+    auto it = values_.find(make_key(section, key));
+    if (it == values_.end() || it->second.empty()) return def;
+    return atof(it->second.c_str());
+}
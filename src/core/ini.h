@@ -0,0 +1,29 @@
+/*
+   MSFS 202x–ArduPilot Bridge - minimal portable INI reader.
+
+   The GUI keeps using the Win32 profile API; this reader lets the headless
+   runner consume the same msfs_ap_bridge.ini on any platform.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <map>
+#include <string>
+
+class IniFile {
+public:
+    bool load(const std::string& path);
+
+    bool has(const char* section, const char* key) const;
+    std::string get_string(const char* section, const char* key, const char* def) const;
+    int get_int(const char* section, const char* key, int def) const;
+    double get_double(const char* section, const char* key, double def) const;
+
+private:
+    // Keys are stored as "section.key", both lower-cased like the profile API.
+    std::map<std::string, std::string> values_;
+};
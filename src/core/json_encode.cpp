@@ -0,0 +1,252 @@
+/*
+   MSFS 202x–ArduPilot Bridge - allocation-free JSON frame encoder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/json_encode.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+static const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10
+};
+static const uint64_t kPow10u[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+    10000000ull, 100000000ull, 1000000000ull, 10000000000ull
+};
+
+static const char kDigits2[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Longest fast-path output: sign, 16 integer digits, point, 10 decimals.
+static const int kFastMaxLen = 1 + 16 + 1 + 10;
+
+static char* write_uint(char* p, uint64_t v){
+    char tmp[20];
+    char* t = tmp + sizeof(tmp);
+    while (v >= 100) {
+        unsigned d = (unsigned)(v % 100);
+        v /= 100;
+        t -= 2;
+        memcpy(t, kDigits2 + d * 2, 2);
+    }
+    if (v >= 10) { t -= 2; memcpy(t, kDigits2 + v * 2, 2); }
+    else *--t = (char)('0' + v);
+
+    size_t n = (size_t)(tmp + sizeof(tmp) - t);
+    memcpy(p, t, n);
+    return p + n;
+}
+
+// Exactly 'prec' digits, zero padded on the left.
+static char* write_frac(char* p, uint64_t v, int prec){
+    char* e = p + prec;
+    char* t = e;
+    for (int i = prec; i >= 2; i -= 2) {
+        t -= 2;
+        memcpy(t, kDigits2 + (v % 100) * 2, 2);
+        v /= 100;
+    }
+    if (prec & 1) *--t = (char)('0' + v % 10);
+    return e;
+}
+
+char* fmt_fixed(char* p, char* end, double v, int prec){
+    if (!std::isfinite(v)) {
+        // Let the C library spell nan/inf the way the reference path does.
+        int n = snprintf(p, (size_t)(end - p), "%.*f", prec, v);
+        return (n > 0 && n < end - p) ? p + n : nullptr;
+    }
+
+    // y = |v| * 10^prec carries a single rounding error of at most
+    // y * 2^-53, so unless y sits within that distance of a .5 boundary the
+    // nearest integer is the one printf would pick from the exact value.
+    double a = std::fabs(v);
+    double y = a * kPow10[prec];
+    if (y < 4503599627370496.0 && end - p >= kFastMaxLen) {
+        double fl = std::floor(y);
+        double frac = y - fl;
+        double margin = y * 2.3e-16 + 1e-300;
+        if (std::fabs(frac - 0.5) > margin) {
+            uint64_t r = (uint64_t)fl + (frac > 0.5 ? 1 : 0);
+            if (std::signbit(v)) *p++ = '-';
+            p = write_uint(p, r / kPow10u[prec]);
+            if (prec > 0) {
+                *p++ = '.';
+                p = write_frac(p, r % kPow10u[prec], prec);
+            }
+            return p;
+        }
+    }
+
+    // Near-ties and huge magnitudes: exact, locale-free conversion.
+    auto res = std::to_chars(p, end, v, std::chars_format::fixed, prec);
+    if (res.ec != std::errc()) return nullptr;
+    return res.ptr;
+}
+
+#define JF(expr) [](const SensorFrame& f) -> double { return (expr); }
+
+// The ArduPilot JSON sensor frame, in wire order.
+static constexpr JsonFieldDef kJsonSchema[] = {
+    {"{\"timestamp\": ",             JF(f.timestamp),      6, JC_ALWAYS},
+    {", \"latitude\": ",             JF(f.latitude),      10, JC_LLA},
+    {", \"longitude\": ",            JF(f.longitude),     10, JC_LLA},
+    {", \"altitude\": ",             JF(f.altitude),       4, JC_LLA},
+    {", \"position\": [",            JF(f.position[0]),    4, JC_ALWAYS},
+    {", ",                           JF(f.position[1]),    4, JC_ALWAYS},
+    {", ",                           JF(f.position[2]),    4, JC_ALWAYS},
+    {"], \"quaternion\": [",         JF(f.quaternion[0]),  6, JC_ALWAYS},
+    {", ",                           JF(f.quaternion[1]),  6, JC_ALWAYS},
+    {", ",                           JF(f.quaternion[2]),  6, JC_ALWAYS},
+    {", ",                           JF(f.quaternion[3]),  6, JC_ALWAYS},
+    {"], \"velocity\": [",           JF(f.velocity[0]),    6, JC_ALWAYS},
+    {", ",                           JF(f.velocity[1]),    6, JC_ALWAYS},
+    {", ",                           JF(f.velocity[2]),    6, JC_ALWAYS},
+    {"], \"imu\": {\"gyro\": [",     JF(f.gyro[0]),        6, JC_ALWAYS},
+    {", ",                           JF(f.gyro[1]),        6, JC_ALWAYS},
+    {", ",                           JF(f.gyro[2]),        6, JC_ALWAYS},
+    {"], \"accel_body\": [",         JF(f.accel_body[0]),  6, JC_ALWAYS},
+    {", ",                           JF(f.accel_body[1]),  6, JC_ALWAYS},
+    {", ",                           JF(f.accel_body[2]),  6, JC_ALWAYS},
+    {"]}, \"airspeed\": ",           JF(f.airspeed),       4, JC_ALWAYS},
+    {", \"rng_1\": ",                JF(f.rng_1),          4, JC_ALWAYS},
+    {", ",                           nullptr,              0, JC_ALWAYS},
+    {"\"no_lockstep\": false, ",     nullptr,              0, JC_LOCKSTEP_ON},
+    {"\"no_lockstep\": true, ",      nullptr,              0, JC_LOCKSTEP_OFF},
+    {"\"no_time_sync\":false, ",     nullptr,              0, JC_TIME_SYNC_ON},
+    {"\"no_time_sync\":true, ",      nullptr,              0, JC_TIME_SYNC_OFF},
+    {"\"rc\": {\"rc_1\": ",          JF(f.rc[0]),          1, JC_ALWAYS},
+    {", \"rc_2\": ",                 JF(f.rc[1]),          1, JC_ALWAYS},
+    {", \"rc_3\": ",                 JF(f.rc[2]),          1, JC_ALWAYS},
+    {", \"rc_4\": ",                 JF(f.rc[3]),          1, JC_ALWAYS},
+    {", \"rc_5\": ",                 JF(f.rc[4]),          1, JC_ALWAYS},
+    {", \"rc_6\": ",                 JF(f.rc[5]),          1, JC_ALWAYS},
+    {", \"rc_7\": ",                 JF(f.rc[6]),          1, JC_ALWAYS},
+    {", \"rc_8\": ",                 JF(f.rc[7]),          1, JC_ALWAYS},
+    {", \"rc_9\": ",                 JF(f.rc[8]),          1, JC_ALWAYS},
+    {", \"rc_10\": ",                JF(f.rc[9]),          1, JC_ALWAYS},
+    {", \"rc_11\": ",                JF(f.rc[10]),         1, JC_ALWAYS},
+    {", \"rc_12\": ",                JF(f.rc[11]),         1, JC_ALWAYS},
+    {"}}\n",                         nullptr,              0, JC_ALWAYS},
+};
+
+#undef JF
+
+static constexpr size_t kJsonSchemaRows = sizeof(kJsonSchema) / sizeof(kJsonSchema[0]);
+
+// Text and value rows with every row present, an upper bound for any
+// option combination.
+static constexpr size_t schema_text_bytes(){
+    size_t n = 0;
+    for (const JsonFieldDef& r : kJsonSchema) for (const char* t = r.text; *t; t++) n++;
+    return n;
+}
+static constexpr int schema_value_rows(){
+    int n = 0;
+    for (const JsonFieldDef& r : kJsonSchema) if (r.value) n++;
+    return n;
+}
+static_assert(schema_text_bytes() <= (size_t)JsonProgram::kMaxText, "kJsonSchema text outgrew JsonProgram::kMaxText");
+static_assert(schema_value_rows() <= JsonProgram::kMaxOps, "kJsonSchema values outgrew JsonProgram::kMaxOps");
+
+static bool row_present(JsonCond c, const JsonOptions& o){
+    switch (c) {
+        case JC_ALWAYS:        return true;
+        case JC_LLA:           return o.pos_mode == 2;
+        case JC_LOCKSTEP_ON:   return !o.no_lockstep;
+        case JC_LOCKSTEP_OFF:  return o.no_lockstep;
+        case JC_TIME_SYNC_ON:  return o.use_time_sync;
+        case JC_TIME_SYNC_OFF: return !o.use_time_sync;
+    }
+    return false;
+}
+
+void JsonProgram::build(const JsonFieldDef* rows, size_t n, const JsonOptions& o){
+    n_ops_ = 0;
+    size_t used = 0, pending_off = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!row_present(rows[i].cond, o)) continue;
+
+        size_t len = strlen(rows[i].text);
+        if (used + len > (size_t)kMaxText) len = kMaxText - used;
+        memcpy(text_ + used, rows[i].text, len);
+        used += len;
+
+        if (rows[i].value && n_ops_ < kMaxOps) {
+            Op& op = ops_[n_ops_++];
+            op.text_off = (uint16_t)pending_off;
+            op.text_len = (uint16_t)(used - pending_off);
+            op.value = rows[i].value;
+            op.prec = rows[i].prec;
+            pending_off = used;
+        }
+    }
+    tail_off_ = (uint16_t)pending_off;
+    tail_len_ = (uint16_t)(used - pending_off);
+}
+
+int JsonProgram::encode(char* buf, size_t cap, const SensorFrame& f) const {
+    if (cap == 0) return -1;
+    char* p = buf;
+    char* end = buf + cap - 1;
+
+    for (int i = 0; i < n_ops_; i++) {
+        const Op& op = ops_[i];
+        if ((size_t)(end - p) < op.text_len) return -1;
+        memcpy(p, text_ + op.text_off, op.text_len);
+        p += op.text_len;
+        p = fmt_fixed(p, end, op.value(f), op.prec);
+        if (!p) return -1;
+    }
+    if ((size_t)(end - p) < tail_len_) return -1;
+    memcpy(p, text_ + tail_off_, tail_len_);
+    p += tail_len_;
+
+    *p = 0;
+    return (int)(p - buf);
+}
+
+// Index of the program for an option combination; pos_mode 0 and 1 render
+// the same frame.
+static int program_index(const JsonOptions& o){
+    return (o.pos_mode == 2 ? 1 : 0) | (o.no_lockstep ? 2 : 0) | (o.use_time_sync ? 4 : 0);
+}
+
+const JsonProgram& json_program_for(const JsonOptions& o){
+    struct Programs {
+        JsonProgram p[8];
+        Programs(){
+            for (int i = 0; i < 8; i++) {
+                JsonOptions o;
+                o.pos_mode = (i & 1) ? 2 : 0;
+                o.no_lockstep = (i & 2) != 0;
+                o.use_time_sync = (i & 4) != 0;
+                p[i].build(kJsonSchema, kJsonSchemaRows, o);
+            }
+        }
+    };
+    static const Programs programs;
+    return programs.p[program_index(o)];
+}
+
+int encode_json_frame(char* buf, size_t cap, const SensorFrame& f, const JsonOptions& o){
+    return json_program_for(o).encode(buf, cap, f);
+}
@@ -0,0 +1,81 @@
+/*
+   MSFS 202x–ArduPilot Bridge - allocation-free JSON frame encoder.
+
+   Produces exactly the bytes format_json_frame() (snprintf) produces, without
+   the format-string parsing, the locale lookups and the intermediate
+   buffers, so the 1 kHz TX loop spends its time on digits only.
+
+   The frame layout is a constexpr schema (kJsonSchema in json_encode.cpp):
+   one row per key with the text before the value, the value source, its
+   precision and a presence condition. For every option combination the
+   rows are flattened once into a JsonProgram whose constant text is
+   pre-rendered, so the hot path is "copy fragment, format number" with no
+   option checks.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "core/json_frame.h"
+
+// Write 'v' like printf("%.*f", prec, v) into [p, end). Returns the new end
+// of the output, or nullptr when it does not fit. prec must be 0..10.
+char* fmt_fixed(char* p, char* end, double v, int prec);
+
+// When a schema row is part of the frame.
+enum JsonCond : uint8_t {
+    JC_ALWAYS,
+    JC_LLA,             // pos_mode == 2
+    JC_LOCKSTEP_ON,     // no_lockstep == false
+    JC_LOCKSTEP_OFF,    // no_lockstep == true
+    JC_TIME_SYNC_ON,    // use_time_sync == true
+    JC_TIME_SYNC_OFF,   // use_time_sync == false
+};
+
+// One schema row: 'text' is emitted before the value; rows without a
+// value source are pure text.
+struct JsonFieldDef {
+    const char* text;
+    double (*value)(const SensorFrame& f);
+    int prec;
+    JsonCond cond;
+};
+
+// A schema flattened for one option combination.
+class JsonProgram {
+public:
+    // Capacity of a program. build() cuts text and drops value rows past
+    // these, so a schema must fit with every row present; kJsonSchema is
+    // checked against them at compile time.
+    static constexpr int kMaxOps = 64;
+    static constexpr int kMaxText = 1024;
+
+    void build(const JsonFieldDef* rows, size_t n, const JsonOptions& o);
+    int encode(char* buf, size_t cap, const SensorFrame& f) const;
+
+private:
+    struct Op {
+        uint16_t text_off, text_len;
+        double (*value)(const SensorFrame& f);
+        int prec;
+    };
+
+    Op ops_[kMaxOps];
+    int n_ops_ = 0;
+    uint16_t tail_off_ = 0, tail_len_ = 0;
+    char text_[kMaxText];
+};
+
+// Program for the given options; all combinations are built on first use,
+// so callers should look this up when the configuration changes and keep
+// the pointer.
+const JsonProgram& json_program_for(const JsonOptions& o);
+
+// Drop-in replacement for format_json_frame(); same bytes, same return
+// convention (length, or -1 on overflow).
+int encode_json_frame(char* buf, size_t cap, const SensorFrame& f, const JsonOptions& o);
@@ -0,0 +1,116 @@
+/*
+   MSFS 202x–ArduPilot Bridge - ArduPilot JSON sensor frame.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/json_frame.h"
+
+#include <cmath>
+#include <cstdio>
+
+void build_sensor_frame(SensorFrame& f, const RawSensors& R, double t_sec, const double rc[12]){
+    f.timestamp = t_sec;
+
+    f.velocity[0] = ft2m(R.vel_n_fps);
+    f.velocity[1] = ft2m(R.vel_e_fps);
+    f.velocity[2] = ft2m(-R.vel_u_fps);
+
+    f.gyro[0] = -R.p_rads;
+    f.gyro[1] = -R.q_rads;
+    f.gyro[2] = R.r_rads;
+
+    f.accel_body[0] = ft2m(R.accel_x_fps2);
+    f.accel_body[1] = ft2m(R.accel_y_fps2);
+    f.accel_body[2] = ft2m(-R.accel_z_fps2);
+
+    f.airspeed = kt2ms(R.ias_kt);
+    f.rng_1 = ft2m(R.alt_agl_ft);
+
+    f.latitude = R.lat_deg;
+    f.longitude = R.lon_deg;
+    f.altitude = ft2m(R.alt_msl_ft);
+
+    f.position[0] = R.N_m;
+    f.position[1] = R.E_m;
+    f.position[2] = -R.U_m;
+
+    double roll_rad = -deg2rad(R.bank_deg);
+    double pitch_rad = -deg2rad(R.pitch_deg);
+    double yaw_rad = deg2rad(R.hdg_true_deg);
+
+    double cy = cos(yaw_rad * 0.5);
+    double sy = sin(yaw_rad * 0.5);
+    double cp = cos(pitch_rad * 0.5);
+    double sp = sin(pitch_rad * 0.5);
+    double cr = cos(roll_rad * 0.5);
+    double sr = sin(roll_rad * 0.5);
+
+    f.quaternion[0] = (float)(cr * cp * cy + sr * sp * sy);
+    f.quaternion[1] = (float)(sr * cp * cy - cr * sp * sy);
+    f.quaternion[2] = (float)(cr * sp * cy + sr * cp * sy);
+    f.quaternion[3] = (float)(cr * cp * sy - sr * sp * cy);
+
+    for(int i=0; i<12; i++) {
+        f.rc[i] = (rc[i] < 0.0) ? 1500.0f : (float)(rc[i] * 1000.0 + 1000.0);
+    }
+}
+
+int format_json_frame(char* buf, size_t cap, const SensorFrame& f, const JsonOptions& o){
+    char tsync_buf[64];
+    snprintf(tsync_buf, sizeof(tsync_buf), "\"no_time_sync\":%s, ", o.use_time_sync ? "false" : "true");
+
+    char lockstep_buf[64];
+    snprintf(lockstep_buf, sizeof(lockstep_buf), "\"no_lockstep\": %s, ", o.no_lockstep ? "true" : "false");
+
+    char geo_buf[256];
+    if (o.pos_mode == 2) {
+        snprintf(geo_buf, sizeof(geo_buf),
+        "\"latitude\": %.10f, \"longitude\": %.10f, \"altitude\": %.4f, \"position\": [%.4f, %.4f, %.4f], ",
+        f.latitude, f.longitude, f.altitude, f.position[0], f.position[1], f.position[2]);
+    } else {
+        snprintf(geo_buf, sizeof(geo_buf),
+        "\"position\": [%.4f, %.4f, %.4f], ",
+        f.position[0], f.position[1], f.position[2]);
+    }
+
+    int len = snprintf(buf, cap,
+    "{"
+      "\"timestamp\": %.6f, "
+      "%s"
+      "\"quaternion\": [%.6f, %.6f, %.6f, %.6f], "
+      "\"velocity\": [%.6f, %.6f, %.6f], "
+      "\"imu\": {"
+        "\"gyro\": [%.6f, %.6f, %.6f], "
+        "\"accel_body\": [%.6f, %.6f, %.6f]"
+      "}, "
+      "\"airspeed\": %.4f, "
+      "\"rng_1\": %.4f, "
+      "%s"
+      "%s"
+      "\"rc\": {"
+        "\"rc_1\": %.1f, \"rc_2\": %.1f, \"rc_3\": %.1f, \"rc_4\": %.1f, "
+        "\"rc_5\": %.1f, \"rc_6\": %.1f, \"rc_7\": %.1f, \"rc_8\": %.1f, "
+        "\"rc_9\": %.1f, \"rc_10\": %.1f, \"rc_11\": %.1f, \"rc_12\": %.1f"
+      "}"
+    "}\n",
+    f.timestamp,
+    geo_buf,
+    f.quaternion[0], f.quaternion[1], f.quaternion[2], f.quaternion[3],
+    f.velocity[0], f.velocity[1], f.velocity[2],
+    f.gyro[0], f.gyro[1], f.gyro[2],
+    f.accel_body[0], f.accel_body[1], f.accel_body[2],
+    f.airspeed,
+    f.rng_1,
+    lockstep_buf,
+    tsync_buf,
+    f.rc[0], f.rc[1], f.rc[2], f.rc[3],
+    f.rc[4], f.rc[5], f.rc[6], f.rc[7],
+    f.rc[8], f.rc[9], f.rc[10], f.rc[11]
+    );
+
+    if (len <= 0 || (size_t)len >= cap) return -1;
+    return len;
+}
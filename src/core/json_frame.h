@@ -0,0 +1,40 @@
+/*
+   MSFS 202x–ArduPilot Bridge - ArduPilot JSON sensor frame.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include "core/bridge_types.h"
+
+// One sensor frame in SITL units (SI, NED, body FRD), ready to serialize.
+struct SensorFrame {
+    double timestamp=0;
+    float quaternion[4]{};
+    double velocity[3]{};
+    double gyro[3]{};
+    double accel_body[3]{};
+    double airspeed=0;
+    double rng_1=0;
+    double latitude=0, longitude=0, altitude=0;
+    double position[3]{};
+    float rc[12]{};
+};
+
+// Per-connection options that change which constant fragments are emitted.
+struct JsonOptions {
+    int pos_mode=0;
+    bool use_time_sync=true;
+    bool no_lockstep=false;
+};
+
+// Convert a SimConnect sample into SITL units; rc[] holds 0..1 joystick
+// outputs or a negative value for "not mapped" (sent as 1500 us).
+void build_sensor_frame(SensorFrame& f, const RawSensors& R, double t_sec, const double rc[12]);
+
+// Render the JSON frame with snprintf; returns the length or -1 on overflow.
+int format_json_frame(char* buf, size_t cap, const SensorFrame& f, const JsonOptions& o);
@@ -0,0 +1,228 @@
+/*
+   MSFS 202x–ArduPilot Bridge - UDP sockets (WinSock2 and POSIX backends).
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/net.h"
+
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef SIO_UDP_CONNRESET
+#define IOC_IN  0x80000000
+#define IOC_VENDOR 0x18000000
+#define _WSAIOW(x,y) (IOC_IN|(x)|(y))
+#define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR,12)
+#endif
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+NetInit::NetInit(){ WSADATA w; WSAStartup(MAKEWORD(2,2), &w); }
+NetInit::~NetInit(){ WSACleanup(); }
+
+static void disable_connreset(socket_t s){
+    DWORD bytes=0; BOOL b=FALSE;
+    WSAIoctl(s, SIO_UDP_CONNRESET, &b, sizeof(b), NULL, 0, &bytes, NULL, NULL);
+}
+
+static void close_socket(socket_t s){ closesocket(s); }
+
+static void set_recv_timeout_ms(socket_t s, int ms){
+    DWORD to=(DWORD)ms;
+    setsockopt(s,SOL_SOCKET,SO_RCVTIMEO,(const char*)&to,sizeof(to));
+}
+
+static bool recv_timed_out(){ int e=WSAGetLastError(); return e==WSAETIMEDOUT || e==WSAEWOULDBLOCK; }
+
+static bool set_nonblocking_mode(socket_t s, bool on){
+    u_long nb = on ? 1 : 0;
+    return ioctlsocket(s, FIONBIO, &nb) == 0;
+}
+
+#else
+
+NetInit::NetInit(){}
+NetInit::~NetInit(){}
+
+static void disable_connreset(socket_t){}
+
+static void close_socket(socket_t s){ ::close(s); }
+
+static void set_recv_timeout_ms(socket_t s, int ms){
+    struct timeval tv;
+    tv.tv_sec = ms / 1000;
+    tv.tv_usec = (ms % 1000) * 1000;
+    setsockopt(s,SOL_SOCKET,SO_RCVTIMEO,&tv,sizeof(tv));
+}
+
+static bool recv_timed_out(){ return errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR; }
+
+static bool set_nonblocking_mode(socket_t s, bool on){
+    int fl = fcntl(s, F_GETFL, 0);
+    if (fl < 0) return false;
+    return fcntl(s, F_SETFL, on ? (fl | O_NONBLOCK) : (fl & ~O_NONBLOCK)) == 0;
+}
+
+#endif
+
+bool UdpTx::open(const std::string& ip, uint16_t port){
+    close();
+    sock_ = socket(AF_INET,SOCK_DGRAM,IPPROTO_UDP);
+    if(sock_==kInvalidSocket) return false;
+    disable_connreset(sock_);
+
+    // The socket is unconnected (every send names its destination); the
+    // endpoint is only remembered so needs_reopen() settles.
+    ip_ = ip; port_ = port;
+    return true;
+}
+
+void UdpTx::close(){ if(sock_!=kInvalidSocket){ close_socket(sock_); sock_=kInvalidSocket; } }
+
+bool UdpTx::send_buffer(const char* buf, int len, const struct sockaddr_in* dest){
+    if(sock_==kInvalidSocket) return false;
+    if (dest == nullptr || dest->sin_family != AF_INET || dest->sin_port == 0) return false;
+    int sent = (int)sendto(sock_, buf, len, 0, (const sockaddr*)dest, sizeof(struct sockaddr_in));
+    return sent == len;
+}
+
+#ifdef __linux__
+static bool sendable(const UdpMsg& m){
+    return m.dest != nullptr && m.dest->sin_family == AF_INET && m.dest->sin_port != 0;
+}
+#endif
+
+uint32_t UdpTx::send_batch(const UdpMsg* msgs, int n){
+    uint32_t failed = 0;
+#ifdef __linux__
+    struct mmsghdr hdr[kUdpBatchMax];
+    struct iovec iov[kUdpBatchMax];
+    uint32_t tag[kUdpBatchMax];
+    for (int base = 0; base < n; base += kUdpBatchMax) {
+        int m = 0;
+        for (int i = base; i < n && i < base + kUdpBatchMax; i++) {
+            if (sock_ == kInvalidSocket || !sendable(msgs[i])) { failed |= 1u << msgs[i].tag; continue; }
+            iov[m].iov_base = const_cast<void*>(msgs[i].buf);
+            iov[m].iov_len = (size_t)msgs[i].len;
+            hdr[m] = mmsghdr{};
+            hdr[m].msg_hdr.msg_name = const_cast<sockaddr_in*>(msgs[i].dest);
+            hdr[m].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            hdr[m].msg_hdr.msg_iov = &iov[m];
+            hdr[m].msg_hdr.msg_iovlen = 1;
+            tag[m++] = msgs[i].tag;
+        }
+        // sendmmsg() stops at the first message that fails; count it and
+        // carry on with the rest.
+        for (int done = 0; done < m;) {
+            const int r = sendmmsg(sock_, hdr + done, (unsigned)(m - done), 0);
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) { failed |= 1u << tag[done++]; continue; }
+            for (int j = done; j < done + r; j++) {
+                if (hdr[j].msg_len != iov[j].iov_len) failed |= 1u << tag[j];
+            }
+            done += r;
+        }
+    }
+#else
+    for (int i = 0; i < n; i++) {
+        if (!send_buffer((const char*)msgs[i].buf, msgs[i].len, msgs[i].dest)) failed |= 1u << msgs[i].tag;
+    }
+#endif
+    return failed;
+}
+
+bool UdpRxRaw::open(uint16_t port){
+    close();
+    sock_ = socket(AF_INET,SOCK_DGRAM,IPPROTO_UDP);
+    if(sock_==kInvalidSocket) return false;
+    disable_connreset(sock_);
+    sockaddr_in a{};
+    a.sin_family=AF_INET;
+    a.sin_port=htons(port);
+    a.sin_addr.s_addr=INADDR_ANY;
+    if(bind(sock_,(sockaddr*)&a,sizeof(a))!=0){ close(); return false; }
+    set_recv_timeout_ms(sock_, 10);
+    port_=port;
+    return true;
+}
+
+void UdpRxRaw::close(){ if(sock_!=kInvalidSocket){ close_socket(sock_); sock_=kInvalidSocket; } }
+
+int UdpRxRaw::recv(uint8_t* out, int cap, struct sockaddr_in* from_addr){
+    if(sock_==kInvalidSocket) return -1;
+
+    socklen_t fromlen = sizeof(struct sockaddr_in);
+    int len = (int)recvfrom(sock_, (char*)out, cap, 0, (sockaddr*)from_addr, &fromlen);
+
+    if(len<0){
+        if(recv_timed_out()) return 0;
+        return -1;
+    }
+    return len;
+}
+
+bool UdpRxRaw::set_nonblocking(bool on){
+    if(sock_==kInvalidSocket) return false;
+    return set_nonblocking_mode(sock_, on);
+}
+
+int UdpRxRaw::wait_readable(int timeout_ms){
+    if(sock_==kInvalidSocket) return -1;
+
+    // select() is the one readiness wait WinSock and POSIX share; with a
+    // single socket its fd_set cost does not matter.
+    fd_set rd;
+    FD_ZERO(&rd);
+    FD_SET(sock_, &rd);
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    int n = select((int)sock_ + 1, &rd, NULL, NULL, &tv);
+    if(n<0) return recv_timed_out() ? 0 : -1;
+    return n > 0 ? 1 : 0;
+}
+
+int wait_any_readable(const socket_t* socks, int n, int timeout_us){
+    fd_set rd;
+    FD_ZERO(&rd);
+    socket_t top = 0;
+    int added = 0;
+    for (int i = 0; i < n && added < FD_SETSIZE; i++) {
+        if (socks[i] == kInvalidSocket) continue;
+#ifndef _WIN32
+        if (socks[i] >= FD_SETSIZE) continue;
+#endif
+        FD_SET(socks[i], &rd);
+        if (socks[i] > top) top = socks[i];
+        added++;
+    }
+    // WinSock's select() refuses empty sets.
+    if (added == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(timeout_us));
+        return 0;
+    }
+    struct timeval tv;
+    tv.tv_sec = timeout_us / 1000000;
+    tv.tv_usec = timeout_us % 1000000;
+    int r = select((int)top + 1, &rd, NULL, NULL, &tv);
+    if(r<0) return recv_timed_out() ? 0 : -1;
+    return r > 0 ? 1 : 0;
+}
+
+bool UdpRxRaw::send_to(const void* buf, int len, const struct sockaddr_in* to){
+    if(sock_==kInvalidSocket || to == nullptr) return false;
+    int sent = (int)sendto(sock_, (const char*)buf, len, 0, (const sockaddr*)to, sizeof(struct sockaddr_in));
+    return sent == len;
+}
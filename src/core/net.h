@@ -0,0 +1,117 @@
+/*
+   MSFS 202x–ArduPilot Bridge - UDP sockets (WinSock2 and POSIX backends).
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#ifndef _WINSOCK_DEPRECATED_NO_WARNINGS
+#define _WINSOCK_DEPRECATED_NO_WARNINGS
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+typedef int socket_t;
+#endif
+
+#ifdef _WIN32
+static const socket_t kInvalidSocket = INVALID_SOCKET;
+#else
+static const socket_t kInvalidSocket = -1;
+#endif
+
+// RAII helper that brings the socket layer up and down (WinSock2 needs it,
+// POSIX does not).
+struct NetInit {
+    NetInit();
+    ~NetInit();
+};
+
+// One datagram for UdpTx::send_batch() and UringUdpTx::send_batch();
+// 'buf' may be reused as soon as the call returns. 'tag' (0-31) names the
+// message in the failure masks both return.
+struct UdpMsg {
+    const void* buf;
+    int len;
+    const struct sockaddr_in* dest;
+    uint32_t tag;
+};
+
+static const int kUdpBatchMax = 32;
+
+// Thin wrapper around a UDP socket used for transmitting packets.
+class UdpTx {
+public:
+
+    bool open(const std::string& ip, uint16_t port);
+    void close();
+    bool needs_reopen(const std::string& ip, uint16_t port) const {
+
+        return ip!=ip_ || port!=port_;
+    }
+
+    bool send_buffer(const char* buf, int len, const struct sockaddr_in* dest);
+    // Send n datagrams; on Linux as sendmmsg() calls of up to
+    // kUdpBatchMax, elsewhere one sendto() each. Returns the tags (as
+    // bits) of the messages that were not sent whole.
+    uint32_t send_batch(const UdpMsg* msgs, int n);
+
+    socket_t handle() const { return sock_; }
+
+    ~UdpTx(){ close(); }
+private:
+    socket_t sock_=kInvalidSocket;
+    std::string ip_="";
+    uint16_t port_=0;
+};
+
+// Wait up to timeout_us for a datagram on any of the n sockets (invalid
+// ones are skipped). Returns 1 when one is readable, 0 on timeout, -1 on
+// error. select() based, so each call takes at most FD_SETSIZE sockets.
+int wait_any_readable(const socket_t* socks, int n, int timeout_us);
+
+// Thin wrapper around a UDP socket used for receiving raw packets.
+class UdpRxRaw {
+public:
+
+    bool open(uint16_t port);
+    void close();
+    bool needs_reopen(uint16_t port) const { return port!=port_; }
+
+    // Returns the datagram length, 0 on receive timeout (or, when
+    // non-blocking, on an empty queue), -1 on error.
+    int recv(uint8_t* out, int cap, struct sockaddr_in* from_addr);
+
+    // Non-blocking mode: recv() returns at once, for draining the queue
+    // after wait_readable().
+    bool set_nonblocking(bool on);
+
+    // Wait up to timeout_ms for a datagram to be queued. Returns 1 when
+    // one is, 0 on timeout, -1 on error.
+    int wait_readable(int timeout_ms);
+
+    // Reply from the bound port (used by test peers that play SITL).
+    bool send_to(const void* buf, int len, const struct sockaddr_in* to);
+
+    socket_t handle() const { return sock_; }
+
+    ~UdpRxRaw(){ close(); }
+private:
+    socket_t sock_=kInvalidSocket;
+    uint16_t port_=0;
+};
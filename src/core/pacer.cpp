@@ -0,0 +1,130 @@
+/*
+   MSFS 202x–ArduPilot Bridge - deadline-based TX pacer.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/pacer.h"
+
+#include <cstring>
+
+#include "core/platform.h"
+
+void JitterHistogram::add(uint32_t us){
+    bins_[us < (uint32_t)kBins ? us : kBins]++;
+    n_++;
+    if (us > max_) max_ = us;
+}
+
+void JitterHistogram::reset(){
+    memset(bins_, 0, sizeof(bins_));
+    n_ = 0;
+    max_ = 0;
+}
+
+uint32_t JitterHistogram::percentile(double p) const {
+    if (n_ == 0) return 0;
+    uint64_t want = (uint64_t)(p * (double)n_);
+    if (want < 1) want = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kBins; i++) {
+        seen += bins_[i];
+        if (seen >= want) return (uint32_t)i;
+    }
+    return max_;
+}
+
+void TxPacer::set_period(std::chrono::nanoseconds period){
+    if (period.count() <= 0 || period == period_) return;
+    if (started_) {
+        anchor_ = deadline(next_k_ - 1);
+        next_k_ = 1;
+    }
+    period_ = period;
+}
+
+void TxPacer::restart(){
+    anchor_ = clock::now();
+    next_k_ = 1;
+    started_ = true;
+    have_last_ = false;
+}
+
+int TxPacer::wait(){
+    if (!started_) restart();
+    const clock::time_point due = deadline(next_k_);
+
+    clock::time_point now = clock::now();
+    if (due - now > spin_) precise_sleep(due - now - spin_);
+    while ((now = clock::now()) < due) cpu_relax();
+
+    return consume(now);
+}
+
+int TxPacer::wait(WaitEvent& wake){
+    if (!started_) restart();
+    const clock::time_point due = deadline(next_k_);
+
+    clock::time_point now = clock::now();
+    if (due - now > spin_ && wake.wait_for(due - now - spin_)) return 0;
+    while ((now = clock::now()) < due) cpu_relax();
+
+    return consume(now);
+}
+
+int TxPacer::poll(){
+    if (!started_) restart();
+    clock::time_point now = clock::now();
+    if (now < deadline(next_k_)) return 0;
+    return consume(now);
+}
+
+int TxPacer::consume(clock::time_point now){
+    // Last deadline at or before 'now'; everything between it and the one we
+    // were waiting for is dropped.
+    int64_t k = (int64_t)((now - anchor_) / period_);
+    if (k < next_k_) k = next_k_;
+    int n = (int)(k - next_k_ + 1);
+    next_k_ = k + 1;
+
+    if (have_last_ && n == 1) {
+        auto err = (now - last_tick_) - period_;
+        int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(err < err.zero() ? -err : err).count();
+        uint32_t e = (uint32_t)(us > 0xffffffffll ? 0xffffffffll : us);
+        window_.add(e);
+        total_.add(e);
+    }
+    last_tick_ = now;
+    have_last_ = true;
+
+    window_ticks_++;
+    total_ticks_++;
+    window_dropped_ += (uint64_t)(n - 1);
+    total_dropped_ += (uint64_t)(n - 1);
+    return n;
+}
+
+PacerStats TxPacer::make_stats(const JitterHistogram& h, uint64_t ticks, uint64_t dropped){
+    PacerStats s;
+    s.ticks = ticks;
+    s.dropped = dropped;
+    s.p50_us = h.percentile(0.50);
+    s.p99_us = h.percentile(0.99);
+    s.max_us = h.max();
+    return s;
+}
+
+PacerStats TxPacer::window_stats(bool reset){
+    PacerStats s = make_stats(window_, window_ticks_, window_dropped_);
+    if (reset) {
+        window_.reset();
+        window_ticks_ = window_dropped_ = 0;
+    }
+    return s;
+}
+
+PacerStats TxPacer::total_stats() const {
+    return make_stats(total_, total_ticks_, total_dropped_);
+}
@@ -0,0 +1,94 @@
+/*
+   MSFS 202x–ArduPilot Bridge - deadline-based TX pacer.
+
+   Frames are scheduled against absolute deadlines anchor + k * period, so
+   the timebase never drifts no matter how late a single wake-up is. Each
+   wait sleeps until 'spin budget' before the deadline and busy-waits the
+   rest, which gives microsecond spacing at 400-1000 Hz while the core is
+   only spinning for the budget, not the whole period. A deadline that has
+   fully passed before we get to it is dropped (counted), never burst.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+class WaitEvent;
+
+// Timing error histogram: 1 us bins up to kBins us plus one overflow bin.
+class JitterHistogram {
+public:
+    void add(uint32_t us);
+    void reset();
+    // Smallest value with at least 'p' (0..1) of the samples at or below it;
+    // samples in the overflow bin report the exact maximum.
+    uint32_t percentile(double p) const;
+    uint64_t count() const { return n_; }
+    uint32_t max() const { return max_; }
+
+private:
+    static const int kBins = 4096;
+    uint32_t bins_[kBins + 1]{};
+    uint64_t n_ = 0;
+    uint32_t max_ = 0;
+};
+
+// Inter-frame error (|interval - period|) percentiles and dropped deadlines.
+struct PacerStats {
+    uint64_t ticks = 0;
+    uint64_t dropped = 0;
+    uint32_t p50_us = 0, p99_us = 0, max_us = 0;
+};
+
+class TxPacer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Changing the period re-anchors the grid at the last deadline served.
+    void set_period(std::chrono::nanoseconds period);
+    void set_spin_budget(std::chrono::microseconds spin){ spin_ = spin; }
+
+    // Start a fresh grid one period from now (first use, after lockstep).
+    void restart();
+
+    // Block until the next deadline. Returns how many deadlines elapsed:
+    // 1 when on time, more when the caller was late (the extra ones are
+    // counted as dropped).
+    int wait();
+
+    // Non-blocking variant: 0 when the next deadline is still ahead.
+    int poll();
+
+    // wait() that also returns 0 when 'wake' is signalled during the sleep
+    // part; the final spin is not interrupted.
+    int wait(WaitEvent& wake);
+
+    // The deadline the next wait()/poll() serves; now, before the first.
+    clock::time_point next_deadline() const { return started_ ? deadline(next_k_) : clock::now(); }
+
+    PacerStats window_stats(bool reset);
+    PacerStats total_stats() const;
+
+private:
+    clock::time_point deadline(int64_t k) const { return anchor_ + period_ * k; }
+    int consume(clock::time_point now);
+    static PacerStats make_stats(const JitterHistogram& h, uint64_t ticks, uint64_t dropped);
+
+    std::chrono::nanoseconds period_{1000000};
+    std::chrono::microseconds spin_{200};
+    clock::time_point anchor_;
+    int64_t next_k_ = 1;
+    bool started_ = false;
+
+    clock::time_point last_tick_;
+    bool have_last_ = false;
+
+    JitterHistogram window_, total_;
+    uint64_t window_ticks_ = 0, window_dropped_ = 0;
+    uint64_t total_ticks_ = 0, total_dropped_ = 0;
+};
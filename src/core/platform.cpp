@@ -0,0 +1,114 @@
+/*
+   MSFS 202x–ArduPilot Bridge - small platform helpers.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/platform.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#endif
+
+bool pin_current_thread(int cpu){
+    if (cpu < 0) return false;
+#ifdef _WIN32
+    if (cpu >= (int)(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+#ifdef _WIN32
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// One timer per thread; null when the OS predates high-resolution timers
+// (Windows 10 1803), in which case we fall back to Sleep().
+static HANDLE thread_timer(){
+    struct Timer {
+        HANDLE h;
+        Timer(){ h = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS); }
+        ~Timer(){ if (h) CloseHandle(h); }
+    };
+    static thread_local Timer t;
+    return t.h;
+}
+#endif
+
+void precise_sleep(std::chrono::nanoseconds d){
+    if (d.count() <= 0) return;
+#ifdef _WIN32
+    HANDLE h = thread_timer();
+    if (h) {
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((d.count() + 99) / 100);   // relative, 100 ns units
+        if (SetWaitableTimer(h, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(h, INFINITE);
+            return;
+        }
+    }
+    Sleep((DWORD)std::chrono::duration_cast<std::chrono::milliseconds>(d).count());
+#else
+    std::this_thread::sleep_for(d);
+#endif
+}
+
+#ifdef _WIN32
+WaitEvent::WaitEvent() : h_(CreateEventW(nullptr, FALSE, FALSE, nullptr)) {}
+WaitEvent::~WaitEvent(){ if (h_) CloseHandle((HANDLE)h_); }
+void* WaitEvent::native_handle() const { return h_; }
+void WaitEvent::signal(){ SetEvent((HANDLE)h_); }
+
+bool WaitEvent::wait_for(std::chrono::nanoseconds d){
+    if (d.count() < 0) d = std::chrono::nanoseconds(0);
+    HANDLE t = thread_timer();
+    if (t && d.count() > 0) {
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((d.count() + 99) / 100);
+        if (SetWaitableTimer(t, &due, 0, nullptr, nullptr, FALSE)) {
+            HANDLE hs[2] = { (HANDLE)h_, t };
+            DWORD r = WaitForMultipleObjects(2, hs, FALSE, INFINITE);
+            if (r == WAIT_OBJECT_0) { CancelWaitableTimer(t); return true; }
+            return false;
+        }
+    }
+    return WaitForSingleObject((HANDLE)h_, (DWORD)std::chrono::duration_cast<std::chrono::milliseconds>(d).count()) == WAIT_OBJECT_0;
+}
+#else
+WaitEvent::WaitEvent() {}
+WaitEvent::~WaitEvent() {}
+void* WaitEvent::native_handle() const { return nullptr; }
+
+void WaitEvent::signal(){
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        set_ = true;
+    }
+    cv_.notify_one();
+}
+
+bool WaitEvent::wait_for(std::chrono::nanoseconds d){
+    std::unique_lock<std::mutex> lk(m_);
+    if (!set_ && d.count() > 0) cv_.wait_for(lk, d, [&]{ return set_; });
+    const bool was = set_;
+    set_ = false;
+    return was;
+}
+#endif
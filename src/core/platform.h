@@ -0,0 +1,74 @@
+/*
+   MSFS 202x–ArduPilot Bridge - small platform helpers shared by the GUI
+   and the headless runner.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#ifndef _WIN32
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#endif
+
+static inline uint64_t _now_ms() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Same clock in seconds, full resolution.
+static inline double _now_s() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Pin the calling thread to one CPU so the hot loop can be profiled and
+// isolated; returns false when the platform refuses the request.
+bool pin_current_thread(int cpu);
+
+// Sleep for 'd' with the best resolution the OS offers (a high-resolution
+// waitable timer on Windows, where sleep_for rounds up to the 15.6 ms tick).
+void precise_sleep(std::chrono::nanoseconds d);
+
+// Auto-reset event a producer signals when it has data. On Windows it is
+// a real event object, so native_handle() can be given to SimConnect_Open
+// and the waits use the high-resolution timer like precise_sleep().
+class WaitEvent {
+public:
+    WaitEvent();
+    ~WaitEvent();
+    WaitEvent(const WaitEvent&) = delete;
+    WaitEvent& operator=(const WaitEvent&) = delete;
+
+    // Win32 HANDLE; nullptr elsewhere.
+    void* native_handle() const;
+    void signal();
+    // Sleep for up to 'd' or until signalled, consuming the signal. True
+    // when signalled.
+    bool wait_for(std::chrono::nanoseconds d);
+
+private:
+#ifdef _WIN32
+    void* h_;
+#else
+    std::mutex m_;
+    std::condition_variable cv_;
+    bool set_ = false;
+#endif
+};
+
+// Hint to the CPU that we are in a spin-wait loop.
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#endif
+}
@@ -0,0 +1,147 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor history and latency-compensating
+   predictor.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/predict.h"
+
+#include <cmath>
+
+#include "core/quat.h"
+#include "core/resample.h"
+
+static const double kEarthRadius = 6378137.0;
+static const double kRad2Deg = 57.295779513082320877;
+
+// Samples further apart than this are a stall or a pause, not motion.
+static const double kMaxSampleGap = 0.5;
+
+void SensorHistory::push(double t_s, const RawSensors& R){
+    if (count_ > 0 && t_s < newest().t_s) return;
+    head_ = (head_ + 1) % kCapacity;
+    buf_[head_].t_s = t_s;
+    buf_[head_].R = R;
+    if (count_ < kCapacity) count_++;
+}
+
+bool SensorHistory::sample_at(double t_s, RawSensors& out) const {
+    if (count_ == 0) return false;
+    if (t_s == newest().t_s) { out = newest().R; return true; }
+
+    for (size_t i = 0; i + 1 < count_; i++) {
+        const StampedSensors& b = newest(i);
+        const StampedSensors& a = newest(i + 1);
+        if (t_s > b.t_s) return false;
+        if (t_s < a.t_s) continue;
+
+        const double dt = b.t_s - a.t_s;
+        out = b.R;
+        if (dt <= 0.0) return true;
+        hermite_sensors(out, a.R, b.R, dt, (t_s - a.t_s) / dt);
+        return true;
+    }
+    return false;
+}
+
+void extrapolate_sensors(RawSensors& out, const RawSensors& s, const double acc_ned[3], double h_s){
+    out = s;
+    if (!(h_s > 0.0)) return;
+
+    const double hh = 0.5 * h_s * h_s;
+    const double dN = ft2m(s.vel_n_fps) * h_s + acc_ned[0] * hh;
+    const double dE = ft2m(s.vel_e_fps) * h_s + acc_ned[1] * hh;
+    const double dU = ft2m(s.vel_u_fps) * h_s - acc_ned[2] * hh;
+
+    out.N_m += dN;
+    out.E_m += dE;
+    out.U_m += dU;
+
+    const double cos_lat = std::cos(deg2rad(s.lat_deg));
+    const double k_lat = kRad2Deg / kEarthRadius;
+    out.lat_deg += dN * k_lat;
+    if (std::fabs(cos_lat) > 1e-6) out.lon_deg += dE * k_lat / cos_lat;
+    out.alt_msl_ft += dU / 0.3048;
+    out.alt_agl_ft = std::max(0.0, s.alt_agl_ft + dU / 0.3048);
+
+    out.vel_n_fps += acc_ned[0] * h_s / 0.3048;
+    out.vel_e_fps += acc_ned[1] * h_s / 0.3048;
+    out.vel_u_fps -= acc_ned[2] * h_s / 0.3048;
+
+    // Same axes as build_sensor_frame(): roll = -bank, pitch = -pitch and
+    // FRD body rates (-p, -q, r).
+    Quat q = quat_from_euler(-s.bank_deg, -s.pitch_deg, s.hdg_true_deg);
+    q = quat_mul(q, quat_from_rate(-s.p_rads, -s.q_rads, s.r_rads, h_s));
+    double roll_deg, pitch_deg;
+    euler_from_quat(q, roll_deg, pitch_deg, out.hdg_true_deg);
+    out.bank_deg = -roll_deg;
+    out.pitch_deg = -pitch_deg;
+}
+
+// NED acceleration (m/s^2) at sample 'back', from its velocity and the one
+// before it; zero when there is no usable pair. SimConnect's body
+// accelerations are in sim body axes without gravity, so the world-frame
+// difference is both simpler and exact for the data we receive.
+static void ned_accel(const SensorHistory& h, size_t back, double acc[3]){
+    acc[0] = acc[1] = acc[2] = 0.0;
+    if (h.size() < back + 2) return;
+    const StampedSensors& b = h.newest(back);
+    const StampedSensors& a = h.newest(back + 1);
+    const double dt = b.t_s - a.t_s;
+    if (!(dt > 1e-4) || dt > kMaxSampleGap || !a.R.valid || !b.R.valid) return;
+    acc[0] = ft2m(b.R.vel_n_fps - a.R.vel_n_fps) / dt;
+    acc[1] = ft2m(b.R.vel_e_fps - a.R.vel_e_fps) / dt;
+    acc[2] = -ft2m(b.R.vel_u_fps - a.R.vel_u_fps) / dt;
+}
+
+void SensorPredictor::on_sample(const SensorHistory& h){
+    if (h.size() < 2) return;
+    const StampedSensors& cur = h.newest(0);
+    const StampedSensors& prev = h.newest(1);
+    const double gap = cur.t_s - prev.t_s;
+    if (!(gap > 0.0) || gap > kMaxSampleGap || !cur.R.valid || !prev.R.valid) return;
+
+    // Score at the horizon when the sim is slower than it: that is as far
+    // as predict() ever reaches.
+    const double step = std::min(gap, horizon_s_);
+    RawSensors actual;
+    if (!(step > 0.0) || !h.sample_at(prev.t_s + step, actual)) return;
+
+    double acc[3];
+    ned_accel(h, 1, acc);
+    RawSensors guess;
+    extrapolate_sensors(guess, prev.R, acc, step);
+
+    const double err_m = std::sqrt((guess.N_m - actual.N_m) * (guess.N_m - actual.N_m) +
+                                   (guess.E_m - actual.E_m) * (guess.E_m - actual.E_m) +
+                                   (guess.U_m - actual.U_m) * (guess.U_m - actual.U_m));
+    const double err_deg = quat_angle_deg(quat_from_euler(guess.bank_deg, guess.pitch_deg, guess.hdg_true_deg),
+                                          quat_from_euler(actual.bank_deg, actual.pitch_deg, actual.hdg_true_deg));
+    stats_.scored++;
+    stats_.last_err_m = err_m;
+    stats_.last_err_deg = err_deg;
+    if (err_m > stats_.max_err_m) stats_.max_err_m = err_m;
+
+    if (err_m > max_err_m_ || err_deg > kMaxErrDeg) {
+        if (!holding_) stats_.fallbacks++;
+        holding_ = true;
+        good_streak_ = 0;
+    } else if (holding_ && ++good_streak_ >= kRecoverSamples) {
+        holding_ = false;
+    }
+}
+
+bool SensorPredictor::predict(const SensorHistory& h, double t_s, RawSensors& out) const {
+    if (h.size() == 0) return false;
+    const StampedSensors& n = h.newest();
+    out = n.R;
+    if (holding_ || !n.R.valid) return true;
+
+    double acc[3];
+    ned_accel(h, 0, acc);
+    extrapolate_sensors(out, n.R, acc, clampd(t_s - n.t_s, 0.0, horizon_s_));
+    return true;
+}
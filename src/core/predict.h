@@ -0,0 +1,96 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor history and latency-compensating
+   predictor.
+
+   Resampling between the previous and the latest SimConnect frame always
+   shows SITL a state at least one sim frame old. SensorHistory keeps the
+   recent samples with their arrival time; SensorPredictor extrapolates the
+   newest one to the TX instant (dead reckoning on velocity, acceleration
+   and body rates) and falls back to holding the newest sample while its
+   own one-frame-ahead predictions miss by more than a bound.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/bridge_types.h"
+
+// One sim sample and its arrival time (steady-clock seconds).
+struct StampedSensors {
+    double t_s = 0.0;
+    RawSensors R{};
+};
+
+// Ring of the most recent samples, oldest overwritten first. Timestamps
+// must not decrease; a sample older than the newest one is dropped.
+class SensorHistory {
+public:
+    static const size_t kCapacity = 64;
+
+    void push(double t_s, const RawSensors& R);
+    void clear(){ count_ = 0; }
+
+    size_t size() const { return count_; }
+    // back = 0 is the newest sample, size()-1 the oldest.
+    const StampedSensors& newest(size_t back = 0) const { return buf_[(head_ + kCapacity - back) % kCapacity]; }
+
+    // Time-aligned lookup: the state at t_s, interpolated (cubic position,
+    // SLERP attitude) between the two samples that bracket it. False when
+    // t_s lies outside the stored span.
+    bool sample_at(double t_s, RawSensors& out) const;
+
+private:
+    StampedSensors buf_[kCapacity];
+    size_t head_ = kCapacity - 1;
+    size_t count_ = 0;
+};
+
+// Dead-reckon 's' forward by h_s seconds: position from the NED velocity
+// and acceleration (m/s^2), velocity from the acceleration, attitude from
+// the body rates held constant. Other fields are copied.
+void extrapolate_sensors(RawSensors& out, const RawSensors& s, const double acc_ned[3], double h_s);
+
+// Counters for status displays and benchmarks.
+struct PredictorStats {
+    uint64_t scored = 0;            // one-frame-ahead predictions checked
+    uint64_t fallbacks = 0;         // times the error bound tripped
+    double last_err_m = 0.0, last_err_deg = 0.0;
+    double max_err_m = 0.0;
+};
+
+class SensorPredictor {
+public:
+    // horizon_s caps how far past the newest sample it extrapolates;
+    // max_err_m is the one-frame-ahead position error that trips the hold.
+    void configure(double horizon_s, double max_err_m){ horizon_s_ = horizon_s; max_err_m_ = max_err_m; }
+
+    // Call after every history push: scores what the previous sample would
+    // have predicted for the new one and updates the hold state.
+    void on_sample(const SensorHistory& h);
+
+    // State at t_s from the newest sample; the newest sample itself while
+    // holding or when the history is empty.
+    bool predict(const SensorHistory& h, double t_s, RawSensors& out) const;
+
+    void reset(){ holding_ = false; good_streak_ = 0; }
+    bool holding() const { return holding_; }
+    const PredictorStats& stats() const { return stats_; }
+
+    // Attitude counterpart of max_err_m.
+    static constexpr double kMaxErrDeg = 5.0;
+    // Clean predictions needed before leaving the hold.
+    static const int kRecoverSamples = 5;
+
+private:
+    double horizon_s_ = 0.05;
+    double max_err_m_ = 2.0;
+    bool holding_ = false;
+    int good_streak_ = 0;
+    PredictorStats stats_;
+};
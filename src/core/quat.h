@@ -0,0 +1,89 @@
+/*
+   MSFS 202x–ArduPilot Bridge - unit quaternion helpers shared by the
+   resampler and the predictor.
+
+   Angles are ZYX Euler (heading, pitch, bank) in degrees, with the same
+   component order (w, x, y, z) as the JSON frame quaternion.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+
+#include "core/bridge_types.h"
+
+struct Quat { double w, x, y, z; };
+
+static inline Quat quat_from_euler(double bank_deg, double pitch_deg, double hdg_deg){
+    double r = deg2rad(bank_deg) * 0.5, p = deg2rad(pitch_deg) * 0.5, y = deg2rad(hdg_deg) * 0.5;
+    double cr = std::cos(r), sr = std::sin(r);
+    double cp = std::cos(p), sp = std::sin(p);
+    double cy = std::cos(y), sy = std::sin(y);
+    return Quat{
+        cr * cp * cy + sr * sp * sy,
+        sr * cp * cy - cr * sp * sy,
+        cr * sp * cy + sr * cp * sy,
+        cr * cp * sy - sr * sp * cy
+    };
+}
+
+// Heading comes back in [0, 360).
+static inline void euler_from_quat(const Quat& q, double& bank_deg, double& pitch_deg, double& hdg_deg){
+    const double kRad2Deg = 57.295779513082320877;
+    double sinp = 2.0 * (q.w * q.y - q.z * q.x);
+    sinp = clampd(sinp, -1.0, 1.0);
+    bank_deg = std::atan2(2.0 * (q.w * q.x + q.y * q.z), 1.0 - 2.0 * (q.x * q.x + q.y * q.y)) * kRad2Deg;
+    pitch_deg = std::asin(sinp) * kRad2Deg;
+    hdg_deg = std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z)) * kRad2Deg;
+    if (hdg_deg < 0.0) hdg_deg += 360.0;
+}
+
+static inline Quat quat_mul(const Quat& a, const Quat& b){
+    return Quat{
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w
+    };
+}
+
+// Rotation by the rotation vector (wx, wy, wz) * t, i.e. a constant body
+// rate held for t seconds.
+static inline Quat quat_from_rate(double wx, double wy, double wz, double t){
+    double n = std::sqrt(wx * wx + wy * wy + wz * wz);
+    double half = 0.5 * n * t;
+    if (n < 1e-12) return Quat{1.0, 0.5 * wx * t, 0.5 * wy * t, 0.5 * wz * t};
+    double s = std::sin(half) / n;
+    return Quat{std::cos(half), wx * s, wy * s, wz * s};
+}
+
+static inline Quat quat_slerp(const Quat& a, Quat b, double t){
+    double d = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+    if (d < 0.0) { d = -d; b = Quat{-b.w, -b.x, -b.y, -b.z}; }
+
+    double ka, kb;
+    if (d > 1.0 - 1e-9) {
+        // Under ~4.5e-5 rad apart, where normalized lerp is off by far less
+        // than double precision and sin(th) would lose digits.
+        ka = 1.0 - t;
+        kb = t;
+    } else {
+        double th = std::acos(d);
+        double s = 1.0 / std::sin(th);
+        ka = std::sin((1.0 - t) * th) * s;
+        kb = std::sin(t * th) * s;
+    }
+    Quat q{ka * a.w + kb * b.w, ka * a.x + kb * b.x, ka * a.y + kb * b.y, ka * a.z + kb * b.z};
+    double n = 1.0 / std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    return Quat{q.w * n, q.x * n, q.y * n, q.z * n};
+}
+
+// Angle of the rotation between a and b, degrees.
+static inline double quat_angle_deg(const Quat& a, const Quat& b){
+    double d = std::fabs(a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z);
+    return 2.0 * std::acos(d < 1.0 ? d : 1.0) * 57.295779513082320877;
+}
@@ -0,0 +1,50 @@
+/*
+   MSFS 202x–ArduPilot Bridge - read-copy-update cell for immutable
+   configuration snapshots.
+
+   Writers build a complete new value and publish() it; readers get the
+   current snapshot from acquire() as a shared_ptr and never wait for a
+   writer. Holding the pointer pins the snapshot: a replaced value is
+   freed when its last reader lets go of it, however long that reader was
+   held up (preempted, suspended, stopped in a debugger). Readers should
+   still re-acquire every loop iteration so they see new configurations.
+   T needs a 'uint64_t version' member; publish() stamps it with a counter
+   that starts at 1, so readers can rebuild derived state only when the
+   version they cached changes.
+
+   The shared_ptr load is the standard atomic_load overload; common
+   standard libraries implement it with a short internal lock, paid once
+   per loop iteration by each reader.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+template <class T>
+class RcuCell {
+public:
+    RcuCell() : cur_(std::make_shared<const T>()) {}
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    std::shared_ptr<const T> acquire() const { return std::atomic_load_explicit(&cur_, std::memory_order_acquire); }
+
+    void publish(const T& v){
+        std::shared_ptr<T> next = std::make_shared<T>(v);
+        std::lock_guard<std::mutex> lk(m_);
+        next->version = ++version_;
+        std::atomic_store_explicit(&cur_, std::shared_ptr<const T>(std::move(next)), std::memory_order_release);
+    }
+
+private:
+    std::shared_ptr<const T> cur_;
+    std::mutex m_;
+    uint64_t version_ = 0;
+};
@@ -0,0 +1,118 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor resampling between SimConnect frames.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/resample.h"
+
+#include <cmath>
+
+#include "core/quat.h"
+
+static const double kEarthRadius = 6378137.0;
+static const double kRad2Deg = 57.295779513082320877;
+
+void lerp_sensors(RawSensors& R, const RawSensors& a, const RawSensors& b, double alpha){
+    auto lerp  = [](double a,double b,double t){ return a + (b - a)*t; };
+    auto lerp_ang = [](double a,double b,double t){
+        double da = fmod(b - a + 540.0, 360.0) - 180.0;
+        return a + da*t;
+    };
+    R.lat_deg = lerp(a.lat_deg, b.lat_deg, alpha);
+    R.lon_deg = lerp(a.lon_deg, b.lon_deg, alpha);
+    R.alt_msl_ft = lerp(a.alt_msl_ft, b.alt_msl_ft, alpha);
+    R.alt_agl_ft = lerp(a.alt_agl_ft, b.alt_agl_ft, alpha);
+    R.pitch_deg = lerp(a.pitch_deg, b.pitch_deg, alpha);
+    R.bank_deg  = lerp(a.bank_deg,  b.bank_deg,  alpha);
+    R.hdg_true_deg = lerp_ang(a.hdg_true_deg, b.hdg_true_deg, alpha);
+    R.vel_e_fps = lerp(a.vel_e_fps, b.vel_e_fps, alpha);
+    R.vel_n_fps = lerp(a.vel_n_fps, b.vel_n_fps, alpha);
+    R.vel_u_fps = lerp(a.vel_u_fps, b.vel_u_fps, alpha);
+    R.p_rads = lerp(a.p_rads, b.p_rads, alpha);
+    R.q_rads = lerp(a.q_rads, b.q_rads, alpha);
+    R.r_rads = lerp(a.r_rads, b.r_rads, alpha);
+    R.accel_x_fps2 = lerp(a.accel_x_fps2, b.accel_x_fps2, alpha);
+    R.accel_y_fps2 = lerp(a.accel_y_fps2, b.accel_y_fps2, alpha);
+    R.accel_z_fps2 = lerp(a.accel_z_fps2, b.accel_z_fps2, alpha);
+    R.ias_kt = lerp(a.ias_kt, b.ias_kt, alpha);
+    R.engine_rpm = lerp(a.engine_rpm, b.engine_rpm, alpha);
+    R.prop_rpm   = lerp(a.prop_rpm,   b.prop_rpm,   alpha);
+    R.prop_pitch_rad = lerp(a.prop_pitch_rad, b.prop_pitch_rad, alpha);
+    R.radio_height_ft = lerp(a.radio_height_ft, b.radio_height_ft, alpha);
+    R.ground_alt_ft   = lerp(a.ground_alt_ft,   b.ground_alt_ft,   alpha);
+
+    R.N_m = lerp(a.N_m, b.N_m, alpha);
+    R.E_m = lerp(a.E_m, b.E_m, alpha);
+    R.U_m = lerp(a.U_m, b.U_m, alpha);
+}
+
+namespace {
+
+// Cubic Hermite basis on [0,1] and its derivative.
+struct Hermite {
+    double h00, h10, h01, h11;
+    double d00, d10, d01, d11;
+    explicit Hermite(double t){
+        double t2 = t * t, t3 = t2 * t;
+        h00 = 2 * t3 - 3 * t2 + 1;
+        h10 = t3 - 2 * t2 + t;
+        h01 = -2 * t3 + 3 * t2;
+        h11 = t3 - t2;
+        d00 = 6 * t2 - 6 * t;
+        d10 = 3 * t2 - 4 * t + 1;
+        d01 = -6 * t2 + 6 * t;
+        d11 = 3 * t2 - 2 * t;
+    }
+    // p0/p1 are end values, m0/m1 end tangents already scaled by dt.
+    double value(double p0, double m0, double p1, double m1) const { return h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1; }
+    double slope(double p0, double m0, double p1, double m1) const { return d00 * p0 + d10 * m0 + d01 * p1 + d11 * m1; }
+};
+
+}
+
+void hermite_sensors(RawSensors& R, const RawSensors& a, const RawSensors& b, double dt_s, double alpha){
+    lerp_sensors(R, a, b, alpha);
+    if (!(dt_s > 0.0)) return;
+
+    const Hermite H(alpha);
+    const double k_vel = 1.0 / (dt_s * 0.3048);     // m per unit alpha -> ft/s
+
+    // Local frame, metres; tangents from the NED velocities (ft/s).
+    const double vn0 = ft2m(a.vel_n_fps) * dt_s, vn1 = ft2m(b.vel_n_fps) * dt_s;
+    const double ve0 = ft2m(a.vel_e_fps) * dt_s, ve1 = ft2m(b.vel_e_fps) * dt_s;
+    const double vu0 = ft2m(a.vel_u_fps) * dt_s, vu1 = ft2m(b.vel_u_fps) * dt_s;
+    R.N_m = H.value(a.N_m, vn0, b.N_m, vn1);
+    R.E_m = H.value(a.E_m, ve0, b.E_m, ve1);
+    R.U_m = H.value(a.U_m, vu0, b.U_m, vu1);
+
+    // Output velocity is the derivative of the position curve.
+    R.vel_n_fps = H.slope(a.N_m, vn0, b.N_m, vn1) * k_vel;
+    R.vel_e_fps = H.slope(a.E_m, ve0, b.E_m, ve1) * k_vel;
+    R.vel_u_fps = H.slope(a.U_m, vu0, b.U_m, vu1) * k_vel;
+
+    // Geodetic position with the same tangents expressed in deg / ft.
+    const double cos_lat = std::cos(deg2rad(a.lat_deg));
+    const double k_lat = kRad2Deg / kEarthRadius;
+    const double k_lon = (std::fabs(cos_lat) > 1e-6) ? k_lat / cos_lat : 0.0;
+    R.lat_deg = H.value(a.lat_deg, vn0 * k_lat, b.lat_deg, vn1 * k_lat);
+    R.lon_deg = H.value(a.lon_deg, ve0 * k_lon, b.lon_deg, ve1 * k_lon);
+    R.alt_msl_ft = H.value(a.alt_msl_ft, a.vel_u_fps * dt_s, b.alt_msl_ft, b.vel_u_fps * dt_s);
+
+    Quat q = quat_slerp(quat_from_euler(a.bank_deg, a.pitch_deg, a.hdg_true_deg),
+                        quat_from_euler(b.bank_deg, b.pitch_deg, b.hdg_true_deg), alpha);
+    euler_from_quat(q, R.bank_deg, R.pitch_deg, R.hdg_true_deg);
+}
+
+bool resample_blend(const FrameClock& clock, double t_prev_s, double t_last_s, double now_s, double& alpha, double& dt_s){
+    if (t_prev_s <= 0.0 || t_last_s <= t_prev_s) return false;
+    const double since = now_s > t_last_s ? now_s - t_last_s : 0.0;
+    if (since >= 1.0) return false;
+
+    dt_s = t_last_s - t_prev_s;
+    const double from = clock.locked() ? now_s - clock.last_frame() : since;
+    alpha = std::fmin(std::fmax(from / dt_s, 0.0), 1.0);
+    return true;
+}
@@ -0,0 +1,38 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor resampling between SimConnect frames.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include "core/bridge_types.h"
+#include "core/frame_clock.h"
+
+// Resample modes as stored in the "resample" INI key.
+enum ResampleMode { RESAMPLE_OFF=0, RESAMPLE_ZOH=1, RESAMPLE_LINEAR=2, RESAMPLE_CUBIC=3 };
+
+// Linear blend of every sensor field between two samples (heading wraps at
+// 360 deg); flags such as 'valid' are taken from 'out' unchanged.
+void lerp_sensors(RawSensors& out, const RawSensors& a, const RawSensors& b, double alpha);
+
+// Higher-order blend between two samples 'dt_s' seconds apart:
+//  - position (N/E/U, lat/lon/alt) is a cubic Hermite curve whose end
+//    tangents are the sampled velocities, and the output velocities are
+//    that curve's derivative, so position and velocity stay consistent;
+//  - attitude is a quaternion SLERP (no Euler wrap or gimbal artifacts);
+//  - everything else is linear, as in lerp_sensors().
+// Falls back to lerp_sensors() when dt_s is not positive.
+void hermite_sensors(RawSensors& out, const RawSensors& a, const RawSensors& b, double dt_s, double alpha);
+
+// Where 'now_s' falls between the samples that arrived at t_prev_s and
+// t_last_s (steady-clock seconds): alpha 0..1 along the pair, and their
+// spacing dt_s for hermite_sensors(). Once 'clock' is locked, alpha is
+// measured from its de-jittered time of the newest frame rather than the
+// raw arrival. The spacing is always the pair's own: after frames the sim
+// skipped it is several periods, and a blend over one period would run
+// through the pair twice as fast with tangents scaled for the wrong span.
+// False when there is no pair yet or the newest sample is a second old.
+bool resample_blend(const FrameClock& clock, double t_prev_s, double t_last_s, double now_s, double& alpha, double& dt_s);
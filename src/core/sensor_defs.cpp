@@ -0,0 +1,185 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor SimVar registry.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/sensor_defs.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#define RS(f) offsetof(RawSensors, f)
+
+// Note the axis swaps: world X/Z/Y are east/north/up, body X/Y/Z rotation
+// are pitch/yaw/roll rate. Row order is the debug view and log order.
+const SensorVarDef kSensorVars[] = {
+    {"PLANE LATITUDE",             "degrees",                 RS(lat_deg),         SENSOR_GROUP_FRAME, "Latitude",           "deg",    6, "lat_deg",         10},
+    {"PLANE LONGITUDE",            "degrees",                 RS(lon_deg),         SENSOR_GROUP_FRAME, "Longitude",          "deg",    6, "lon_deg",         10},
+    {"PLANE ALTITUDE",             "feet",                    RS(alt_msl_ft),      SENSOR_GROUP_FRAME, "Alt MSL",            "ft",     1, "alt_msl_ft",      4},
+    {"PLANE ALT ABOVE GROUND",     "feet",                    RS(alt_agl_ft),      SENSOR_GROUP_FRAME, "Alt AGL",            "ft",     1, "alt_agl_ft",      4},
+    {"PLANE PITCH DEGREES",        "degrees",                 RS(pitch_deg),       SENSOR_GROUP_FRAME, "Pitch",              "deg",    2, "pitch_deg",       4},
+    {"PLANE BANK DEGREES",         "degrees",                 RS(bank_deg),        SENSOR_GROUP_FRAME, "Bank",               "deg",    2, "bank_deg",        4},
+    {"PLANE HEADING DEGREES TRUE", "degrees",                 RS(hdg_true_deg),    SENSOR_GROUP_FRAME, "Heading True",       "deg",    2, "hdg_true_deg",    4},
+    {"AIRSPEED INDICATED",         "knots",                   RS(ias_kt),          SENSOR_GROUP_FRAME, "Airspeed Indicated", "kt",     1, "ias_kt",          4},
+    {"VELOCITY WORLD X",           "feet per second",         RS(vel_e_fps),       SENSOR_GROUP_FRAME, "Vel East",           "ft/s",   2, "vel_e_fps",       5},
+    {"VELOCITY WORLD Z",           "feet per second",         RS(vel_n_fps),       SENSOR_GROUP_FRAME, "Vel North",          "ft/s",   2, "vel_n_fps",       5},
+    {"VELOCITY WORLD Y",           "feet per second",         RS(vel_u_fps),       SENSOR_GROUP_FRAME, "Vel Up",             "ft/s",   2, "vel_u_fps",       5},
+    {"ROTATION VELOCITY BODY Z",   "radians per second",      RS(p_rads),          SENSOR_GROUP_FRAME, "p (roll rate)",      "rad/s",  3, "p_rads",          6},
+    {"ROTATION VELOCITY BODY X",   "radians per second",      RS(q_rads),          SENSOR_GROUP_FRAME, "q (pitch rate)",     "rad/s",  3, "q_rads",          6},
+    {"ROTATION VELOCITY BODY Y",   "radians per second",      RS(r_rads),          SENSOR_GROUP_FRAME, "r (yaw rate)",       "rad/s",  3, "r_rads",          6},
+    {"ACCELERATION BODY X",        "feet per second squared", RS(accel_x_fps2),    SENSOR_GROUP_FRAME, "Accel X",            "ft/s^2", 2, "accel_x_fps2",    5},
+    {"ACCELERATION BODY Y",        "feet per second squared", RS(accel_y_fps2),    SENSOR_GROUP_FRAME, "Accel Y",            "ft/s^2", 2, "accel_y_fps2",    5},
+    {"ACCELERATION BODY Z",        "feet per second squared", RS(accel_z_fps2),    SENSOR_GROUP_FRAME, "Accel Z",            "ft/s^2", 2, "accel_z_fps2",    5},
+    {"GENERAL ENG RPM:1",          "rpm",                     RS(engine_rpm),      SENSOR_GROUP_SLOW,  "Engine RPM",         "rpm",    0, "engine_rpm",      2},
+    {"PROP RPM:1",                 "rpm",                     RS(prop_rpm),        SENSOR_GROUP_SLOW,  "Prop RPM",           "rpm",    0, "prop_rpm",        2},
+    {"PROP BETA:1",                "radians",                 RS(prop_pitch_rad),  SENSOR_GROUP_SLOW,  "Prop Beta",          "rad",    3, "prop_pitch_rad",  6},
+    {"RADIO HEIGHT",               "feet",                    RS(radio_height_ft), SENSOR_GROUP_FRAME, "Radio Height",       "ft",     1, "radio_height_ft", 4},
+    {"GROUND ALTITUDE",            "feet",                    RS(ground_alt_ft),   SENSOR_GROUP_SLOW,  "Ground Alt",         "ft",     1, "ground_alt_ft",   4},
+};
+const size_t kSensorVarCount = sizeof(kSensorVars) / sizeof(kSensorVars[0]);
+
+#undef RS
+
+SensorRegistry::SensorRegistry() : rows_(kSensorVars, kSensorVars + kSensorVarCount) {}
+
+static std::string trim(const std::string& s){
+    size_t a = 0, b = s.size();
+    while (a < b && isspace((unsigned char)s[a])) a++;
+    while (b > a && isspace((unsigned char)s[b - 1])) b--;
+    return s.substr(a, b - a);
+}
+
+bool SensorRegistry::add_extra(const std::string& spec){
+    if (extras_ >= kSensorExtraMax) return false;
+
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (;;) {
+        size_t comma = spec.find(',', start);
+        parts.push_back(trim(spec.substr(start, comma == std::string::npos ? std::string::npos : comma - start)));
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    if (parts.size() < 2 || parts.size() > 4 || parts[0].empty() || parts[1].empty()) return false;
+
+    int group = SENSOR_GROUP_SLOW;
+    if (parts.size() > 2 && !parts[2].empty()) {
+        if (parts[2] == "frame") group = SENSOR_GROUP_FRAME;
+        else if (parts[2] != "slow") return false;
+    }
+
+    std::string column = parts.size() > 3 ? parts[3] : "";
+    if (column.empty()) {
+        for (char c : parts[0]) column += isalnum((unsigned char)c) ? (char)tolower((unsigned char)c) : '_';
+    }
+    if (find_column(column.c_str()) >= 0) return false;
+
+    strings_.push_back(parts[0]);
+    const char* simvar = strings_.back().c_str();
+    strings_.push_back(parts[1]);
+    const char* units = strings_.back().c_str();
+    strings_.push_back(column);
+    const char* col = strings_.back().c_str();
+
+    rows_.push_back({simvar, units, offsetof(RawSensors, extra) + (size_t)extras_ * sizeof(double), group,
+                     simvar, units, 3, col, 6});
+    extras_++;
+    return true;
+}
+
+int SensorRegistry::find_column(const char* column) const {
+    for (size_t i = 0; i < rows_.size(); i++) {
+        if (!strcmp(rows_[i].column, column)) return (int)i;
+    }
+    return -1;
+}
+
+size_t SensorRegistry::csv_header(char* buf, size_t cap) const {
+    size_t n = 0;
+    if (cap) buf[0] = 0;
+    for (const SensorVarDef& d : rows_) {
+        if (n + 1 >= cap) break;
+        int w = snprintf(buf + n, cap - n, ",%s", d.column);
+        if (w < 0) break;
+        n += (size_t)w < cap - n ? (size_t)w : cap - n - 1;
+    }
+    return n;
+}
+
+size_t SensorRegistry::csv_row(const RawSensors& R, char* buf, size_t cap) const {
+    size_t n = 0;
+    if (cap) buf[0] = 0;
+    for (const SensorVarDef& d : rows_) {
+        if (n + 1 >= cap) break;
+        double v;
+        memcpy(&v, (const char*)&R + d.offset, sizeof(v));
+        int w = snprintf(buf + n, cap - n, ",%.*f", d.log_precision, v);
+        if (w < 0) break;
+        n += (size_t)w < cap - n ? (size_t)w : cap - n - 1;
+    }
+    return n;
+}
+
+const SensorRegistry& default_sensor_registry(){
+    static const SensorRegistry reg;
+    return reg;
+}
+
+bool SensorRequests::open(SimDataApi& api, const SensorRegistry& reg, uint32_t def_base, uint32_t req_base, int slow_frames){
+    req_base_ = req_base;
+    groups_ = slow_frames > 1 ? 2 : 1;
+    cur_ = RawSensors{};
+    stats_ = SensorRequestStats{};
+    for (int g = 0; g < kSensorGroups; g++) n_[g] = 0;
+    datums_ = 0;
+
+    bool ok = true;
+    for (int g = 0; g < groups_; g++) api.clear_definition(def_base + (uint32_t)g);
+    for (size_t i = 0; i < reg.size() && i < kMaxVars; i++) {
+        const SensorVarDef& d = reg[i];
+        const int g = groups_ > 1 ? d.group : SENSOR_GROUP_FRAME;
+        ok = api.add_to_definition(def_base + (uint32_t)g, d.simvar, d.units, (uint32_t)i) && ok;
+        offs_[g][n_[g]++] = d.offset;
+        datum_offs_[datums_++] = d.offset;
+    }
+
+    ok = api.request_data(req_base, def_base, SIM_PERIOD_FRAME, 0, 0) && ok;
+    if (groups_ > 1) {
+        ok = api.request_data(req_base + 1, def_base + 1, SIM_PERIOD_FRAME, (uint32_t)(slow_frames - 1),
+                              SIM_REQ_CHANGED | SIM_REQ_TAGGED) && ok;
+    }
+    return ok;
+}
+
+bool SensorRequests::on_data(uint32_t req_id, bool tagged, uint32_t count, const void* data, size_t bytes){
+    if (!owns(req_id)) { stats_.rejected++; return false; }
+    const int g = (int)(req_id - req_base_);
+    const char* p = (const char*)data;
+    char* dst = (char*)&cur_;
+
+    if (tagged) {
+        // (DWORD datum id, FLOAT64 value) pairs, packed.
+        const size_t entry = sizeof(uint32_t) + sizeof(double);
+        if ((size_t)count * entry > bytes) { stats_.rejected++; return false; }
+        for (uint32_t k = 0; k < count; k++, p += entry) {
+            uint32_t id;
+            memcpy(&id, p, sizeof(id));
+            if (id >= datums_) continue;
+            memcpy(dst + datum_offs_[id], p + sizeof(id), sizeof(double));
+        }
+    } else {
+        if (n_[g] * sizeof(double) > bytes) { stats_.rejected++; return false; }
+        const size_t* offs = offs_[g];
+        for (size_t k = 0; k < n_[g]; k++) {
+            memcpy(dst + offs[k], p + k * sizeof(double), sizeof(double));
+        }
+    }
+
+    stats_.messages[g]++;
+    stats_.bytes[g] += bytes;
+    return g == SENSOR_GROUP_FRAME;
+}
@@ -0,0 +1,134 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor SimVar registry.
+
+   Every sensor SimVar is one row of kSensorVars: SimConnect name and
+   units, the RawSensors field it lands in, its rate group, and how the
+   debug view and the CSV log present it. The data definitions, the
+   message unpacker, the debug list and the log schema are all generated
+   from the rows, so adding a sensor is one new RawSensors field and one
+   row. SensorRegistry adds the user's extra SimVars from the INI on top of
+   the built-in rows; they land in RawSensors::extra.
+
+   Rate groups: attitude, rates, accelerations, position and velocity
+   change every sim frame and feed the EKF, so they are requested every
+   frame. Engine, prop and terrain values change slowly. They go into a
+   second definition that is requested every few frames, in tagged format,
+   and only when a value changed. That keeps the per-frame message (and
+   its dispatch) to the fields that need it.
+
+   SensorRequests builds both definitions through SimDataApi and merges
+   the incoming messages by request id into one RawSensors. A frame-group
+   message completes a sample; slow-group messages only update the held
+   values.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "core/bridge_types.h"
+#include "core/sim_data_api.h"
+
+enum SensorGroup { SENSOR_GROUP_FRAME=0, SENSOR_GROUP_SLOW=1, kSensorGroups };
+
+// One FLOAT64 SimVar. RawSensors only holds doubles, so there is no other
+// datatype to describe.
+struct SensorVarDef {
+    const char* simvar;
+    const char* units;
+    size_t offset;                  // double field in RawSensors
+    int group;                      // SensorGroup
+    const char* label;              // debug view
+    const char* display_units;
+    int precision;                  // debug view decimals
+    const char* column;             // CSV log column
+    int log_precision;              // CSV log decimals
+};
+
+extern const SensorVarDef kSensorVars[];
+extern const size_t kSensorVarCount;
+
+// Built-in rows plus the user's extra SimVars. Rows point into strings the
+// registry owns, so it is not copyable; build it once and keep it for the
+// life of the process.
+class SensorRegistry {
+public:
+    SensorRegistry();
+    SensorRegistry(const SensorRegistry&) = delete;
+    SensorRegistry& operator=(const SensorRegistry&) = delete;
+
+    // Add an extra SimVar from "SIMVAR,units[,frame|slow[,column]]".
+    // False when the spec is malformed or all kSensorExtraMax slots are
+    // taken.
+    bool add_extra(const std::string& spec);
+    int extras() const { return extras_; }
+
+    size_t size() const { return rows_.size(); }
+    const SensorVarDef& operator[](size_t i) const { return rows_[i]; }
+
+    // Row logged under 'column', or -1.
+    int find_column(const char* column) const;
+
+    // CSV log header fields and one row of values, each comma-separated
+    // with a leading comma, so hosts can put their own columns around
+    // them. Returns the length written (truncated to cap-1).
+    size_t csv_header(char* buf, size_t cap) const;
+    size_t csv_row(const RawSensors& R, char* buf, size_t cap) const;
+
+private:
+    std::vector<SensorVarDef> rows_;
+    std::deque<std::string> strings_;
+    int extras_ = 0;
+};
+
+// Built-in rows only, for code that never sees the INI (replay).
+const SensorRegistry& default_sensor_registry();
+
+struct SensorRequestStats {
+    uint64_t messages[kSensorGroups]{};
+    uint64_t bytes[kSensorGroups]{};
+    uint64_t rejected = 0;          // unknown request, short payload
+};
+
+class SensorRequests {
+public:
+    static const size_t kMaxVars = 64;
+
+    // Define and request the registry's SimVars; 'reg' must outlive this.
+    // The slow group uses def_base+1 / req_base+1 and is sent every
+    // slow_frames sim frames; slow_frames <= 1 puts everything in the
+    // frame group (one definition).
+    bool open(SimDataApi& api, const SensorRegistry& reg, uint32_t def_base, uint32_t req_base, int slow_frames);
+
+    bool owns(uint32_t req_id) const { return req_id >= req_base_ && req_id < req_base_ + (uint32_t)groups_; }
+
+    // Merge one data message ('count' entries, 'bytes' of payload). Returns
+    // true when it was a frame-group message, i.e. current() is a new
+    // sample.
+    bool on_data(uint32_t req_id, bool tagged, uint32_t count, const void* data, size_t bytes);
+
+    const RawSensors& current() const { return cur_; }
+    int groups() const { return groups_; }
+    size_t fields(int group) const { return n_[group]; }
+    const SensorRequestStats& stats() const { return stats_; }
+
+private:
+    uint32_t req_base_ = 0;
+    int groups_ = 0;
+    // RawSensors offset of each field, in definition order per group, and
+    // by datum id (= registry row) for tagged messages.
+    size_t offs_[kSensorGroups][kMaxVars];
+    size_t n_[kSensorGroups]{};
+    size_t datum_offs_[kMaxVars];
+    size_t datums_ = 0;
+    RawSensors cur_{};
+    SensorRequestStats stats_;
+};
@@ -0,0 +1,127 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor stream destinations.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/sensor_dest.h"
+
+#include <cstdlib>
+#include <cstring>
+
+const char* sensor_dest_kind_name(int kind){
+    switch (kind) {
+    case DEST_PRIMARY: return "primary";
+    case DEST_SHADOW: return "shadow";
+    default: return "listener";
+    }
+}
+
+const char* sensor_frame_format_name(int format){
+    return format == FRAME_BINARY ? "binary" : "json";
+}
+
+static bool parse_endpoint(std::string item, struct sockaddr_in* out, int* format){
+    int fmt = FRAME_JSON;
+    const size_t slash = item.rfind('/');
+    if (slash != std::string::npos) {
+        const std::string name = item.substr(slash + 1);
+        if (name == "binary") fmt = FRAME_BINARY;
+        else if (name != "json") return false;
+        item.resize(slash);
+    }
+    const size_t colon = item.rfind(':');
+    if (colon == std::string::npos || colon == 0) return false;
+    const std::string ip = item.substr(0, colon);
+    const std::string port = item.substr(colon + 1);
+    char* end = nullptr;
+    long p = strtol(port.c_str(), &end, 10);
+    if (port.empty() || *end != '\0' || p <= 0 || p > 65535) return false;
+
+    struct sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET;
+    a.sin_port = htons((uint16_t)p);
+    if (inet_pton(AF_INET, ip.c_str(), &a.sin_addr) != 1) return false;
+    *out = a;
+    *format = fmt;
+    return true;
+}
+
+int parse_endpoint_list(const std::string& text, struct sockaddr_in* out, int max, std::string* bad, int* formats){
+    int n = 0;
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t comma = text.find(',', pos);
+        if (comma == std::string::npos) comma = text.size();
+        std::string item = text.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        const size_t b = item.find_first_not_of(" \t");
+        if (b == std::string::npos) continue;
+        item = item.substr(b, item.find_last_not_of(" \t") - b + 1);
+
+        struct sockaddr_in a;
+        int format;
+        if (n < max && parse_endpoint(item, &a, &format)) {
+            if (formats) formats[n] = format;
+            out[n++] = a;
+        }
+        else if (bad && bad->empty()) *bad = item;
+    }
+    return n;
+}
+
+bool SensorDestSet::add(const struct sockaddr_in& a, int kind, int format, const Entry* old, int n_old){
+    if (n_ >= kSensorDestMax) return false;
+    for (int i = 0; i < n_; i++) {
+        if (same_endpoint(d_[i].st.addr, a)) return false;
+    }
+    Entry& e = d_[n_];
+    memset(&e, 0, sizeof(e));
+    e.st.addr = a;
+    e.st.kind = kind;
+    e.st.format = format;
+    formats_ |= 1u << format;
+    for (int i = 0; i < n_old; i++) {
+        if (same_endpoint(old[i].st.addr, a)) {
+            e.st.frames = old[i].st.frames;
+            e.st.errors = old[i].st.errors;
+            e.st.rate_hz = old[i].st.rate_hz;
+            e.window_start = old[i].window_start;
+            break;
+        }
+    }
+    n_++;
+    return true;
+}
+
+void SensorDestSet::rebuild(const struct sockaddr_in* primary,
+                            const struct sockaddr_in* shadows, int n_shadows, int sitl_format,
+                            const struct sockaddr_in* listeners, const int* listener_formats, int n_listeners){
+    Entry old[kSensorDestMax];
+    const int n_old = n_;
+    memcpy(old, d_, sizeof(Entry) * (size_t)n_old);
+
+    n_ = 0;
+    formats_ = 0;
+    if (primary) add(*primary, DEST_PRIMARY, sitl_format, old, n_old);
+    for (int i = 0; i < n_shadows; i++) add(shadows[i], DEST_SHADOW, sitl_format, old, n_old);
+    for (int i = 0; i < n_listeners; i++) add(listeners[i], DEST_LISTENER, listener_formats[i], old, n_old);
+}
+
+void SensorDestSet::update_rates(double dt_s){
+    if (dt_s <= 0.0) return;
+    for (int i = 0; i < n_; i++) {
+        d_[i].st.rate_hz = (double)(d_[i].st.frames - d_[i].window_start) / dt_s;
+        d_[i].window_start = d_[i].st.frames;
+    }
+}
+
+int SensorDestSet::status(SensorDestStatus* out, int max) const {
+    int n = n_ < max ? n_ : max;
+    for (int i = 0; i < n; i++) out[i] = d_[i].st;
+    return n;
+}
@@ -0,0 +1,97 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor stream destinations.
+
+   Every sensor frame is encoded once and sent to a set of destinations:
+     - the primary SITL, learned from its servo packets; only it drives
+       the servo -> sim path;
+     - shadow SITL instances (different parameters or firmware on the
+       same flight), also learned from their servo packets when
+       sitl_shadows is on; their servo outputs are ignored;
+     - listeners from the configuration (recorders, tools), which never
+       talk back.
+   Each destination gets either the JSON frame or the binary packet of
+   sensor_packet.h: the SITL instances as configured, listeners by an
+   optional "/binary" or "/json" suffix on their address.
+   SensorDestSet is the sim thread's copy of that set with send counters
+   per destination, kept across rebuilds for addresses that stay.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "core/net.h"
+
+static const int kSensorDestMax = 16;
+
+enum SensorDestKind { DEST_PRIMARY=0, DEST_SHADOW=1, DEST_LISTENER=2 };
+
+const char* sensor_dest_kind_name(int kind);
+
+enum SensorFrameFormat { FRAME_JSON=0, FRAME_BINARY=1 };
+
+const char* sensor_frame_format_name(int format);
+
+// Per-destination counters as published for status displays: frames
+// handed to the network stack, and how many of those failed.
+struct SensorDestStatus {
+    struct sockaddr_in addr;
+    int kind;
+    int format;
+    uint64_t frames;
+    uint64_t errors;
+    double rate_hz;
+};
+
+static inline bool same_endpoint(const struct sockaddr_in& a, const struct sockaddr_in& b){
+    return a.sin_port == b.sin_port && a.sin_addr.s_addr == b.sin_addr.s_addr;
+}
+
+// Parse "ip:port[/format][,ip:port...]" (spaces allowed) into 'out', and
+// each entry's SensorFrameFormat (FRAME_JSON without a suffix) into
+// 'formats' when given. Returns the number of endpoints stored; the first
+// entry that does not parse (or does not fit) is copied to *bad when given.
+int parse_endpoint_list(const std::string& text, struct sockaddr_in* out, int max, std::string* bad = nullptr,
+                        int* formats = nullptr);
+
+class SensorDestSet {
+public:
+    // Replace the set: the primary (when known), then shadows, then
+    // listeners, skipping duplicates and anything past kSensorDestMax.
+    // The SITL instances get sitl_format, listeners their own format.
+    void rebuild(const struct sockaddr_in* primary,
+                 const struct sockaddr_in* shadows, int n_shadows, int sitl_format,
+                 const struct sockaddr_in* listeners, const int* listener_formats, int n_listeners);
+
+    int size() const { return n_; }
+    const struct sockaddr_in& addr(int i) const { return d_[i].st.addr; }
+    int format(int i) const { return d_[i].st.format; }
+    // True when some destination takes frames in 'format'.
+    bool uses(int format) const { return (formats_ & (1u << format)) != 0; }
+    bool has_primary() const { return n_ > 0 && d_[0].st.kind == DEST_PRIMARY; }
+
+    void on_sent(int i){ d_[i].st.frames++; }
+    void on_error(int i){ d_[i].st.errors++; }
+
+    // Refresh every rate_hz from the frames sent since the last call.
+    void update_rates(double dt_s);
+
+    // Copy the counters out; returns the number written.
+    int status(SensorDestStatus* out, int max) const;
+
+private:
+    struct Entry {
+        SensorDestStatus st;
+        uint64_t window_start;
+    };
+    bool add(const struct sockaddr_in& a, int kind, int format, const Entry* old, int n_old);
+
+    Entry d_[kSensorDestMax];
+    int n_ = 0;
+    unsigned formats_ = 0;
+};
@@ -0,0 +1,89 @@
+/*
+   MSFS 202x–ArduPilot Bridge - binary sensor packet layout.
+
+   The compact alternative to the JSON sensor frame, for SITL builds and
+   tools that read a fixed binary layout. One UDP datagram per frame, all
+   fields little-endian, no padding:
+
+     off  size  field
+       0     4  magic        SENSOR_PACKET_MAGIC ("APSF")
+       4     2  version      SENSOR_PACKET_VERSION
+       6     2  length       bytes in this packet (>= SENSOR_PACKET_SIZE_V1)
+       8     4  seq          frame counter, +1 per frame sent, wraps
+      12     4  flags        SENSOR_PACKET_F_*
+      16     8  timestamp    double, s (the JSON "timestamp")
+      24    24  lla          double[3]: latitude, longitude (deg), altitude (m)
+      48    24  position     double[3]: N, E, D from the origin (m)
+      72    16  quaternion   float[4]: w, x, y, z, body FRD to NED
+      88    12  velocity     float[3]: N, E, D (m/s)
+     100    12  gyro         float[3]: body rates (rad/s)
+     112    12  accel_body   float[3]: specific force, body FRD (m/s^2)
+     124     4  airspeed     float, m/s
+     128     4  rng_1        float, rangefinder (m)
+     132    48  rc           float[12]: RC inputs 1..12 (PWM us)
+     180        end of version 1
+
+   Fields are the ones the JSON frame carries, with the same units; the
+   JSON option keys become flags. Readers must accept a larger 'length'
+   with the same version (fields appended later) and reject another
+   version. This header is plain C so SITL and tools can include it as
+   is; sensor_packet_decode.c is the reference decoder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#ifndef MSFS_AP_BRIDGE_SENSOR_PACKET_H
+#define MSFS_AP_BRIDGE_SENSOR_PACKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SENSOR_PACKET_MAGIC     0x46535041u     /* "APSF" read as little-endian */
+#define SENSOR_PACKET_VERSION   1
+#define SENSOR_PACKET_SIZE_V1   180
+
+/* flags */
+#define SENSOR_PACKET_F_NO_LOCKSTEP     0x01u   /* JSON "no_lockstep": true */
+#define SENSOR_PACKET_F_NO_TIME_SYNC    0x02u   /* JSON "no_time_sync": true */
+#define SENSOR_PACKET_F_LLA             0x04u   /* lla is the position source (pos_mode 2) */
+
+/* A decoded packet in host byte order. */
+struct sensor_packet {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;
+    uint32_t seq;
+    uint32_t flags;
+    double timestamp;
+    double lla[3];
+    double position[3];
+    float quaternion[4];
+    float velocity[3];
+    float gyro[3];
+    float accel_body[3];
+    float airspeed;
+    float rng_1;
+    float rc[12];
+};
+
+/* sensor_packet_decode() results */
+#define SENSOR_PACKET_OK            0
+#define SENSOR_PACKET_ERR_SHORT    -1   /* fewer bytes than the header or 'length' claims */
+#define SENSOR_PACKET_ERR_MAGIC    -2
+#define SENSOR_PACKET_ERR_VERSION  -3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Decode the 'len' bytes at 'buf' into *out. Works on any host byte
+   order and alignment; returns SENSOR_PACKET_OK or a negative error. */
+int sensor_packet_decode(const void* buf, size_t len, struct sensor_packet* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
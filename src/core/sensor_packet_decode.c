@@ -0,0 +1,78 @@
+/*
+   MSFS 202x–ArduPilot Bridge - reference binary sensor packet decoder.
+
+   Reads every field byte by byte, so it makes no assumption about the
+   host's byte order or the buffer's alignment. Plain C99 with no
+   dependencies beyond the C library: copy it next to sensor_packet.h.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/sensor_packet.h"
+
+#include <string.h>
+
+static uint16_t rd_u16(const uint8_t* p){
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd_u32(const uint8_t* p){
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t rd_u64(const uint8_t* p){
+    return (uint64_t)rd_u32(p) | ((uint64_t)rd_u32(p + 4) << 32);
+}
+
+/* IEEE 754 values travel as their bit patterns. */
+static float rd_f32(const uint8_t* p){
+    uint32_t u = rd_u32(p);
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static double rd_f64(const uint8_t* p){
+    uint64_t u = rd_u64(p);
+    double d;
+    memcpy(&d, &u, sizeof(d));
+    return d;
+}
+
+static void rd_f32s(const uint8_t* p, float* out, int n){
+    int i;
+    for (i = 0; i < n; i++) out[i] = rd_f32(p + 4 * i);
+}
+
+static void rd_f64s(const uint8_t* p, double* out, int n){
+    int i;
+    for (i = 0; i < n; i++) out[i] = rd_f64(p + 8 * i);
+}
+
+int sensor_packet_decode(const void* buf, size_t len, struct sensor_packet* out){
+    const uint8_t* p = (const uint8_t*)buf;
+
+    if (len < 16) return SENSOR_PACKET_ERR_SHORT;
+    out->magic = rd_u32(p);
+    out->version = rd_u16(p + 4);
+    out->length = rd_u16(p + 6);
+    if (out->magic != SENSOR_PACKET_MAGIC) return SENSOR_PACKET_ERR_MAGIC;
+    if (out->version != SENSOR_PACKET_VERSION) return SENSOR_PACKET_ERR_VERSION;
+    if (out->length < SENSOR_PACKET_SIZE_V1 || len < out->length) return SENSOR_PACKET_ERR_SHORT;
+
+    out->seq = rd_u32(p + 8);
+    out->flags = rd_u32(p + 12);
+    out->timestamp = rd_f64(p + 16);
+    rd_f64s(p + 24, out->lla, 3);
+    rd_f64s(p + 48, out->position, 3);
+    rd_f32s(p + 72, out->quaternion, 4);
+    rd_f32s(p + 88, out->velocity, 3);
+    rd_f32s(p + 100, out->gyro, 3);
+    rd_f32s(p + 112, out->accel_body, 3);
+    out->airspeed = rd_f32(p + 124);
+    out->rng_1 = rd_f32(p + 128);
+    rd_f32s(p + 132, out->rc, 12);
+    return SENSOR_PACKET_OK;
+}
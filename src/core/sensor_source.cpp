@@ -0,0 +1,108 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor sources.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/sensor_source.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "core/bridge.h"
+#include "core/sensor_defs.h"
+
+static void split_csv(char* line, std::vector<char*>& out){
+    out.clear();
+    char* p = line;
+    out.push_back(p);
+    for (; *p; p++) {
+        if (*p == ',') { *p = 0; out.push_back(p + 1); }
+        else if (*p == '\r' || *p == '\n') { *p = 0; break; }
+    }
+}
+
+ReplaySource::ReplaySource(const std::string& path, double speed, bool loop)
+: path_(path), speed_(speed), loop_(loop) {}
+
+bool ReplaySource::load(){
+    FILE* f = fopen(path_.c_str(), "r");
+    if (!f) return false;
+
+    samples_.clear();
+    t_ms_.clear();
+
+    // CSV columns are matched by name against the log schema.
+    const SensorRegistry& reg = default_sensor_registry();
+    std::vector<char*> cols;
+    std::vector<int> field_of_col;
+    int time_col = -1;
+    char line[4096];
+
+    if (!fgets(line, sizeof(line), f)) { fclose(f); return false; }
+    split_csv(line, cols);
+    for (size_t c = 0; c < cols.size(); c++) {
+        field_of_col.push_back(reg.find_column(cols[c]));
+        if (!strcmp(cols[c], "utc_ms")) time_col = (int)c;
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        split_csv(line, cols);
+        if (cols.size() < field_of_col.size()) continue;
+
+        RawSensors R{};
+        for (size_t c = 0; c < field_of_col.size(); c++) {
+            if (field_of_col[c] < 0) continue;
+            const double v = strtod(cols[c], nullptr);
+            memcpy((char*)&R + reg[(size_t)field_of_col[c]].offset, &v, sizeof(v));
+        }
+        uint64_t t = (time_col >= 0) ? strtoull(cols[time_col], nullptr, 10) : 0;
+        if (!t_ms_.empty() && t < t_ms_.back()) t = t_ms_.back();
+
+        samples_.push_back(R);
+        t_ms_.push_back(t);
+    }
+    fclose(f);
+    return !samples_.empty();
+}
+
+bool ReplaySource::open(){
+    if (finished_) return false;
+    if (!loaded_) {
+        if (!load()) { finished_ = true; return false; }
+        loaded_ = true;
+    }
+    next_ = 0;
+    start_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool ReplaySource::dispatch(SensorTx& tx){
+    if (next_ >= samples_.size()) {
+        if (loop_) {
+            next_ = 0;
+            start_ = std::chrono::steady_clock::now();
+        } else {
+            finished_ = true;
+            return false;
+        }
+    }
+
+    if (speed_ <= 0.0) {
+        tx.on_sample(samples_[next_++]);
+        samples_sent_++;
+        return true;
+    }
+
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    double replay_ms = (double)t_ms_[0] + elapsed_ms * speed_;
+    while (next_ < samples_.size() && (double)t_ms_[next_] <= replay_ms) {
+        tx.on_sample(samples_[next_++]);
+        samples_sent_++;
+    }
+    return true;
+}
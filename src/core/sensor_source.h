@@ -0,0 +1,107 @@
+/*
+   MSFS 202x–ArduPilot Bridge - sensor sources.
+
+   A SensorSource is whatever produces RawSensors samples for the bridge:
+   the live SimConnect session in the GUI, or a recorded CSV log replayed
+   by the headless runner.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/bridge_types.h"
+#include "core/platform.h"
+
+class SensorTx;
+struct BridgeConfig;
+
+// Producer of sim samples plus the sink for servo outputs going back to
+// the sim. open()/close()/dispatch() mirror sim_open()/sim_close() and the
+// SimConnect_GetNextDispatch loop.
+class SensorSource {
+public:
+    virtual ~SensorSource() = default;
+
+    virtual const char* name() const = 0;
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    // Deliver every pending sample through tx.on_sample(); returns false when
+    // the connection was lost (SimConnect quit, end of a replay).
+    virtual bool dispatch(SensorTx& tx) = 0;
+
+    // True once the source will never produce data again.
+    virtual bool finished() const { return false; }
+
+    // True when the sim loop should not sleep between iterations.
+    virtual bool free_running() const { return false; }
+
+    // Signalled whenever dispatch() has something to deliver. The sim loop
+    // then sleeps on it together with the TX deadline instead of picking
+    // data up on the next pacing tick; nullptr = poll every iteration.
+    virtual WaitEvent* data_event(){ return nullptr; }
+
+    // Take the user's hardware axes away from the sim while SITL drives it.
+    virtual void set_intercept(bool on){ (void)on; }
+
+    // Servo outputs in SimConnect axis units (+-16383), one per channel;
+    // only the channels whose bit is set in 'mask' are due. 'c' is the
+    // sim loop's configuration snapshot for this iteration.
+    virtual void send_axes(const long sim_val[16], uint32_t mask, const BridgeConfig& c){ (void)sim_val; (void)mask; (void)c; }
+};
+
+// Replays the CSV written by the GUI's sensor logger (LogSensorsToFile).
+// speed == 1 follows the recorded timing, speed == N runs N times faster
+// and speed <= 0 feeds one sample per loop iteration as fast as possible.
+class ReplaySource : public SensorSource {
+public:
+    ReplaySource(const std::string& path, double speed, bool loop);
+
+    const char* name() const override { return "Replay"; }
+    bool open() override;
+    void close() override {}
+    bool dispatch(SensorTx& tx) override;
+    bool finished() const override { return finished_; }
+    bool free_running() const override { return speed_ <= 0.0; }
+    void set_intercept(bool on) override { (void)on; intercept_calls_++; }
+    void send_axes(const long sim_val[16], uint32_t mask, const BridgeConfig& c) override {
+        (void)sim_val; (void)c;
+        axes_frames_++;
+        for (; mask; mask &= mask - 1) axis_events_++;
+    }
+
+    size_t sample_count() const { return samples_.size(); }
+    uint64_t samples_sent() const { return samples_sent_; }
+    uint64_t axes_frames() const { return axes_frames_; }
+    uint64_t axis_events() const { return axis_events_; }
+    uint64_t intercept_calls() const { return intercept_calls_; }
+
+private:
+    bool load();
+
+    std::string path_;
+    double speed_;
+    bool loop_;
+
+    std::vector<RawSensors> samples_;
+    std::vector<uint64_t> t_ms_;
+    bool loaded_ = false;
+
+    size_t next_ = 0;
+    std::chrono::steady_clock::time_point start_;
+    std::atomic<bool> finished_{false};
+
+    uint64_t samples_sent_ = 0;
+    uint64_t axes_frames_ = 0;
+    uint64_t axis_events_ = 0;
+    uint64_t intercept_calls_ = 0;
+};
@@ -0,0 +1,74 @@
+/*
+   MSFS 202x–ArduPilot Bridge - single-writer seqlock snapshot.
+
+   Holds the latest value of a small trivially copyable struct (RawSensors).
+   The one writer never waits for readers; readers copy the payload and
+   retry only if a store overlapped the copy. The payload is kept in
+   std::atomic<uint64_t> words, so concurrent copies are race-free in the
+   C++ memory model (no torn-read UB, unlike a memcpy over plain fields).
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "core/platform.h"
+
+template <class T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock(){
+        const T v{};
+        uint64_t w[kWords] = {};
+        memcpy(w, &v, sizeof(T));
+        for (size_t i = 0; i < kWords; i++) data_[i].store(w[i], std::memory_order_relaxed);
+    }
+
+    // Publish a new value. Only one thread may call store().
+    void store(const T& v){
+        uint64_t w[kWords] = {};
+        memcpy(w, &v, sizeof(T));
+
+        const uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; i++) data_[i].store(w[i], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // One attempt at a consistent copy; false when a store overlapped it.
+    bool try_load(T& out) const {
+        const uint64_t s0 = seq_.load(std::memory_order_acquire);
+        if (s0 & 1) return false;
+        uint64_t w[kWords];
+        for (size_t i = 0; i < kWords; i++) w[i] = data_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != s0) return false;
+        memcpy(&out, w, sizeof(T));
+        return true;
+    }
+
+    T load() const {
+        T v;
+        while (!try_load(v)) cpu_relax();
+        return v;
+    }
+
+    // Number of stores so far; lets readers skip work on an unchanged value.
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+    static const size_t kWords = (sizeof(T) + 7) / 8;
+
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> data_[kWords];
+};
@@ -0,0 +1,48 @@
+/*
+   MSFS 202x–ArduPilot Bridge - SITL servo frame sequence accounting.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/servo_seq.h"
+
+ServoSeqVerdict ServoSeqTracker::track(uint32_t frame_count){
+    stats_.received++;
+
+    if (!have_) {
+        have_ = true;
+        newest_ = frame_count;
+        seen_ = 1;
+        return SEQ_NEW;
+    }
+
+    // Wrap-safe distance from the newest frame_count.
+    const int32_t d = (int32_t)(frame_count - newest_);
+
+    if (d > 0) {
+        stats_.dropped += (uint64_t)(d - 1);
+        seen_ = (uint32_t)d < kWindow ? (seen_ << d) | 1 : 1;
+        newest_ = frame_count;
+        return SEQ_NEW;
+    }
+
+    const uint32_t back = (uint32_t)(-(int64_t)d);
+    if (back >= kWindow) {
+        stats_.restarts++;
+        newest_ = frame_count;
+        seen_ = 1;
+        return SEQ_RESTART;
+    }
+
+    const uint64_t bit = 1ull << back;
+    if (seen_ & bit) {
+        stats_.duplicated++;
+        return SEQ_DUPLICATE;
+    }
+    seen_ |= bit;
+    stats_.reordered++;
+    if (stats_.dropped > 0) stats_.dropped--;
+    return SEQ_LATE;
+}
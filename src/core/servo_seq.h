@@ -0,0 +1,58 @@
+/*
+   MSFS 202x–ArduPilot Bridge - SITL servo frame sequence accounting.
+
+   Every SITL servo packet carries frame_count, which SITL bumps once per
+   physics step. ServoSeqTracker follows it across the packets rx_loop
+   receives and sorts each one:
+     - new: ahead of everything seen so far; a jump of n counts n-1 frames
+       as dropped (never received, so far);
+     - duplicate: a frame_count already received (SITL re-sending after a
+       lost reply, or the network duplicating it);
+     - late: a frame_count behind the newest that had not been seen yet;
+       it arrived out of order, so it no longer counts as dropped;
+     - restart: more than kWindow frames behind the newest, which is what
+       a restarted SITL looks like; tracking starts over from it.
+
+   The last kWindow frame_counts are kept in a bit mask, so duplicates and
+   late arrivals are told apart exactly within that window.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+
+struct ServoSeqStats {
+    uint64_t received = 0;          // servo packets tracked
+    uint64_t dropped = 0;           // frame_counts skipped and not (yet) seen
+    uint64_t duplicated = 0;
+    uint64_t reordered = 0;         // late arrivals
+    uint64_t restarts = 0;
+};
+
+enum ServoSeqVerdict { SEQ_NEW=0, SEQ_DUPLICATE=1, SEQ_LATE=2, SEQ_RESTART=3 };
+
+class ServoSeqTracker {
+public:
+    static const uint32_t kWindow = 64;
+
+    // Classify one packet's frame_count and update the counters.
+    ServoSeqVerdict track(uint32_t frame_count);
+
+    // Forget the sequence (new socket); the counters are kept.
+    void reset(){ have_ = false; seen_ = 0; }
+
+    // Newest frame_count tracked; only meaningful after the first packet.
+    uint32_t newest() const { return newest_; }
+
+    const ServoSeqStats& stats() const { return stats_; }
+
+private:
+    bool have_ = false;
+    uint32_t newest_ = 0;
+    uint64_t seen_ = 0;             // bit k: newest_ - k was received
+    ServoSeqStats stats_;
+};
@@ -0,0 +1,87 @@
+/*
+   MSFS 202x–ArduPilot Bridge - shared-memory link layout.
+
+   For a SITL (or a tool) on the same host as the bridge, frames can pass
+   through a memory-mapped file instead of the UDP loopback stack. The
+   bridge creates the file; it holds a header and two latest-frame slots:
+
+     off   size  part
+       0     64  struct shm_link_header
+      64    576  sensor slot: written by the bridge, payload is a binary
+                 sensor packet (sensor_packet.h)
+     640    576  servo slot: written by SITL, payload is the servo packet
+                 SITL would send over UDP (servo_packet_16 or _32)
+    1216         end of version 1
+
+   All fields are host byte order; both ends run on the same machine.
+
+   Each slot is a single-writer seqlock over one frame, never a queue: a
+   reader that falls behind sees the newest frame and loses the ones in
+   between, just as a UDP reader draining to the newest packet would.
+   The bridge counts those gaps from the servo packets' frame_count.
+
+   Writer (one per slot):
+       s = seq;  seq = s + 1;  release fence;
+       copy the payload to data[], set len and t_ns;
+       seq = s + 2 (release store);
+       if (waiters != 0) wake everyone waiting on &seq;
+
+   Reader:
+       s0 = seq (acquire load);  if (s0 is odd) retry;
+       copy len and data[0..len);  acquire fence;
+       if (seq != s0) retry;     the copy is the frame numbered s0 / 2
+
+   To sleep until a new frame, a reader increments 'waiters' (atomic
+   RMW), re-reads seq and, if it still equals the value it last saw,
+   waits on &seq: a FUTEX_WAIT on the shared (not private) futex at that
+   address on Linux; on Windows the named auto-reset event
+   "Local\msfs_ap_bridge_shm_<session>_sensors" or "..._servos", with
+   <session> the header's session in 16 lowercase hex digits. It then
+   decrements 'waiters'. Readers that poll need none of this.
+
+   'session' changes every time the bridge (re)creates the file: readers
+   that see it change reset their view of both slots.
+
+   This header is plain C so SITL and tools can include it as is.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#ifndef MSFS_AP_BRIDGE_SHM_LAYOUT_H
+#define MSFS_AP_BRIDGE_SHM_LAYOUT_H
+
+#include <stdint.h>
+
+#define SHM_LINK_MAGIC      0x4D535041u     /* "APSM" read as little-endian */
+#define SHM_LINK_VERSION    1
+#define SHM_SLOT_DATA_BYTES 512
+#define SHM_SLOT_BYTES      (64 + SHM_SLOT_DATA_BYTES)
+#define SHM_LINK_BYTES      (64 + 2 * SHM_SLOT_BYTES)
+
+enum shm_slot_id { SHM_SLOT_SENSORS = 0, SHM_SLOT_SERVOS = 1 };
+
+struct shm_link_header {
+    uint32_t magic;         /* written last by the bridge, after the slots */
+    uint16_t version;
+    uint16_t header_bytes;  /* 64 */
+    uint32_t total_bytes;   /* SHM_LINK_BYTES */
+    uint32_t slot_bytes;    /* SHM_SLOT_BYTES */
+    uint64_t session;
+    uint32_t slot_off[2];   /* by shm_slot_id */
+    uint32_t bridge_pid;
+    uint8_t reserved[28];
+};
+
+struct shm_slot {
+    uint32_t seq;           /* odd while a write is in progress; futex word */
+    uint32_t waiters;       /* readers asleep (or going to sleep) on seq */
+    uint32_t len;           /* payload bytes in data[] */
+    uint32_t reserved0;
+    uint64_t t_ns;          /* writer's monotonic clock when written, ns */
+    uint8_t reserved[40];
+    uint8_t data[SHM_SLOT_DATA_BYTES];
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*
+   MSFS 202x–ArduPilot Bridge - shared-memory link.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/shm_link.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+#endif
+
+static_assert(sizeof(shm_link_header) == 64, "shm_layout.h header size");
+static_assert(sizeof(shm_slot) == SHM_SLOT_BYTES, "shm_layout.h slot size");
+static_assert(offsetof(shm_slot, t_ns) == 16 && offsetof(shm_slot, data) == 64, "shm_layout.h slot layout");
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "the shared-memory link needs lock-free 32 and 64 bit atomics");
+
+static const size_t kDataWords = SHM_SLOT_DATA_BYTES / 8;
+
+static uint64_t steady_ns(){
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+std::atomic<uint32_t>& ShmLink::word32(int slot, size_t off) const {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(base_ + sizeof(shm_link_header) + (size_t)slot * SHM_SLOT_BYTES + off);
+}
+
+std::atomic<uint64_t>& ShmLink::word64(int slot, size_t off) const {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(base_ + sizeof(shm_link_header) + (size_t)slot * SHM_SLOT_BYTES + off);
+}
+
+bool ShmLink::open(const std::string& path, bool create){
+    close();
+    if (path.empty()) return false;
+
+#ifdef _WIN32
+    wchar_t wpath[MAX_PATH];
+    if (!MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wpath, MAX_PATH)) return false;
+    HANDLE f = CreateFileW(wpath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           nullptr, create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size) || (!create && size.QuadPart < SHM_LINK_BYTES)) { CloseHandle(f); return false; }
+    HANDLE m = CreateFileMappingW(f, nullptr, PAGE_READWRITE, 0, SHM_LINK_BYTES, nullptr);
+    if (!m) { CloseHandle(f); return false; }
+    void* p = MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, SHM_LINK_BYTES);
+    if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+    file_ = f;
+    mapping_ = m;
+    base_ = (uint8_t*)p;
+#else
+    int fd = ::open(path.c_str(), O_RDWR | (create ? O_CREAT : 0), 0666);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if (ok && create && st.st_size < SHM_LINK_BYTES) ok = ftruncate(fd, SHM_LINK_BYTES) == 0;
+    else if (ok && !create) ok = st.st_size >= SHM_LINK_BYTES;
+    void* p = ok ? mmap(nullptr, SHM_LINK_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    base_ = (uint8_t*)p;
+#endif
+    path_ = path;
+
+    std::atomic<uint32_t>& magic = *reinterpret_cast<std::atomic<uint32_t>*>(base_);
+    shm_link_header* h = (shm_link_header*)base_;
+    if (create) {
+        // New session: hide the header, empty both slots through their
+        // seqlocks (so attached readers move on), then publish the header.
+        magic.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int s = 0; s < 2; s++) publish(s, nullptr, 0);
+        h->version = SHM_LINK_VERSION;
+        h->header_bytes = (uint16_t)sizeof(shm_link_header);
+        h->total_bytes = SHM_LINK_BYTES;
+        h->slot_bytes = SHM_SLOT_BYTES;
+        h->session = steady_ns() ^ ((uint64_t)h->session << 17) ^ 0x9E3779B97F4A7C15ull;
+        h->slot_off[SHM_SLOT_SENSORS] = (uint32_t)sizeof(shm_link_header);
+        h->slot_off[SHM_SLOT_SERVOS] = (uint32_t)(sizeof(shm_link_header) + SHM_SLOT_BYTES);
+#ifdef _WIN32
+        h->bridge_pid = (uint32_t)GetCurrentProcessId();
+#else
+        h->bridge_pid = (uint32_t)getpid();
+#endif
+        memset(h->reserved, 0, sizeof(h->reserved));
+        magic.store(SHM_LINK_MAGIC, std::memory_order_release);
+    }
+    else if (magic.load(std::memory_order_acquire) != SHM_LINK_MAGIC || h->version != SHM_LINK_VERSION ||
+             h->total_bytes != SHM_LINK_BYTES) {
+        close();
+        return false;
+    }
+    if (!open_events()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ShmLink::open_events(){
+#ifdef _WIN32
+    static const char* kSlot[2] = { "sensors", "servos" };
+    for (int s = 0; s < 2; s++) {
+        char name[96];
+        snprintf(name, sizeof(name), "Local\\msfs_ap_bridge_shm_%016llx_%s", (unsigned long long)session(), kSlot[s]);
+        event_[s] = CreateEventA(nullptr, FALSE, FALSE, name);
+        if (!event_[s]) return false;
+    }
+#endif
+    return true;
+}
+
+void ShmLink::close(){
+#ifdef _WIN32
+    for (int s = 0; s < 2; s++) {
+        if (event_[s]) CloseHandle((HANDLE)event_[s]);
+        event_[s] = nullptr;
+    }
+    if (base_) UnmapViewOfFile(base_);
+    if (mapping_) CloseHandle((HANDLE)mapping_);
+    if (file_) CloseHandle((HANDLE)file_);
+    mapping_ = file_ = nullptr;
+#else
+    if (base_) munmap(base_, SHM_LINK_BYTES);
+#endif
+    base_ = nullptr;
+    path_.clear();
+}
+
+uint64_t ShmLink::session() const {
+    if (!base_) return 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return ((const shm_link_header*)base_)->session;
+}
+
+void ShmLink::publish(int slot, const void* data, size_t len){
+    if (!base_) return;
+    if (len > SHM_SLOT_DATA_BYTES) len = SHM_SLOT_DATA_BYTES;
+    uint64_t w[kDataWords];
+    if (len) memcpy(w, data, len);
+    const size_t words = (len + 7) / 8;
+    if (len & 7) memset((uint8_t*)w + len, 0, words * 8 - len);
+
+    std::atomic<uint32_t>& seq = word32(slot, offsetof(shm_slot, seq));
+    // Make it even even if an earlier writer died in the middle of a frame.
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    s += s & 1;
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < words; i++) word64(slot, offsetof(shm_slot, data) + i * 8).store(w[i], std::memory_order_relaxed);
+    word32(slot, offsetof(shm_slot, len)).store((uint32_t)len, std::memory_order_relaxed);
+    word64(slot, offsetof(shm_slot, t_ns)).store(steady_ns(), std::memory_order_relaxed);
+    // seq_cst against the reader's waiters increment: either it sees the
+    // new sequence before sleeping or we see it waiting.
+    seq.store(s + 2, std::memory_order_seq_cst);
+    if (word32(slot, offsetof(shm_slot, waiters)).load(std::memory_order_seq_cst) != 0) wake(slot);
+}
+
+int ShmLink::read(int slot, void* out, size_t cap, uint32_t* seen, uint64_t* t_ns) const {
+    if (!base_) return 0;
+    const std::atomic<uint32_t>& seq = word32(slot, offsetof(shm_slot, seq));
+    uint64_t w[kDataWords];
+    // A writer that died mid-frame leaves the sequence odd for good; give
+    // up on this call rather than spin forever.
+    for (int tries = 0; tries < 10000; tries++) {
+        const uint32_t s0 = seq.load(std::memory_order_acquire);
+        if (s0 == *seen) return 0;
+        if (s0 & 1) { std::this_thread::yield(); continue; }
+        uint32_t len = word32(slot, offsetof(shm_slot, len)).load(std::memory_order_relaxed);
+        if (len > SHM_SLOT_DATA_BYTES) len = SHM_SLOT_DATA_BYTES;
+        const size_t words = (len + 7) / 8;
+        for (size_t i = 0; i < words; i++) w[i] = word64(slot, offsetof(shm_slot, data) + i * 8).load(std::memory_order_relaxed);
+        const uint64_t t = word64(slot, offsetof(shm_slot, t_ns)).load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) != s0) continue;
+
+        *seen = s0;
+        if (t_ns) *t_ns = t;
+        if (len > cap) len = (uint32_t)cap;
+        memcpy(out, w, len);
+        return (int)len;
+    }
+    return 0;
+}
+
+void ShmLink::wake(int slot){
+#ifdef _WIN32
+    SetEvent((HANDLE)event_[slot]);
+#elif defined(__linux__)
+    syscall(SYS_futex, (uint32_t*)&word32(slot, offsetof(shm_slot, seq)), FUTEX_WAKE, 0x7fffffff, nullptr, nullptr, 0);
+#else
+    (void)slot;
+#endif
+}
+
+bool ShmLink::wait(int slot, uint32_t seen, int timeout_us){
+    if (!base_) return false;
+    std::atomic<uint32_t>& seq = word32(slot, offsetof(shm_slot, seq));
+    if (seq.load(std::memory_order_acquire) != seen) return true;
+    if (timeout_us <= 0) return false;
+
+    std::atomic<uint32_t>& waiters = word32(slot, offsetof(shm_slot, waiters));
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    // A frame in progress (odd) is not the one we saw either.
+    uint32_t now = seq.load(std::memory_order_seq_cst);
+    if (now == seen) {
+#ifdef _WIN32
+        WaitForSingleObject((HANDLE)event_[slot], (DWORD)((timeout_us + 999) / 1000));
+#elif defined(__linux__)
+        struct timespec ts;
+        ts.tv_sec = timeout_us / 1000000;
+        ts.tv_nsec = (long)(timeout_us % 1000000) * 1000;
+        syscall(SYS_futex, (uint32_t*)&seq, FUTEX_WAIT, seen, &ts, nullptr, 0);
+#else
+        // No cross-process wakeup here: poll.
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_us);
+        while (seq.load(std::memory_order_acquire) == seen && std::chrono::steady_clock::now() < until) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+#endif
+        now = seq.load(std::memory_order_acquire);
+    }
+    waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return now != seen;
+}
@@ -0,0 +1,72 @@
+/*
+   MSFS 202x–ArduPilot Bridge - shared-memory link.
+
+   Maps the file described in shm_layout.h and implements its protocol:
+   publish() and read() are the two ends of a slot's seqlock, wait()
+   sleeps on the slot's futex (Linux) or named event (Windows) until a
+   new frame is published. The bridge opens the file with create = true
+   and writes the sensor slot; a co-located SITL attaches to it and
+   writes the servo slot. Both ends use this same class in the benchmark.
+
+   The slot words are accessed as std::atomic<uint32_t/uint64_t> placed on
+   the mapping; those are lock-free and address-free on every platform we
+   build for, which is what makes them usable across processes.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "core/shm_layout.h"
+
+class ShmLink {
+public:
+    ShmLink() = default;
+    ~ShmLink(){ close(); }
+    ShmLink(const ShmLink&) = delete;
+    ShmLink& operator=(const ShmLink&) = delete;
+
+    // Map 'path'. With create, make the file if needed and start a new
+    // session on it (empty slots); otherwise attach to a file the bridge
+    // has set up, failing while it is missing or not initialized yet.
+    bool open(const std::string& path, bool create);
+    void close();
+
+    bool active() const { return base_ != nullptr; }
+    const std::string& path() const { return path_; }
+    uint64_t session() const;
+
+    // Publish a frame into 'slot' (one writer per slot). Frames longer
+    // than SHM_SLOT_DATA_BYTES are cut.
+    void publish(int slot, const void* data, size_t len);
+
+    // Copy the newest frame of 'slot' when its sequence differs from
+    // *seen, and update *seen. Returns the frame length (at most cap), or
+    // 0 when there is nothing new. t_ns receives the writer's timestamp.
+    int read(int slot, void* out, size_t cap, uint32_t* seen, uint64_t* t_ns = nullptr) const;
+
+    // Sleep until the slot's sequence moves away from 'seen' or for up to
+    // timeout_us. True when it moved.
+    bool wait(int slot, uint32_t seen, int timeout_us);
+
+private:
+    std::atomic<uint32_t>& word32(int slot, size_t off) const;
+    std::atomic<uint64_t>& word64(int slot, size_t off) const;
+    void wake(int slot);
+    bool open_events();
+
+    uint8_t* base_ = nullptr;
+    std::string path_;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+    void* event_[2] = { nullptr, nullptr };
+#endif
+};
@@ -0,0 +1,39 @@
+/*
+   MSFS 202x–ArduPilot Bridge - the slice of SimConnect's data API the core
+   uses.
+
+   Data definitions and requests are built by core code (SurfaceWriter,
+   SensorRequests) through this interface. The GUI binds it to the live
+   session; the benches bind it to recorders, so the definitions can be
+   checked without the sim.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Datum id for fields that are never sent in tagged format.
+static const uint32_t kSimUnusedDatum = 0xFFFFFFFFu;
+
+// Request period: every sim frame or once per second; 'interval' in
+// request_data() skips that many periods between transmissions.
+enum SimPeriod { SIM_PERIOD_FRAME=0, SIM_PERIOD_SECOND=1 };
+
+// Request flags: send only when a value changed; send (datum id, value)
+// pairs instead of the whole definition.
+enum SimRequestFlags { SIM_REQ_CHANGED=1, SIM_REQ_TAGGED=2 };
+
+// All fields are FLOAT64, on the user aircraft.
+class SimDataApi {
+public:
+    virtual ~SimDataApi() = default;
+    virtual bool clear_definition(uint32_t def_id) = 0;
+    virtual bool add_to_definition(uint32_t def_id, const char* simvar, const char* units, uint32_t datum_id) = 0;
+    virtual bool set_data(uint32_t def_id, const double* values, size_t count) = 0;
+    virtual bool request_data(uint32_t req_id, uint32_t def_id, SimPeriod period, uint32_t interval, uint32_t flags) = 0;
+};
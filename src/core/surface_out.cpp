@@ -0,0 +1,76 @@
+/*
+   MSFS 202x–ArduPilot Bridge - servo output through one data definition.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/surface_out.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "core/bridge_types.h"
+
+// AXIS_* events are inverted against the matching position SimVars
+// (-16383 = full right aileron / nose up / right rudder), hence the
+// negative scales. The throttle axis spans 0..100 % over the whole +-16383
+// range; SPOILERS_SET only uses 0..16383.
+const SurfaceVarDef kSurfaceVars[] = {
+    {"AXIS_AILERONS_SET",      "AILERON POSITION",  "position", -1.0 / 16383.0, 0.0, -1.0, 1.0, 1},
+    {"AXIS_ELEVATOR_SET",      "ELEVATOR POSITION", "position", -1.0 / 16383.0, 0.0, -1.0, 1.0, 1},
+    {"AXIS_RUDDER_SET",        "RUDDER POSITION",   "position", -1.0 / 16383.0, 0.0, -1.0, 1.0, 1},
+
+    {"THROTTLE_AXIS_SET_EX1",  "GENERAL ENG THROTTLE LEVER POSITION",   "percent", 50.0 / 16383.0, 50.0, 0.0, 100.0, 4},
+    {"THROTTLE1_AXIS_SET_EX1", "GENERAL ENG THROTTLE LEVER POSITION:1", "percent", 50.0 / 16383.0, 50.0, 0.0, 100.0, 1},
+    {"THROTTLE2_AXIS_SET_EX1", "GENERAL ENG THROTTLE LEVER POSITION:2", "percent", 50.0 / 16383.0, 50.0, 0.0, 100.0, 1},
+    {"THROTTLE3_AXIS_SET_EX1", "GENERAL ENG THROTTLE LEVER POSITION:3", "percent", 50.0 / 16383.0, 50.0, 0.0, 100.0, 1},
+    {"THROTTLE4_AXIS_SET_EX1", "GENERAL ENG THROTTLE LEVER POSITION:4", "percent", 50.0 / 16383.0, 50.0, 0.0, 100.0, 1},
+
+    {"SPOILERS_SET",           "SPOILERS HANDLE POSITION", "percent", 100.0 / 16383.0, 0.0, 0.0, 100.0, 1},
+};
+const size_t kSurfaceVarCount = sizeof(kSurfaceVars) / sizeof(kSurfaceVars[0]);
+
+const SurfaceVarDef* surface_var_for_event(const char* event){
+    if (!event || !*event) return nullptr;
+    for (size_t i = 0; i < kSurfaceVarCount; i++) {
+        if (!strcmp(kSurfaceVars[i].event, event)) return &kSurfaceVars[i];
+    }
+    return nullptr;
+}
+
+uint32_t SurfaceWriter::build(SimDataApi& api, uint32_t def_id, const char* const events[16]){
+    def_id_ = def_id;
+    mask_ = 0;
+    n_ = 0;
+    api.clear_definition(def_id);
+
+    for (int ch = 0; ch < 16; ch++) {
+        const SurfaceVarDef* d = surface_var_for_event(events[ch]);
+        if (!d || n_ + (size_t)d->count > kMaxFields) continue;
+
+        const size_t first = n_;
+        for (int k = 1; k <= d->count; k++) {
+            char name[96];
+            if (d->count > 1) snprintf(name, sizeof(name), "%s:%d", d->simvar, k);
+            else snprintf(name, sizeof(name), "%s", d->simvar);
+            if (!api.add_to_definition(def_id, name, d->units, kSimUnusedDatum)) continue;
+            fields_[n_].ch = ch;
+            fields_[n_].def = d;
+            n_++;
+        }
+        if (n_ > first) mask_ |= 1u << ch;
+    }
+    return mask_;
+}
+
+bool SurfaceWriter::write(SimDataApi& api, const long sim_val[16]){
+    if (n_ == 0) return true;
+    for (size_t i = 0; i < n_; i++) {
+        const SurfaceVarDef& d = *fields_[i].def;
+        values_[i] = clampd(d.offset + d.scale * (double)sim_val[fields_[i].ch], d.lo, d.hi);
+    }
+    writes_++;
+    return api.set_data(def_id_, values_, n_);
+}
@@ -0,0 +1,73 @@
+/*
+   MSFS 202x–ArduPilot Bridge - servo output through one data definition.
+
+   The event output sends each channel as its own client event
+   (AXIS_AILERONS_SET, THROTTLE_AXIS_SET_EX1, ...), one IPC call per
+   channel, and the sim may apply them in different frames. In data output
+   mode every channel whose event has a writable SimVar counterpart in
+   kSurfaceVars goes into a single data definition instead, written with
+   one SimConnect_SetDataOnSimObject call per frame, so all surfaces move
+   together. Channels without a counterpart keep using their event.
+
+   SimConnect is reached through SimDataApi, so the mapping can be
+   exercised against a recorder without the sim.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/sim_data_api.h"
+
+// Servo -> sim output, as stored in the "axis_output" INI key.
+enum AxisOutputMode { AXIS_OUT_EVENTS=0, AXIS_OUT_DATA=1 };
+
+// A writable SimVar standing in for an axis event. The event's value v
+// (sim axis units, +-16383) becomes clamp(offset + scale * v, lo, hi) in
+// 'units'; 'count' > 1 expands 'simvar' to ':1' ... ':count'.
+struct SurfaceVarDef {
+    const char* event;
+    const char* simvar;
+    const char* units;
+    double scale, offset;
+    double lo, hi;
+    int count;
+};
+
+extern const SurfaceVarDef kSurfaceVars[];
+extern const size_t kSurfaceVarCount;
+
+// Row for an event name, or nullptr when the event has no counterpart.
+const SurfaceVarDef* surface_var_for_event(const char* event);
+
+class SurfaceWriter {
+public:
+    static const size_t kMaxFields = 32;
+
+    // (Re)build the definition from the event mapped on each channel (""
+    // or nullptr = none). Returns the channels now written as data.
+    uint32_t build(SimDataApi& api, uint32_t def_id, const char* const events[16]);
+
+    // Fill every field from sim_val and send them in one call. Does
+    // nothing (and returns true) when no channel is mapped.
+    bool write(SimDataApi& api, const long sim_val[16]);
+
+    uint32_t channels() const { return mask_; }
+    size_t fields() const { return n_; }
+    uint64_t writes() const { return writes_; }
+
+private:
+    struct Field { int ch; const SurfaceVarDef* def; };
+
+    uint32_t def_id_ = 0;
+    uint32_t mask_ = 0;
+    size_t n_ = 0;
+    Field fields_[kMaxFields];
+    double values_[kMaxFields];
+    uint64_t writes_ = 0;
+};
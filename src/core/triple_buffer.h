@@ -0,0 +1,50 @@
+/*
+   MSFS 202x–ArduPilot Bridge - single-producer / single-consumer triple
+   buffer.
+
+   The producer fills the back slot and publishes it by swapping it with
+   the middle slot; the consumer swaps the middle slot into the front when
+   it is fresh. Neither side ever waits or allocates, the consumer always
+   sees the newest complete value, and intermediate values are simply
+   overwritten (latest-value semantics, not a queue).
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+template <class T>
+class TripleBuffer {
+public:
+    // Producer: slot to fill, then publish().
+    T& write_slot(){ return buf_[back_]; }
+
+    void publish(){
+        uint8_t prev = mid_.exchange((uint8_t)(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = prev & kIndex;
+    }
+
+    // Consumer: newest published value (a default T before the first one).
+    // The reference stays valid until the next read() on this side.
+    const T& read(){
+        if (mid_.load(std::memory_order_relaxed) & kFresh) {
+            uint8_t prev = mid_.exchange(front_, std::memory_order_acq_rel);
+            front_ = prev & kIndex;
+        }
+        return buf_[front_];
+    }
+
+private:
+    static const uint8_t kIndex = 0x3;
+    static const uint8_t kFresh = 0x4;
+
+    T buf_[3]{};
+    alignas(64) std::atomic<uint8_t> mid_{1};
+    alignas(64) uint8_t back_ = 0;      // producer only
+    alignas(64) uint8_t front_ = 2;     // consumer only
+};
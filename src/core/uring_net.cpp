@@ -0,0 +1,442 @@
+/*
+   MSFS 202x–ArduPilot Bridge - io_uring UDP transport (Linux).
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/uring_net.h"
+
+#ifdef MSFS_AP_BRIDGE_IO_URING
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Ring mappings and the submission state of one io_uring. Each ring is
+// used by one thread only.
+struct UringRing {
+    int fd = -1;
+    unsigned features = 0;
+
+    void* sq_map = nullptr;
+    size_t sq_map_len = 0;
+    void* cq_map = nullptr;
+    size_t cq_map_len = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_len = 0;
+
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0, sq_entries = 0;
+    unsigned sq_local_tail = 0;
+    unsigned pending = 0;           // SQEs filled but not yet submitted
+
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cq_mask = 0;
+
+    // Template for the multishot RECVMSG: only the name and control
+    // lengths are read, and they fix the layout of every buffer.
+    struct msghdr rx_msg;
+};
+
+static int sys_setup(unsigned entries, io_uring_params* p){
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void* arg, size_t argsz){
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static int sys_register(int fd, unsigned op, const void* arg, unsigned nr){
+    return (int)syscall(__NR_io_uring_register, fd, op, arg, nr);
+}
+
+static void ring_destroy(UringRing* r){
+    if (!r) return;
+    if (r->sqes) munmap(r->sqes, r->sqes_len);
+    if (r->cq_map && r->cq_map != r->sq_map) munmap(r->cq_map, r->cq_map_len);
+    if (r->sq_map) munmap(r->sq_map, r->sq_map_len);
+    if (r->fd >= 0) ::close(r->fd);
+    delete r;
+}
+
+// New ring with 'sock' registered as fixed file 0, or nullptr.
+static UringRing* ring_create(unsigned sq_entries, unsigned cq_entries, int sock){
+    io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+    p.cq_entries = cq_entries;
+
+    UringRing* r = new UringRing();
+    r->fd = sys_setup(sq_entries, &p);
+    if (r->fd < 0 && errno == EINVAL) {
+        memset(&p, 0, sizeof(p));
+        p.flags = IORING_SETUP_CQSIZE;
+        p.cq_entries = cq_entries;
+        r->fd = sys_setup(sq_entries, &p);
+    }
+    if (r->fd < 0) { ring_destroy(r); return nullptr; }
+    r->features = p.features;
+
+    r->sq_map_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_map_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (r->cq_map_len > r->sq_map_len) r->sq_map_len = r->cq_map_len;
+        r->cq_map_len = r->sq_map_len;
+    }
+    r->sq_map = mmap(nullptr, r->sq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_map == MAP_FAILED) { r->sq_map = nullptr; ring_destroy(r); return nullptr; }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        r->cq_map = r->sq_map;
+    } else {
+        r->cq_map = mmap(nullptr, r->cq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if (r->cq_map == MAP_FAILED) { r->cq_map = nullptr; ring_destroy(r); return nullptr; }
+    }
+    r->sqes_len = p.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, r->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) { ring_destroy(r); return nullptr; }
+    r->sqes = (io_uring_sqe*)sqes;
+
+    uint8_t* sq = (uint8_t*)r->sq_map;
+    r->sq_head = (unsigned*)(sq + p.sq_off.head);
+    r->sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    r->sq_array = (unsigned*)(sq + p.sq_off.array);
+    r->sq_mask = *(unsigned*)(sq + p.sq_off.ring_mask);
+    r->sq_entries = p.sq_entries;
+    r->sq_local_tail = *r->sq_tail;
+
+    uint8_t* cq = (uint8_t*)r->cq_map;
+    r->cq_head = (unsigned*)(cq + p.cq_off.head);
+    r->cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    r->cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+    r->cq_mask = *(unsigned*)(cq + p.cq_off.ring_mask);
+
+    int fds[1] = { sock };
+    if (sys_register(r->fd, IORING_REGISTER_FILES, fds, 1) < 0) { ring_destroy(r); return nullptr; }
+    return r;
+}
+
+// Zeroed SQE for fixed file 0, or nullptr when the queue is full.
+static io_uring_sqe* ring_get_sqe(UringRing* r){
+    unsigned head = __atomic_load_n(r->sq_head, __ATOMIC_ACQUIRE);
+    if (r->sq_local_tail - head >= r->sq_entries) return nullptr;
+    unsigned idx = r->sq_local_tail & r->sq_mask;
+    io_uring_sqe* sqe = &r->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = 0;
+    sqe->flags = IOSQE_FIXED_FILE;
+    r->sq_array[idx] = idx;
+    r->sq_local_tail++;
+    r->pending++;
+    return sqe;
+}
+
+// Hand the pending SQEs to the kernel, optionally waiting for
+// min_complete completions (up to timeout_ms when >= 0). Returns the
+// syscall result; -1 with errno ETIME on timeout.
+static int ring_enter(UringRing* r, unsigned min_complete, int timeout_ms, UringStats& stats){
+    __atomic_store_n(r->sq_tail, r->sq_local_tail, __ATOMIC_RELEASE);
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    const void* arg = nullptr;
+    size_t argsz = 0;
+
+    __kernel_timespec ts;
+    io_uring_getevents_arg ext;
+    if (min_complete && timeout_ms >= 0 && (r->features & IORING_FEAT_EXT_ARG)) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+        memset(&ext, 0, sizeof(ext));
+        ext.sigmask_sz = _NSIG / 8;
+        ext.ts = (uint64_t)(uintptr_t)&ts;
+        flags |= IORING_ENTER_EXT_ARG;
+        arg = &ext;
+        argsz = sizeof(ext);
+    }
+    const unsigned n = r->pending;
+    int ret = sys_enter(r->fd, n, min_complete, flags, arg, argsz);
+    stats.enters++;
+    if (ret >= 0) r->pending -= (unsigned)ret < n ? (unsigned)ret : n;
+    return ret;
+}
+
+// Pop the next completion into 'out'.
+static bool ring_pop(UringRing* r, io_uring_cqe* out){
+    unsigned head = *r->cq_head;
+    if (head == __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE)) return false;
+    *out = r->cqes[head & r->cq_mask];
+    __atomic_store_n(r->cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool ring_has_cqe(UringRing* r){
+    return *r->cq_head != __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+}
+
+// ---- TX ------------------------------------------------------------------
+
+namespace {
+struct TxSlot {
+    struct msghdr msg;
+    struct iovec iov;
+    struct sockaddr_in addr;
+    uint32_t tag;
+    uint8_t data[UringUdpTx::kSlotBytes];
+};
+}
+
+bool UringUdpTx::open(socket_t s){
+    close();
+    if (s == kInvalidSocket) return false;
+    ring_ = ring_create(kSlots, kSlots * 2, s);
+    if (!ring_) return false;
+
+    TxSlot* slots = new TxSlot[kSlots];
+    memset(slots, 0, sizeof(TxSlot) * kSlots);
+    for (unsigned i = 0; i < kSlots; i++) {
+        slots[i].iov.iov_base = slots[i].data;
+        slots[i].msg.msg_name = &slots[i].addr;
+        slots[i].msg.msg_namelen = sizeof(slots[i].addr);
+        slots[i].msg.msg_iov = &slots[i].iov;
+        slots[i].msg.msg_iovlen = 1;
+        free_[i] = kSlots - 1 - i;
+    }
+    n_free_ = kSlots;
+    arena_ = (uint8_t*)slots;
+    sendmsg_ = false;
+    failed_ = 0;
+    return true;
+}
+
+void UringUdpTx::close(){
+    // Give sends still in flight a moment to complete before their slots
+    // are freed; whatever is left is cancelled with the ring.
+    for (int i = 0; ring_ && n_free_ < kSlots && i < 10; i++) {
+        ring_enter(ring_, 1, 10, stats_);
+        reap(false);
+    }
+    ring_destroy(ring_);
+    ring_ = nullptr;
+    delete[] (TxSlot*)arena_;
+    arena_ = nullptr;
+    n_free_ = 0;
+}
+
+void UringUdpTx::reap(bool wait){
+    if (wait && ring_enter(ring_, 1, -1, stats_) < 0 && errno != EINTR) {
+        stats_.errors++;
+        return;
+    }
+    TxSlot* slots = (TxSlot*)arena_;
+    io_uring_cqe cqe;
+    while (ring_pop(ring_, &cqe)) {
+        if (cqe.user_data >= kSlots) continue;
+        const unsigned k = (unsigned)cqe.user_data;
+        // Kernels before 6.0 reject a SEND that names its destination.
+        if (cqe.res == -EINVAL && !sendmsg_) sendmsg_ = true;
+        if (cqe.res < 0) {
+            stats_.errors++;
+            failed_ |= 1u << (slots[k].tag & 31);
+        }
+        else stats_.packets++;
+        free_[n_free_++] = k;
+    }
+}
+
+int UringUdpTx::send_batch(const UdpMsg* msgs, int n){
+    if (!ring_) return 0;
+    reap(false);
+
+    TxSlot* slots = (TxSlot*)arena_;
+    int queued = 0;
+    int i = 0;
+    for (; i < n; i++) {
+        const UdpMsg& m = msgs[i];
+        if (!m.dest || m.dest->sin_family != AF_INET || m.dest->sin_port == 0 ||
+            m.len <= 0 || (unsigned)m.len > kSlotBytes) {
+            failed_ |= 1u << (m.tag & 31);
+            continue;
+        }
+
+        if (n_free_ == 0) {
+            if (ring_->pending) ring_enter(ring_, 0, -1, stats_);
+            reap(true);
+            if (n_free_ == 0) break;
+        }
+        io_uring_sqe* sqe = ring_get_sqe(ring_);
+        if (!sqe) break;
+
+        const unsigned k = free_[--n_free_];
+        TxSlot& s = slots[k];
+        memcpy(s.data, m.buf, (size_t)m.len);
+        s.iov.iov_len = (size_t)m.len;
+        s.addr = *m.dest;
+        s.tag = m.tag;
+        if (sendmsg_) {
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->addr = (uint64_t)(uintptr_t)&s.msg;
+            sqe->len = 1;
+        } else {
+            // SEND with a destination address skips the msghdr copy-in.
+            sqe->opcode = IORING_OP_SEND;
+            sqe->addr = (uint64_t)(uintptr_t)s.data;
+            sqe->len = (unsigned)m.len;
+            sqe->addr2 = (uint64_t)(uintptr_t)&s.addr;
+            sqe->addr_len = sizeof(s.addr);
+        }
+        sqe->user_data = k;
+        queued++;
+    }
+    for (; i < n; i++) failed_ |= 1u << (msgs[i].tag & 31);
+    if (ring_->pending && ring_enter(ring_, 0, -1, stats_) < 0) stats_.errors++;
+    return queued;
+}
+
+// ---- RX ------------------------------------------------------------------
+
+// user_data of the PROVIDE_BUFFERS requests, told apart from the receive.
+static const uint64_t kProvideTag = ~0ull;
+
+bool UringUdpRx::open(socket_t s){
+    close();
+    if (s == kInvalidSocket) return false;
+    // Room for returning every buffer plus the receive itself; every
+    // completion holds a buffer, so the CQ cannot overflow.
+    ring_ = ring_create(kBuffers * 2, kBuffers * 4, s);
+    if (!ring_) return false;
+    if (!(ring_->features & IORING_FEAT_EXT_ARG)) { close(); return false; }
+
+    bufs_ = (uint8_t*)malloc((size_t)kBuffers * kBufferBytes);
+    if (!bufs_) { close(); return false; }
+    if (!provide(0, kBuffers)) { close(); return false; }
+
+    memset(&ring_->rx_msg, 0, sizeof(ring_->rx_msg));
+    ring_->rx_msg.msg_namelen = sizeof(struct sockaddr_in);
+    if (!arm()) { close(); return false; }
+    return true;
+}
+
+void UringUdpRx::close(){
+    // Closing the ring cancels the multishot receive before the buffers go.
+    ring_destroy(ring_);
+    ring_ = nullptr;
+    free(bufs_);
+    bufs_ = nullptr;
+    armed_ = false;
+}
+
+// Hand buffers [bid, bid + n) to the kernel's buffer group 0. Queued
+// only; they go in with the next io_uring_enter().
+bool UringUdpRx::provide(unsigned bid, unsigned n){
+    io_uring_sqe* sqe = ring_get_sqe(ring_);
+    if (!sqe) {
+        ring_enter(ring_, 0, -1, stats_);
+        sqe = ring_get_sqe(ring_);
+        if (!sqe) return false;
+    }
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->flags = (ring_->features & IORING_FEAT_CQE_SKIP) ? IOSQE_CQE_SKIP_SUCCESS : 0;
+    sqe->fd = (int)n;
+    sqe->addr = (uint64_t)(uintptr_t)(bufs_ + (size_t)bid * kBufferBytes);
+    sqe->len = kBufferBytes;
+    sqe->off = bid;
+    sqe->buf_group = 0;
+    sqe->user_data = kProvideTag;
+    return true;
+}
+
+bool UringUdpRx::arm(){
+    io_uring_sqe* sqe = ring_get_sqe(ring_);
+    if (!sqe) {
+        ring_enter(ring_, 0, -1, stats_);
+        sqe = ring_get_sqe(ring_);
+        if (!sqe) return false;
+    }
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->addr = (uint64_t)(uintptr_t)&ring_->rx_msg;
+    sqe->len = 1;
+    sqe->buf_group = 0;
+    sqe->user_data = 0;
+    if (ring_enter(ring_, 0, -1, stats_) < 0) return false;
+    armed_ = true;
+    return true;
+}
+
+int UringUdpRx::wait(int timeout_ms){
+    if (!ring_) return -1;
+    if (ring_has_cqe(ring_)) return 1;
+    // A multishot receive ends when it runs out of buffers; the drained
+    // ones are queued for return by now, so start a new one.
+    if (!armed_ && !arm()) return -1;
+    if (ring_enter(ring_, 1, timeout_ms, stats_) < 0 && errno != ETIME && errno != EINTR) return -1;
+    return ring_has_cqe(ring_) ? 1 : 0;
+}
+
+int UringUdpRx::recv(uint8_t* out, int cap, struct sockaddr_in* from_addr){
+    if (!ring_) return 0;
+    io_uring_cqe cqe;
+    while (ring_pop(ring_, &cqe)) {
+        if (cqe.user_data == kProvideTag) {
+            if (cqe.res < 0) stats_.errors++;
+            continue;
+        }
+        if (!(cqe.flags & IORING_CQE_F_MORE)) armed_ = false;
+        if (cqe.res < 0) {
+            if (cqe.res != -ENOBUFS) stats_.errors++;
+            continue;
+        }
+        if (!(cqe.flags & IORING_CQE_F_BUFFER)) continue;
+
+        const unsigned bid = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+        if (bid >= kBuffers) continue;
+        uint8_t* b = bufs_ + (size_t)bid * kBufferBytes;
+
+        // Buffer layout: io_uring_recvmsg_out, the source address, the
+        // (empty) control data, then the payload.
+        const io_uring_recvmsg_out* o = (const io_uring_recvmsg_out*)b;
+        const size_t hdr = sizeof(*o) + ring_->rx_msg.msg_namelen + ring_->rx_msg.msg_controllen;
+        if ((size_t)cqe.res < hdr) { provide(bid, 1); continue; }
+        size_t len = o->payloadlen;
+        if (len > (size_t)cqe.res - hdr) len = (size_t)cqe.res - hdr;
+        if (len == 0) { provide(bid, 1); continue; }
+
+        if (from_addr) {
+            memset(from_addr, 0, sizeof(*from_addr));
+            if (o->namelen >= sizeof(struct sockaddr_in)) memcpy(from_addr, b + sizeof(*o), sizeof(*from_addr));
+        }
+        if (len > (size_t)cap) len = (size_t)cap;
+        memcpy(out, b + hdr, len);
+        provide(bid, 1);
+        stats_.packets++;
+        return (int)len;
+    }
+    return 0;
+}
+
+#else
+
+bool UringUdpTx::open(socket_t){ return false; }
+void UringUdpTx::close(){}
+void UringUdpTx::reap(bool){}
+int UringUdpTx::send_batch(const UdpMsg*, int){ return 0; }
+
+bool UringUdpRx::open(socket_t){ return false; }
+void UringUdpRx::close(){}
+bool UringUdpRx::arm(){ return false; }
+bool UringUdpRx::provide(unsigned, unsigned){ return false; }
+int UringUdpRx::wait(int){ return -1; }
+int UringUdpRx::recv(uint8_t*, int, struct sockaddr_in*){ return 0; }
+
+#endif
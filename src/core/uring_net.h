@@ -0,0 +1,119 @@
+/*
+   MSFS 202x–ArduPilot Bridge - io_uring UDP transport (Linux).
+
+   The socket path costs one sendto()/recvfrom() system call per packet.
+   On Linux the bridge can instead drive its two UDP sockets through an
+   io_uring:
+     - UringUdpTx copies outgoing frames into a preallocated slot arena and
+       queues one send per frame, so the frames for every destination go
+       out with a single io_uring_enter();
+     - UringUdpRx hands a pool of receive buffers to the kernel up front
+       and arms one multishot RECVMSG on the servo socket that keeps
+       filling them, so any number of queued packets costs one wait;
+       drained buffers go back with the next submission.
+   Both register their socket as a fixed file, and each must stay on the
+   thread that opened it.
+
+   The kernel interface is used directly (no liburing). When the kernel
+   lacks a feature, or a sandbox refuses io_uring_setup(), open() returns
+   false and the caller stays on the plain socket calls. Builds without
+   MSFS_AP_BRIDGE_IO_URING (Windows, non-Linux, old headers) get the same
+   classes with an open() that always fails.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/net.h"
+
+// Network backend, as stored in the "net_backend" INI key.
+enum NetBackend { NET_SOCKETS=0, NET_IO_URING=1 };
+
+struct UringStats {
+    uint64_t packets = 0;           // sent or received
+    uint64_t enters = 0;            // io_uring_enter() calls
+    uint64_t errors = 0;            // failed completions
+};
+
+struct UringRing;
+
+class UringUdpTx {
+public:
+    static const unsigned kSlots = 64;
+    static const unsigned kSlotBytes = 4096;
+
+    UringUdpTx() = default;
+    ~UringUdpTx(){ close(); }
+    UringUdpTx(const UringUdpTx&) = delete;
+    UringUdpTx& operator=(const UringUdpTx&) = delete;
+
+    // Attach to an open UDP socket (which stays owned by the caller).
+    bool open(socket_t s);
+    void close();
+    bool active() const { return ring_ != nullptr; }
+
+    // Queue every message and submit them together. Waits for a free slot
+    // only when all kSlots are still in flight. Returns the messages
+    // queued (n, unless one is larger than kSlotBytes or the ring fails).
+    int send_batch(const UdpMsg* msgs, int n);
+
+    // Tags of the messages that failed since the last call, one bit per
+    // tag: refused by send_batch() or completed with an error. Completions
+    // arrive later, so a failure may show up a batch or two after its send.
+    uint32_t take_failed(){ uint32_t f = failed_; failed_ = 0; return f; }
+
+    const UringStats& stats() const { return stats_; }
+
+private:
+    void reap(bool wait);
+
+    UringRing* ring_ = nullptr;
+    uint8_t* arena_ = nullptr;      // slots: msghdr, iovec, address, payload
+    unsigned free_[kSlots];
+    unsigned n_free_ = 0;
+    bool sendmsg_ = false;          // SEND with an address was refused
+    uint32_t failed_ = 0;
+    UringStats stats_;
+};
+
+class UringUdpRx {
+public:
+    static const unsigned kBuffers = 64;
+    static const unsigned kBufferBytes = 2048;
+
+    UringUdpRx() = default;
+    ~UringUdpRx(){ close(); }
+    UringUdpRx(const UringUdpRx&) = delete;
+    UringUdpRx& operator=(const UringUdpRx&) = delete;
+
+    // Attach to a bound UDP socket (which stays owned by the caller) and
+    // start receiving.
+    bool open(socket_t s);
+    void close();
+    bool active() const { return ring_ != nullptr; }
+
+    // Wait up to timeout_ms for a packet. Returns 1 when one is ready, 0
+    // on timeout, -1 when the ring failed.
+    int wait(int timeout_ms);
+
+    // Next received packet, like UdpRxRaw::recv(): its length (truncated
+    // to cap), or 0 when none is left. Never blocks.
+    int recv(uint8_t* out, int cap, struct sockaddr_in* from_addr);
+
+    const UringStats& stats() const { return stats_; }
+
+private:
+    bool arm();
+    bool provide(unsigned bid, unsigned n);
+
+    UringRing* ring_ = nullptr;
+    uint8_t* bufs_ = nullptr;
+    bool armed_ = false;
+    UringStats stats_;
+};
@@ -0,0 +1,123 @@
+/*
+   MSFS 202x–ArduPilot Bridge - multi-vehicle worker pool.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include "core/vehicle_pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "core/platform.h"
+
+struct VehiclePool::Vehicle {
+    Shared& S;
+    SensorSource& src;
+    const BridgeHooks& hooks;
+    // Built on the worker thread, which then owns their sockets and rings.
+    std::unique_ptr<SimLoop> sim;
+    std::unique_ptr<ServoRx> rx;
+    bool done = false;
+
+    Vehicle(Shared& s, SensorSource& source, const BridgeHooks& h) : S(s), src(source), hooks(h) {}
+};
+
+VehiclePool::VehiclePool() = default;
+VehiclePool::~VehiclePool(){ stop(); }
+
+void VehiclePool::add(Shared& S, SensorSource& src, const BridgeHooks& hooks){
+    vehicles_.emplace_back(new Vehicle(S, src, hooks));
+}
+
+void VehiclePool::start(int workers, int first_cpu){
+    stop();
+    if (vehicles_.empty()) return;
+    if (workers <= 0) workers = (int)std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, vehicles());
+
+    run_ = true;
+    finished_ = 0;
+    for (int i = 0; i < workers; i++) {
+        threads_.emplace_back(&VehiclePool::worker, this, i, workers, first_cpu >= 0 ? first_cpu + i : -1);
+    }
+}
+
+void VehiclePool::stop(){
+    run_ = false;
+    for (auto& t : threads_) t.join();
+    threads_.clear();
+}
+
+PoolStats VehiclePool::stats() const {
+    PoolStats s;
+    s.passes = passes_.load(std::memory_order_relaxed);
+    s.sleeps = sleeps_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void VehiclePool::worker(int index, int stride, int cpu){
+    typedef std::chrono::steady_clock Clock;
+    if (cpu >= 0) pin_current_thread(cpu);
+
+    std::vector<Vehicle*> mine;
+    for (size_t i = (size_t)index; i < vehicles_.size(); i += (size_t)stride) {
+        Vehicle* v = vehicles_[i].get();
+        v->sim.reset(new SimLoop(v->S, v->hooks, v->src));
+        v->rx.reset(new ServoRx(v->S, v->hooks));
+        v->done = false;
+        mine.push_back(v);
+    }
+
+    std::vector<socket_t> socks;
+    socks.reserve(mine.size());
+    size_t live = mine.size();
+    uint64_t passes = 0, sleeps = 0;
+
+    while (run_ && live > 0) {
+        // Setting changes, retries and shutdown are noticed within 20 ms.
+        Clock::time_point next = Clock::now() + std::chrono::milliseconds(20);
+        bool busy = false;
+        socks.clear();
+
+        for (Vehicle* v : mine) {
+            if (v->done) continue;
+            v->rx->poll(0);
+            if (!v->sim->step()) {
+                v->done = true;
+                live--;
+                finished_++;
+                continue;
+            }
+            v->sim->serve();
+            busy = busy || v->sim->free_running();
+            next = std::min(next, v->sim->next_deadline());
+            socks.push_back(v->rx->handle());
+        }
+        // Published every 256 passes, before the busy check so a worker
+        // kept busy by a free-running source still reports.
+        if ((++passes & 255) == 0) {
+            passes_.fetch_add(256, std::memory_order_relaxed);
+            sleeps_.fetch_add(sleeps, std::memory_order_relaxed);
+            sleeps = 0;
+        }
+        if (busy) continue;
+
+        const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(next - Clock::now()).count();
+        if (wait > 0) {
+            wait_any_readable(socks.data(), (int)socks.size(), (int)wait);
+            sleeps++;
+        }
+    }
+    passes_.fetch_add(passes & 255, std::memory_order_relaxed);
+    sleeps_.fetch_add(sleeps, std::memory_order_relaxed);
+
+    for (Vehicle* v : mine) {
+        v->sim->close();
+        v->rx->close();
+        v->sim.reset();
+        v->rx.reset();
+    }
+}
@@ -0,0 +1,74 @@
+/*
+   MSFS 202x–ArduPilot Bridge - multi-vehicle worker pool.
+
+   Every bridged vehicle has its own Shared (ports, origin, configuration,
+   sensor and servo state) and its own SensorSource, paired with its own
+   SITL instance. sim_loop() and rx_loop() give a vehicle two threads; for
+   a swarm, VehiclePool runs the same SimLoop and ServoRx stages on a few
+   worker threads instead. Vehicles are dealt round robin to the workers.
+   A worker passes over its vehicles (take queued servo packets, dispatch
+   the source, send what is due, answer lockstep steps), then sleeps until
+   the earliest TX deadline among them or until one of their servo
+   sockets turns readable.
+
+   Pooled vehicles are paced by that shared sleep rather than TxPacer's
+   spin, so a frame can leave a timer tick late. A free-running source
+   keeps its worker from sleeping at all. With the io_uring servo receive
+   or the shared-memory link, servo frames do not wake the worker and are
+   taken on the next pass.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+
+struct PoolStats {
+    uint64_t passes = 0;            // passes over a worker's vehicles
+    uint64_t sleeps = 0;            // waits between passes
+};
+
+class VehiclePool {
+public:
+    VehiclePool();
+    ~VehiclePool();
+    VehiclePool(const VehiclePool&) = delete;
+    VehiclePool& operator=(const VehiclePool&) = delete;
+
+    // Add a vehicle before start(). S, src and hooks must outlive the pool.
+    void add(Shared& S, SensorSource& src, const BridgeHooks& hooks);
+
+    // Start 'workers' threads (<= 0: one per core), never more than there
+    // are vehicles. Worker i is pinned to CPU first_cpu + i when first_cpu
+    // is not negative.
+    void start(int workers, int first_cpu = -1);
+
+    // Stop and join the workers; every vehicle is closed.
+    void stop();
+
+    int vehicles() const { return (int)vehicles_.size(); }
+    int workers() const { return (int)threads_.size(); }
+    // True once every vehicle's source has finished.
+    bool finished() const { return finished_.load() == vehicles(); }
+
+    PoolStats stats() const;
+
+private:
+    struct Vehicle;
+    void worker(int index, int stride, int cpu);
+
+    std::vector<std::unique_ptr<Vehicle>> vehicles_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> run_{false};
+    std::atomic<int> finished_{0};
+    std::atomic<uint64_t> passes_{0}, sleeps_{0};
+};
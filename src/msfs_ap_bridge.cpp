@@ -46,11 +46,6 @@
 #include <eh.h>
 #include <clocale>
 
-static inline uint64_t _now_ms() {
-    using namespace std::chrono;
-    return (uint64_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
-}
-
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windows.h>
@@ -60,6 +55,12 @@ static inline uint64_t _now_ms() {
 #include <commdlg.h>
 #include "resource.h"
 
+#include "core/bridge.h"
+#include "core/net.h"
+#include "core/platform.h"
+#include "core/sensor_defs.h"
+#include "core/sensor_source.h"
+
 #pragma comment(lib,"Ws2_32.lib")
 #pragma comment(lib,"User32.lib")
 #pragma comment(lib,"Gdi32.lib")
@@ -186,14 +187,6 @@ static HFONT g_uiFont = NULL;
 static HFONT g_uiFontBold = NULL;
 static HFONT g_hudFont = NULL;
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-static inline double deg2rad(double deg) { return deg * (M_PI / 180.0); }
-static inline double ft2m(double ft) { return ft * 0.3048; }
-static inline double kt2ms(double kt) { return kt * 0.514444; }
-
 static int Dpi(HWND h){
     HMODULE hUser32 = LoadLibraryW(L"User32.dll");
 
@@ -237,138 +230,12 @@ static void ApplyUIFont(HWND parent){
     }, 0);
 }
 
-#ifndef SIO_UDP_CONNRESET
-#define IOC_IN  0x80000000
-#define IOC_VENDOR 0x18000000
-#define _WSAIOW(x,y) (IOC_IN|(x)|(y))
-#define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR,12)
-#endif
-
-// RAII helper to initialize and shut down WinSock2.
-struct WsaInit {
-    WsaInit(){ WSADATA w; WSAStartup(MAKEWORD(2,2), &w); }
-    ~WsaInit(){ WSACleanup(); }
-} static g_wsa;
-
-static inline double clampd(double v,double lo,double hi){ return v<lo?lo:(v>hi?hi:v); }
-template<typename T>
-static inline T iclamp(T v, T lo, T hi){ return v<lo?lo:(v>hi?hi:v); }
-
-#pragma pack(push,1)
-
-// Compact UDP packet carrying 16 PWM servo channels.
-struct servo_packet_16 {
-    uint16_t magic = 18458;
-    uint16_t frame_rate;
-    uint32_t frame_count;
-    uint16_t pwm[16];
-};
-static_assert(sizeof(servo_packet_16) == (4 + 4 + 16*2), "servo_packet_16 size mismatch");
-
-// Compact UDP packet carrying 32 PWM servo channels.
-struct servo_packet_32 {
-    uint16_t magic = 29569;
-    uint16_t frame_rate;
-    uint32_t frame_count;
-    uint16_t pwm[32];
-};
-static_assert(sizeof(servo_packet_32) == (4 + 4 + 32*2), "servo_packet_32 size mismatch");
-
-#pragma pack(pop)
-
-// Configuration of the remote SITL endpoint (IP and ports).
-struct Dest {
-    std::string ip="127.0.0.1";
-    uint16_t port_tx=9003;
-    uint16_t port_rx=9002;
-};
-
-static void disable_connreset(SOCKET s){
-    DWORD bytes=0; BOOL b=FALSE;
-    WSAIoctl(s, SIO_UDP_CONNRESET, &b, sizeof(b), NULL, 0, &bytes, NULL, NULL);
-}
-
-static std::mutex g_sitl_addr_mtx;
-static struct sockaddr_in g_sitl_addr = {};
-static bool g_sitl_addr_known = false;
-
-// Thin wrapper around a UDP socket used for transmitting packets.
-class UdpTx {
-public:
-
-    bool open(const std::string& ip, uint16_t port){
-        close();
-        sock_ = socket(AF_INET,SOCK_DGRAM,IPPROTO_UDP);
-        if(sock_==INVALID_SOCKET) return false;
-        disable_connreset(sock_);
-
-        ip_ = "stateless"; port_ = 0;
-        return true;
-    }
-    void close(){ if(sock_!=INVALID_SOCKET){ closesocket(sock_); sock_=INVALID_SOCKET; } }
-    bool needs_reopen(const std::string& ip, uint16_t port) const {
-
-        return ip!=ip_ || port!=port_;
-    }
-
-    bool send_buffer(const char* buf, int len, const struct sockaddr_in* dest){
-        if(sock_==INVALID_SOCKET) return false;
-        if (dest == nullptr || dest->sin_family != AF_INET || dest->sin_port == 0) return false;
-        int sent = sendto(sock_, buf, len, 0, (const sockaddr*)dest, sizeof(struct sockaddr_in));
-        return sent == len;
-    }
-
-    ~UdpTx(){ close(); }
-private:
-    SOCKET sock_=INVALID_SOCKET;
-    sockaddr_in addr_{};
-    std::string ip_="";
-    uint16_t port_=0;
-};
-
-// Thin wrapper around a UDP socket used for receiving raw packets.
-class UdpRxRaw {
-public:
-
-    bool open(uint16_t port){
-        close();
-        sock_ = socket(AF_INET,SOCK_DGRAM,IPPROTO_UDP);
-        if(sock_==INVALID_SOCKET) return false;
-        disable_connreset(sock_);
-        sockaddr_in a{};
-        a.sin_family=AF_INET;
-        a.sin_port=htons(port);
-        a.sin_addr.s_addr=INADDR_ANY;
-        if(bind(sock_,(sockaddr*)&a,sizeof(a))==SOCKET_ERROR){ close(); return false; }
-        DWORD to=10;
-        setsockopt(sock_,SOL_SOCKET,SO_RCVTIMEO,(const char*)&to,sizeof(to));
-        port_=port;
-        return true;
-    }
-    void close(){ if(sock_!=INVALID_SOCKET){ closesocket(sock_); sock_=INVALID_SOCKET; } }
-    bool needs_reopen(uint16_t port) const { return port!=port_; }
-
-    int recv(uint8_t* out, int cap, struct sockaddr_in* from_addr){
-        if(sock_==INVALID_SOCKET) return -1;
-
-        int fromlen = sizeof(struct sockaddr_in);
-        int len = recvfrom(sock_, (char*)out, cap, 0, (sockaddr*)from_addr, (socklen_t*)&fromlen);
-
-        if(len==SOCKET_ERROR){
-            int e=WSAGetLastError();
-            if(e==WSAETIMEDOUT) return 0;
-            return -1;
-        }
-        return len;
-    }
-    ~UdpRxRaw(){ close(); }
-private:
-    SOCKET sock_=INVALID_SOCKET;
-    uint16_t port_=0;
-};
+// Brings WinSock2 up for the lifetime of the process.
+static NetInit g_net;
 
-enum DEF_ID { DEF_SENSORS=1 };
-enum REQ_ID { REQ_SENSORS=1 };
+// SensorRequests uses DEF_SENSORS/REQ_SENSORS and the id after each.
+enum DEF_ID { DEF_SENSORS=1, DEF_SENSORS_SLOW=2, DEF_SURFACES=3 };
+enum REQ_ID { REQ_SENSORS=1, REQ_SENSORS_SLOW=2 };
 
 enum EVT_ID {
     EVT_AIL=1, EVT_ELE, EVT_RUD, EVT_THR,
@@ -385,23 +252,6 @@ enum EVT_ID {
 
 enum GRP_ID { GRP_INTERCEPT = 1 };
 
-// Sensor snapshot populated from SimConnect for the current aircraft state.
-struct RawSensors {
-    double lat_deg=0, lon_deg=0;
-    double alt_msl_ft=0, alt_agl_ft=0;
-    double pitch_deg=0, bank_deg=0, hdg_true_deg=0;
-    double ias_kt=0;
-    double vel_e_fps=0, vel_n_fps=0, vel_u_fps=0;
-    double p_rads=0, q_rads=0, r_rads=0;
-    double accel_x_fps2=0, accel_y_fps2=0, accel_z_fps2=0;
-    double engine_rpm=0, prop_rpm=0, prop_pitch_rad=0;
-    double radio_height_ft=0, ground_alt_ft=0;
-
-    double N_m=0, E_m=0, U_m=0;
-
-    bool valid=false;
-};
-
 static HANDLE gSim=nullptr;
 
 static const int g_sim_evt_map[16] = {
@@ -411,34 +261,36 @@ static const int g_sim_evt_map[16] = {
     EVT_AUX9, EVT_AUX10, EVT_AUX11, EVT_AUX12
 };
 
+// SimDataApi over the live session: FLOAT64 fields on the user aircraft.
+class SimConnectDataApi : public SimDataApi {
+public:
+    bool clear_definition(uint32_t def_id) override {
+        return SUCCEEDED(SimConnect_ClearDataDefinition(gSim, def_id));
+    }
+    bool add_to_definition(uint32_t def_id, const char* simvar, const char* units, uint32_t datum_id) override {
+        return SUCCEEDED(SimConnect_AddToDataDefinition(gSim, def_id, simvar, units, SIMCONNECT_DATATYPE_FLOAT64, 0.0f,
+        datum_id == kSimUnusedDatum ? SIMCONNECT_UNUSED : (DWORD)datum_id));
+    }
+    bool set_data(uint32_t def_id, const double* values, size_t count) override {
+        return SUCCEEDED(SimConnect_SetDataOnSimObject(gSim, def_id, SIMCONNECT_OBJECT_ID_USER, 0, 0,
+        (DWORD)(count * sizeof(double)), (void*)values));
+    }
+    bool request_data(uint32_t req_id, uint32_t def_id, SimPeriod period, uint32_t interval, uint32_t flags) override {
+        SIMCONNECT_DATA_REQUEST_FLAG f = SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT;
+        if (flags & SIM_REQ_CHANGED) f |= SIMCONNECT_DATA_REQUEST_FLAG_CHANGED;
+        if (flags & SIM_REQ_TAGGED) f |= SIMCONNECT_DATA_REQUEST_FLAG_TAGGED;
+        return SUCCEEDED(SimConnect_RequestDataOnSimObject(gSim, req_id, def_id, SIMCONNECT_OBJECT_ID_USER,
+        period == SIM_PERIOD_SECOND ? SIMCONNECT_PERIOD_SECOND : SIMCONNECT_PERIOD_SIM_FRAME, f, 0, interval, 0));
+    }
+};
+
 // Open a SimConnect session and subscribe to live aircraft sensor data.
-static bool sim_open(){
-    if(SimConnect_Open(&gSim, APP_TITLE_A, nullptr, 0, 0, 0)!=S_OK) return false;
-
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PLANE LATITUDE","degrees",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 0);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PLANE LONGITUDE","degrees",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 1);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PLANE ALTITUDE","feet",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 2);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PLANE ALT ABOVE GROUND","feet",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 3);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PLANE PITCH DEGREES","degrees",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 4);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PLANE BANK DEGREES","degrees",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 5);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PLANE HEADING DEGREES TRUE","degrees",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 6);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "AIRSPEED INDICATED","knots",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 7);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "VELOCITY WORLD X","feet per second",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 8);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "VELOCITY WORLD Z","feet per second",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 9);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "VELOCITY WORLD Y","feet per second",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 10);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "ROTATION VELOCITY BODY X","radians per second",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 11);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "ROTATION VELOCITY BODY Y","radians per second",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 12);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "ROTATION VELOCITY BODY Z","radians per second",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 13);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "ACCELERATION BODY X","feet per second squared",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 14);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "ACCELERATION BODY Y","feet per second squared",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 15);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "ACCELERATION BODY Z","feet per second squared",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 16);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "GENERAL ENG RPM:1","rpm",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 17);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PROP RPM:1","rpm",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 18);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "PROP BETA:1","radians",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 19);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "RADIO HEIGHT","feet",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 20);
-    SimConnect_AddToDataDefinition(gSim, DEF_SENSORS, "GROUND ALTITUDE","feet",SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 21);
-
-    SimConnect_RequestDataOnSimObject(gSim, REQ_SENSORS, DEF_SENSORS, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME, SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT, 0,0,0);
+// SimConnect signals 'data_event' (if any) whenever messages are waiting.
+static bool sim_open(SensorRequests& sensors, HANDLE data_event){
+    if(SimConnect_Open(&gSim, APP_TITLE_A, nullptr, 0, data_event, 0)!=S_OK) return false;
+
+    SimConnectDataApi api;
+    sensors.open(api, g_sensor_reg, DEF_SENSORS, REQ_SENSORS, G.cfg.acquire()->sensor_slow_frames);
 
     for (int i = 0; i < 16; i++) {
         SimConnect_MapClientEventToSimEvent(gSim, g_sim_evt_map[i], get_sim_evt_by_idx(G_sim_evt_idx[i]));
@@ -539,14 +391,6 @@ static void sim_close(){ if(gSim){ SimConnect_Close(gSim); gSim=nullptr; }}
 #define IDC_SITL_OUT_REV_LBL1 6106
 #define IDC_SITL_OUT_REV_LBL2 6107
 
-// Last PWM frame received from SITL plus basic timing metadata.
-struct PWMLast{
-    uint16_t rate_hz=0;
-    uint32_t frame=0;
-    std::vector<uint16_t> pwm;
-    std::chrono::steady_clock::time_point tlast{};
-};
-
 static const wchar_t* AXIS_SRC_NAMES[] = {
     L"Axis 1 (X)", L"Axis 2 (Y)", L"Axis 3 (Z)",
     L"Axis 4 (Rx)", L"Axis 5 (Ry)", L"Axis 6 (Rz)",
@@ -571,47 +415,18 @@ struct JoyMapCfg {
     int overrideMode = 0;
 };
 
-// Shared state between GUI, SimConnect, joystick and networking threads.
-struct Shared {
-    bool invsim_ch[16]{};
-
-    std::mutex m_tx;
-    Dest dest{};
-    int rate_hz=1000;
-    bool match_sim_rate=false;
-    int resample_mode=0;
-    double sim_dt_ms=33.3;
-    bool use_time_sync=true;
-    bool no_lockstep=false;
-    int json_pos_mode=0;
-
-    bool sim_origin_set = true;
-
-    double sim_origin_lat = -35.363261;
-    double sim_origin_lon = 149.165230;
-    double sim_origin_alt_m = 584.0;
-    double sim_earth_radius = 6378137.0;
-
+// GUI-side state layered on top of the core bridge state.
+struct AppState : Shared {
     int joy_index=0;
     double deadzone=0.02;
 
     JoyMapCfg joy_map[NUM_JOY_AXES];
 
-    RawSensors R{};
-
-    std::mutex m_rx;
-    PWMLast pwm{};
-
-    std::mutex m_gui;
     double raw_axes[NUM_JOY_AXES]{0};
     bool raw_buttons[8]{};
-    double rc_out[12]{};
 
-    double sitl_out_pwm[16]{};
-    bool sitl_has_ch[16]{};
     int win_x = CW_USEDEFAULT, win_y = CW_USEDEFAULT;
     int win_w = 780, win_h = 740;
-    std::atomic<bool> joy_ok{false};
 
     std::atomic<bool> status_sim_ok{false};
     std::atomic<bool> status_tx_ok{false};
@@ -622,36 +437,36 @@ struct Shared {
 
 } static G;
 
+// Joystick settings as seen by joy_thread; published with the bridge config.
+struct JoyConfig {
+    uint64_t version = 0;
+    int joy_index = 0;
+    JoyMapCfg joy_map[NUM_JOY_AXES];
+};
+static RcuCell<JoyConfig> g_joy_cfg;
+
+// Hand the edited settings to the sim, RX and joystick threads as fresh
+// immutable snapshots. Call after every change to the fields above.
+static void PublishConfig(){
+    BridgeConfig c = snapshot_config(G);
+    JoyConfig j;
+    {
+        std::lock_guard<std::mutex> lk(G.m_tx);
+        for (int i = 0; i < 16; i++) c.axis_evt[i] = G_sim_evt_idx[i];
+        j.joy_index = G.joy_index;
+        for (int i = 0; i < NUM_JOY_AXES; i++) j.joy_map[i] = G.joy_map[i];
+    }
+    G.cfg.publish(c);
+    g_joy_cfg.publish(j);
+}
+
 static HWND g_simDbgPopup = NULL;
 static const wchar_t* kSimDbgPopupClass = L"MSFS_AP_BRIDGE_SIMDBG_POPUP";
 
-struct SimField { const wchar_t* name; const wchar_t* unit; };
-static const SimField kSimFields[] = {
-    { L"Latitude",           L"deg"     },
-    { L"Longitude",          L"deg"     },
-    { L"Alt MSL",            L"ft"      },
-    { L"Alt AGL",            L"ft"      },
-    { L"Pitch",              L"deg"     },
-    { L"Bank",               L"deg"     },
-    { L"Heading True",       L"deg"     },
-    { L"Airspeed Indicated", L"kt"      },
-    { L"Vel East",           L"ft/s"    },
-    { L"Vel North",          L"ft/s"    },
-    { L"Vel Up",             L"ft/s"    },
-    { L"p (roll rate)",      L"rad/s"   },
-    { L"q (pitch rate)",     L"rad/s"   },
-    { L"r (yaw rate)",       L"rad/s"   },
-    { L"Accel X",            L"ft/s^2"  },
-    { L"Accel Y",            L"ft/s^2"  },
-    { L"Accel Z",            L"ft/s^2"  },
-    { L"Engine RPM",         L"rpm"     },
-    { L"Prop RPM",           L"rpm"     },
-    { L"Prop Beta",          L"rad"     },
-    { L"Radio Height",       L"ft"      },
-    { L"Ground Alt",         L"ft"      },
-    { L"Valid",              L""        },
-};
-static const int kSimFieldCount = (int)(sizeof(kSimFields)/sizeof(kSimFields[0]));
+// Sensor SimVars: built-in rows plus the INI's [sensors] extraN entries,
+// read once at startup (the sim thread keeps pointers into it).
+static SensorRegistry g_sensor_reg;
+static std::wstring g_sensor_extra_spec[kSensorExtraMax];
 
 static void InitSimDbgList(HWND lv){
     if (!lv) return;
@@ -661,42 +476,32 @@ static void InitSimDbgList(HWND lv){
     col.pszText = const_cast<wchar_t*>(L"Key"); col.cx = S(160); col.iSubItem=0; ListView_InsertColumn(lv, 0, &col);
     col.pszText = const_cast<wchar_t*>(L"Value"); col.cx = S(140); col.iSubItem=1; ListView_InsertColumn(lv, 1, &col);
     col.pszText = const_cast<wchar_t*>(L"Unit"); col.cx = S(80); col.iSubItem=2; ListView_InsertColumn(lv, 2, &col);
-    for(int i=0;i<kSimFieldCount;i++){
+    const int rows = (int)g_sensor_reg.size();
+    for(int i=0;i<=rows;i++){
+        wchar_t name[128] = L"Valid", unit[64] = L"";
+        if (i < rows) {
+            MultiByteToWideChar(CP_UTF8, 0, g_sensor_reg[i].label, -1, name, 128);
+            MultiByteToWideChar(CP_UTF8, 0, g_sensor_reg[i].display_units, -1, unit, 64);
+        }
         LVITEMW it{};
-        it.mask = LVIF_TEXT; it.iItem=i; it.iSubItem=0; it.pszText=const_cast<wchar_t*>(kSimFields[i].name);
+        it.mask = LVIF_TEXT; it.iItem=i; it.iSubItem=0; it.pszText=name;
         ListView_InsertItem(lv, &it);
-        ListView_SetItemText(lv, i, 2, const_cast<wchar_t*>(kSimFields[i].unit));
+        ListView_SetItemText(lv, i, 2, unit);
     }
 }
 
 static void UpdateSimDbgValues(){
     if (!g_lvSimDbg) return;
-    RawSensors R{};
-    { std::lock_guard<std::mutex> lk(G.m_tx); R = G.R; }
+    RawSensors R = G.R.load();
     wchar_t b[128];
-    swprintf(b,128,L"%.6f", R.lat_deg);           ListView_SetItemText(g_lvSimDbg,  0,1,b);
-    swprintf(b,128,L"%.6f", R.lon_deg);           ListView_SetItemText(g_lvSimDbg,  1,1,b);
-    swprintf(b,128,L"%.1f", R.alt_msl_ft);        ListView_SetItemText(g_lvSimDbg,  2,1,b);
-    swprintf(b,128,L"%.1f", R.alt_agl_ft);        ListView_SetItemText(g_lvSimDbg,  3,1,b);
-    swprintf(b,128,L"%.2f", R.pitch_deg);         ListView_SetItemText(g_lvSimDbg,  4,1,b);
-    swprintf(b,128,L"%.2f", R.bank_deg);          ListView_SetItemText(g_lvSimDbg,  5,1,b);
-    swprintf(b,128,L"%.2f", R.hdg_true_deg);      ListView_SetItemText(g_lvSimDbg,  6,1,b);
-    swprintf(b,128,L"%.1f", R.ias_kt);            ListView_SetItemText(g_lvSimDbg,  7,1,b);
-    swprintf(b,128,L"%.2f", R.vel_e_fps);         ListView_SetItemText(g_lvSimDbg,  8,1,b);
-    swprintf(b,128,L"%.2f", R.vel_n_fps);         ListView_SetItemText(g_lvSimDbg,  9,1,b);
-    swprintf(b,128,L"%.2f", R.vel_u_fps);         ListView_SetItemText(g_lvSimDbg, 10,1,b);
-    swprintf(b,128,L"%.3f", R.p_rads);            ListView_SetItemText(g_lvSimDbg, 11,1,b);
-    swprintf(b,128,L"%.3f", R.q_rads);            ListView_SetItemText(g_lvSimDbg, 12,1,b);
-    swprintf(b,128,L"%.3f", R.r_rads);            ListView_SetItemText(g_lvSimDbg, 13,1,b);
-    swprintf(b,128,L"%.2f", R.accel_x_fps2);      ListView_SetItemText(g_lvSimDbg, 14,1,b);
-    swprintf(b,128,L"%.2f", R.accel_y_fps2);      ListView_SetItemText(g_lvSimDbg, 15,1,b);
-    swprintf(b,128,L"%.2f", R.accel_z_fps2);      ListView_SetItemText(g_lvSimDbg, 16,1,b);
-    swprintf(b,128,L"%.0f", R.engine_rpm);        ListView_SetItemText(g_lvSimDbg, 17,1,b);
-    swprintf(b,128,L"%.0f", R.prop_rpm);          ListView_SetItemText(g_lvSimDbg, 18,1,b);
-    swprintf(b,128,L"%.3f", R.prop_pitch_rad);    ListView_SetItemText(g_lvSimDbg, 19,1,b);
-    swprintf(b,128,L"%.1f", R.radio_height_ft);   ListView_SetItemText(g_lvSimDbg, 20,1,b);
-    swprintf(b,128,L"%.1f", R.ground_alt_ft);     ListView_SetItemText(g_lvSimDbg, 21,1,b);
-    ListView_SetItemText(g_lvSimDbg, 22,1, const_cast<wchar_t*>(R.valid?L"YES":L"NO"));
+    const int rows = (int)g_sensor_reg.size();
+    for(int i=0;i<rows;i++){
+        const SensorVarDef& d = g_sensor_reg[i];
+        double v; memcpy(&v, (const char*)&R + d.offset, sizeof(v));
+        swprintf(b,128,L"%.*f", d.precision, v);
+        ListView_SetItemText(g_lvSimDbg, i,1,b);
+    }
+    ListView_SetItemText(g_lvSimDbg, rows,1, const_cast<wchar_t*>(R.valid?L"YES":L"NO"));
 }
 
 // Window procedure for the popup that shows raw SimConnect sensor values.
@@ -795,8 +600,7 @@ static LRESULT CALLBACK HudWndProc(HWND h, UINT m, WPARAM w, LPARAM l) {
             FillRect(hdcMem, &rc, hBrBlack);
             DeleteObject(hBrBlack);
 
-            RawSensors R{};
-            { std::lock_guard<std::mutex> lk(G.m_tx); R = G.R; }
+            RawSensors R = G.R.load();
 
             HBRUSH hBrSky1 = CreateSolidBrush(RGB(0, 76, 153));
             HBRUSH hBrSky2 = CreateSolidBrush(RGB(51, 127, 204));
@@ -1155,11 +959,7 @@ static LRESULT CALLBACK HudWndProc(HWND h, UINT m, WPARAM w, LPARAM l) {
             pt.x = x;
             pt.y = y;
             if (PtInRect(&rcLatLon, pt)) {
-                RawSensors R;
-                {
-                    std::lock_guard<std::mutex> lk(G.m_tx);
-                    R = G.R;
-                }
+                RawSensors R = G.R.load();
 
                 wchar_t buf[64];
                 swprintf(buf, _countof(buf), L"%.6f, %.6f", R.lat_deg, R.lon_deg);
@@ -1240,7 +1040,6 @@ static std::vector<GUID>    g_joystickGUIDs;
 static int                  g_selectedJoyIndex = -1;
 
 static std::atomic<bool> RUN{true};
-static std::atomic<bool> g_sim_ok{false};
 
 static std::wstring g_ini_path;
 static std::atomic<bool> g_logging_enabled{false};
@@ -1266,7 +1065,9 @@ static void OpenLogFile(void){
     g_log_file = _wfopen(path.c_str(), L"w");
 
     if (g_log_file){
-        fwprintf(g_log_file, L"utc_ms,utc_iso,local_iso,lat_deg,lon_deg,alt_msl_ft,alt_agl_ft,pitch_deg,bank_deg,hdg_true_deg,ias_kt,vel_e_fps,vel_n_fps,vel_u_fps,p_rads,q_rads,r_rads,accel_x_fps2,accel_y_fps2,accel_z_fps2,engine_rpm,prop_rpm,prop_pitch_rad,radio_height_ft,ground_alt_ft,valid,ch1_cmd,ch2_cmd,ch3_cmd,ch4_cmd\n");
+        char cols[2048];
+        g_sensor_reg.csv_header(cols, sizeof(cols));
+        fwprintf(g_log_file, L"utc_ms,utc_iso,local_iso%hs,valid,ch1_cmd,ch2_cmd,ch3_cmd,ch4_cmd\n", cols);
         fflush(g_log_file);
     }
 }
@@ -1301,20 +1102,13 @@ static void LogSensorsToFile(const RawSensors& R){
         if (G.sitl_has_ch[3]) ch_cmd[3] = G.sitl_out_pwm[3];
     }
 
-    fwprintf(g_log_file, L"%llu,%ls,%ls,%.10f,%.10f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.5f,%.5f,%.5f,%.6f,%.6f,%.6f,%.5f,%.5f,%.5f,%.2f,%.2f,%.6f,%.4f,%.4f,%d,%.6f,%.6f,%.6f,%.6f\n", now_ms, utc_iso, local_iso,
-    R.lat_deg, R.lon_deg,
-    R.alt_msl_ft, R.alt_agl_ft,
-    R.pitch_deg, R.bank_deg, R.hdg_true_deg, R.ias_kt,
-    R.vel_e_fps, R.vel_n_fps, R.vel_u_fps,
-    R.p_rads, R.q_rads, R.r_rads,
-    R.accel_x_fps2, R.accel_y_fps2, R.accel_z_fps2,
-    R.engine_rpm, R.prop_rpm, R.prop_pitch_rad,
-    R.radio_height_ft, R.ground_alt_ft,
+    char vals[2048];
+    g_sensor_reg.csv_row(R, vals, sizeof(vals));
+    fwprintf(g_log_file, L"%llu,%ls,%ls%hs,%d,%.6f,%.6f,%.6f,%.6f\n", now_ms, utc_iso, local_iso, vals,
     (int)(R.valid ? 1 : 0),
     ch_cmd[0], ch_cmd[1], ch_cmd[2], ch_cmd[3]);
     fflush(g_log_file);
 }
-static std::atomic<uint64_t> g_next_log_ms{0};
 
 static std::wstring get_ini_path(){
     wchar_t mod[MAX_PATH];
@@ -1359,13 +1153,70 @@ static void load_settings_from_path(const std::wstring& path){
         wchar_t wres[64];
 
         if(GetPrivateProfileStringW(L"bridge",L"resample",L"off",wres,64,path.c_str())>0){
-            if(!_wcsicmp(wres,L"off")) G.resample_mode=0; else if(!_wcsicmp(wres,L"zoh")) G.resample_mode=1; else if(!_wcsicmp(wres,L"linear")) G.resample_mode=2;
+            if(!_wcsicmp(wres,L"off")) G.resample_mode=0; else if(!_wcsicmp(wres,L"zoh")) G.resample_mode=1; else if(!_wcsicmp(wres,L"linear")) G.resample_mode=2; else if(!_wcsicmp(wres,L"cubic")) G.resample_mode=3;
         }
     }
 
     G.use_time_sync = GetPrivateProfileIntW(L"bridge", L"use_time_sync", G.use_time_sync?1:0, path.c_str()) != 0;
     G.no_lockstep = GetPrivateProfileIntW(L"bridge", L"no_lockstep", G.no_lockstep?1:0, path.c_str()) != 0;
+    G.lockstep_tx = GetPrivateProfileIntW(L"bridge", L"lockstep_tx", G.lockstep_tx?1:0, path.c_str()) != 0;
+    G.tx_spin_us = GetPrivateProfileIntW(L"bridge", L"tx_spin_us", G.tx_spin_us, path.c_str());
+    G.predict_ms = GetPrivateProfileIntW(L"bridge", L"predict_ms", G.predict_ms, path.c_str());
+    G.axis_deadband = GetPrivateProfileIntW(L"bridge", L"axis_deadband", G.axis_deadband, path.c_str());
+    G.axis_keepalive_ms = GetPrivateProfileIntW(L"bridge", L"axis_keepalive_ms", G.axis_keepalive_ms, path.c_str());
+    G.axis_frame_align = GetPrivateProfileIntW(L"bridge", L"axis_frame_align", G.axis_frame_align?1:0, path.c_str()) != 0;
+    G.sensor_slow_frames = GetPrivateProfileIntW(L"bridge", L"sensor_slow_frames", G.sensor_slow_frames, path.c_str());
+    {
+        wchar_t wdis[64];
+        if(GetPrivateProfileStringW(L"bridge",L"sim_dispatch",L"event",wdis,64,path.c_str())>0){
+            G.sim_event_dispatch = _wcsicmp(wdis,L"poll") != 0;
+        }
+    }
+    {
+        wchar_t wsrx[64];
+        if(GetPrivateProfileStringW(L"bridge",L"servo_rx",L"drain",wsrx,64,path.c_str())>0){
+            G.servo_rx_drain = _wcsicmp(wsrx,L"single") != 0;
+        }
+    }
+    {
+        wchar_t wlis[1024];
+        char t[1024];
+        GetPrivateProfileStringW(L"bridge",L"listeners",L"",wlis,1024,path.c_str());
+        WideCharToMultiByte(CP_UTF8,0,wlis,-1,t,1024,NULL,NULL);
+        G.sensor_listeners = t;
+    }
+    G.sitl_shadows = GetPrivateProfileIntW(L"bridge", L"sitl_shadows", G.sitl_shadows?1:0, path.c_str()) != 0;
+    {
+        wchar_t wfmt[64];
+        if(GetPrivateProfileStringW(L"bridge",L"sitl_format",L"json",wfmt,64,path.c_str())>0){
+            G.sitl_format = _wcsicmp(wfmt,L"binary") ? FRAME_JSON : FRAME_BINARY;
+        }
+    }
+    {
+        wchar_t wshm[MAX_PATH];
+        char t[MAX_PATH * 3];
+        GetPrivateProfileStringW(L"bridge",L"shm_path",L"",wshm,MAX_PATH,path.c_str());
+        WideCharToMultiByte(CP_UTF8,0,wshm,-1,t,(int)sizeof(t),NULL,NULL);
+        G.shm_path = t;
+    }
+    {
+        wchar_t wout[64];
+        if(GetPrivateProfileStringW(L"bridge",L"axis_output",L"events",wout,64,path.c_str())>0){
+            G.axis_output = _wcsicmp(wout,L"data") ? AXIS_OUT_EVENTS : AXIS_OUT_DATA;
+        }
+    }
+    {
+        wchar_t werr[64];
+        if (GetPrivateProfileStringW(L"bridge", L"predict_max_err_m", L"", werr, 64, path.c_str()) > 0)
+            G.predict_max_err_m = _wtof(werr);
+    }
     G.json_pos_mode = GetPrivateProfileIntW(L"bridge", L"pos_mode", G.json_pos_mode, path.c_str());
+    {
+        wchar_t wgeo[64];
+        if(GetPrivateProfileStringW(L"bridge",L"geodesy",L"wgs84",wgeo,64,path.c_str())>0){
+            G.geodesy_mode = _wcsicmp(wgeo,L"flat") ? GEODESY_WGS84 : GEODESY_FLAT;
+        }
+    }
 
     G.joy_index    = GetPrivateProfileIntW(L"bridge",L"joy_index",G.joy_index,path.c_str());
 
@@ -1440,10 +1291,17 @@ static void load_settings_from_path(const std::wstring& path){
         }
     }
 
+    PublishConfig();
 }
 
 static void save_settings_to_path(const std::wstring& path){
 
+    for (int i = 0; i < g_sensor_reg.extras(); i++) {
+        wchar_t key[32];
+        swprintf(key, 32, L"extra%d", i + 1);
+        WritePrivateProfileStringW(L"sensors", key, g_sensor_extra_spec[i].c_str(), path.c_str());
+    }
+
     for (int i = 0; i < 16; i++) {
         wchar_t key_inv[64], b[8];
         swprintf(key_inv, 64, L"invert_sim_ch%d", i + 1);
@@ -1466,7 +1324,7 @@ static void save_settings_to_path(const std::wstring& path){
     wsprintfW(b,L"%d",G.rate_hz); WritePrivateProfileStringW(L"bridge",L"rate",b,path.c_str());
     WritePrivateProfileStringW(L"bridge", L"match_sim_rate", (G.match_sim_rate?L"1":L"0"), path.c_str());
     {
-        const wchar_t* mode = L"Off"; if(G.resample_mode==1) mode=L"Zoh"; else if(G.resample_mode==2) mode=L"Linear";
+        const wchar_t* mode = L"Off"; if(G.resample_mode==1) mode=L"Zoh"; else if(G.resample_mode==2) mode=L"Linear"; else if(G.resample_mode==3) mode=L"Cubic";
         WritePrivateProfileStringW(L"bridge", L"resample", mode, path.c_str());
     }
 
@@ -1474,8 +1332,39 @@ static void save_settings_to_path(const std::wstring& path){
     WritePrivateProfileStringW(L"bridge", L"use_time_sync", b, path.c_str());
     wsprintfW(b, L"%d", G.no_lockstep ? 1 : 0);
     WritePrivateProfileStringW(L"bridge", L"no_lockstep", b, path.c_str());
+    wsprintfW(b, L"%d", G.lockstep_tx ? 1 : 0);
+    WritePrivateProfileStringW(L"bridge", L"lockstep_tx", b, path.c_str());
+    wsprintfW(b, L"%d", G.tx_spin_us);
+    WritePrivateProfileStringW(L"bridge", L"tx_spin_us", b, path.c_str());
+    wsprintfW(b, L"%d", G.predict_ms);
+    WritePrivateProfileStringW(L"bridge", L"predict_ms", b, path.c_str());
+    swprintf(b, 64, L"%.3f", G.predict_max_err_m);
+    WritePrivateProfileStringW(L"bridge", L"predict_max_err_m", b, path.c_str());
+    wsprintfW(b, L"%d", G.axis_deadband);
+    WritePrivateProfileStringW(L"bridge", L"axis_deadband", b, path.c_str());
+    wsprintfW(b, L"%d", G.axis_keepalive_ms);
+    WritePrivateProfileStringW(L"bridge", L"axis_keepalive_ms", b, path.c_str());
+    wsprintfW(b, L"%d", G.axis_frame_align ? 1 : 0);
+    WritePrivateProfileStringW(L"bridge", L"axis_frame_align", b, path.c_str());
+    wsprintfW(b, L"%d", G.sensor_slow_frames);
+    WritePrivateProfileStringW(L"bridge", L"sensor_slow_frames", b, path.c_str());
+    WritePrivateProfileStringW(L"bridge", L"sim_dispatch", (G.sim_event_dispatch ? L"Event" : L"Poll"), path.c_str());
+    WritePrivateProfileStringW(L"bridge", L"servo_rx", (G.servo_rx_drain ? L"Drain" : L"Single"), path.c_str());
+    {
+        wchar_t wlis[1024]; MultiByteToWideChar(CP_UTF8,0,G.sensor_listeners.c_str(),-1,wlis,1024);
+        WritePrivateProfileStringW(L"bridge", L"listeners", wlis, path.c_str());
+    }
+    wsprintfW(b, L"%d", G.sitl_shadows ? 1 : 0);
+    WritePrivateProfileStringW(L"bridge", L"sitl_shadows", b, path.c_str());
+    WritePrivateProfileStringW(L"bridge", L"sitl_format", (G.sitl_format == FRAME_BINARY ? L"Binary" : L"Json"), path.c_str());
+    {
+        wchar_t wshm[MAX_PATH]; MultiByteToWideChar(CP_UTF8,0,G.shm_path.c_str(),-1,wshm,MAX_PATH);
+        WritePrivateProfileStringW(L"bridge", L"shm_path", wshm, path.c_str());
+    }
+    WritePrivateProfileStringW(L"bridge", L"axis_output", (G.axis_output == AXIS_OUT_DATA ? L"Data" : L"Events"), path.c_str());
     wsprintfW(b, L"%d", G.json_pos_mode);
     WritePrivateProfileStringW(L"bridge", L"pos_mode", b, path.c_str());
+    WritePrivateProfileStringW(L"bridge", L"geodesy", (G.geodesy_mode == GEODESY_FLAT ? L"Flat" : L"WGS84"), path.c_str());
 
     wsprintfW(b,L"%d",G.joy_index); WritePrivateProfileStringW(L"bridge",L"joy_index",b,path.c_str());
 
@@ -1617,6 +1506,7 @@ static void enumerate_joysticks(HWND cb){
         SendMessageW(cb, CB_SETCURSEL, 0, 0);
         G.joy_index = 0;
     }
+    PublishConfig();
 }
 
 static BOOL CALLBACK DIEnumDeviceObjectsCallback(LPCDIDEVICEOBJECTINSTANCE lpddoi, LPVOID pvRef) {
@@ -2047,6 +1937,7 @@ static void UpdateUIFromGlobals() {
     if(sel_idx == -1 && g_joystickGUIDs.size() > 0) {
         SendMessageW(g_joycb, CB_SETCURSEL, 0, 0);
         G.joy_index = (int)SendMessageW(g_joycb, CB_GETITEMDATA, 0, 0);
+        PublishConfig();
     }
 }
 
@@ -2149,6 +2040,8 @@ static void ApplyChanges(UINT code, UINT id, HWND hCtl) {
             G.joy_map[idx].srcInv = (SendMessageW(hCtl, BM_GETCHECK,0,0)==BST_CHECKED) ? -1 : +1;
         }
     }
+
+    PublishConfig();
 }
 
 static LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l){
@@ -2246,6 +2139,7 @@ static LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l){
             SendMessageW(g_resample_cb, CB_ADDSTRING, 0, (LPARAM)L"Off");
             SendMessageW(g_resample_cb, CB_ADDSTRING, 0, (LPARAM)L"Zoh");
             SendMessageW(g_resample_cb, CB_ADDSTRING, 0, (LPARAM)L"Linear");
+            SendMessageW(g_resample_cb, CB_ADDSTRING, 0, (LPARAM)L"Cubic");
             SendMessageW(g_resample_cb, CB_SETCURSEL, (WPARAM)G.resample_mode, 0);
 
             CreateWindowExW(0,L"STATIC",L"Pos. Format:",WS_CHILD|WS_VISIBLE,
@@ -2459,8 +2353,14 @@ static LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l){
             G.status_tx_ok.store(ok);
             G.status_tx_rate.store(rate);
             SetLedColor(g_led_tx, ok);
+            int dests;
+            {
+                std::lock_guard<std::mutex> lk(G.m_gui);
+                dests = G.dest_status_n;
+            }
             wchar_t buf[128];
-            if (ok) swprintf(buf, 128, L"Sensors TX: OK (%.0f Hz)", rate);
+            if (ok && dests > 1) swprintf(buf, 128, L"Sensors TX: OK (%.0f Hz, %d destinations)", rate, dests);
+            else if (ok) swprintf(buf, 128, L"Sensors TX: OK (%.0f Hz)", rate);
             else swprintf(buf, 128, L"Sensors TX: ---");
             SetWindowTextW(g_lbl_tx_status, buf);
             return 0;
@@ -2474,7 +2374,10 @@ static LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l){
             G.status_rx_rate.store(rate);
             SetLedColor(g_led_rx, ok);
             wchar_t buf[128];
-            if (ok) swprintf(buf, 128, L"Servo RX: OK (%.0f Hz)", rate);
+            if (ok) swprintf(buf, 128, L"Servo RX: OK (%.0f Hz, %llu lost, %llu dup, %llu late)", rate,
+                             (unsigned long long)G.rx_stats.dropped.load(),
+                             (unsigned long long)G.rx_stats.duplicated.load(),
+                             (unsigned long long)G.rx_stats.reordered.load());
             else swprintf(buf, 128, L"Servo RX: ---");
             SetWindowTextW(g_lbl_rx_status, buf);
             return 0;
@@ -2748,515 +2651,108 @@ static void PostRxStatus(bool ok, double rate) {
     }
 }
 
-static void sim_thread(){
-    setlocale(LC_NUMERIC, "C");
-    UdpTx tx;
-
-    static RawSensors R_receive_buffer{};
-    static RawSensors R_prev_sample{};
-    static uint64_t R_prev_ms = 0, R_last_ms = 0;
-    auto next_try = std::chrono::steady_clock::now();
-    int simconnect_attempts = 0;
-    static auto last_status_update = std::chrono::steady_clock::now();
-
-    double t_phys_acc = 0.0;
-    double udp_send_acc = 0.0;
-    auto t_prev = std::chrono::steady_clock::now();
-
-    static uint64_t last_tx_time_ms = 0;
-    static int tx_frame_count = 0;
-    static double tx_rate_hz = 0.0;
-    static uint64_t last_tx_calc_ms = _now_ms();
-
-    bool origin_captured = false;
-    int last_pos_mode = -1;
-
-    auto sane_pos = [](double la, double lo){
-        return std::isfinite(la) && std::isfinite(lo) &&
-        fabs(la) <= 90 && fabs(lo) <= 180 &&
-        !(fabs(la) < 1e-9 && fabs(lo) < 1e-9);
-    };
-
-    tx.open("", 0);
-
-    while(RUN){
-
-        auto now = std::chrono::steady_clock::now();
-        double measured_dt = std::chrono::duration<double>(now - t_prev).count();
-        if (measured_dt < 0) measured_dt = 0;
-        if (measured_dt > 0.1) measured_dt = 0.1;
-        t_prev = now;
-        udp_send_acc += measured_dt;
-
-        int rate_hz_snap;
-        Dest d_now;
-        bool match_sim_rate_snap;
-        double sim_dt_ms_snap;
-        int pos_mode_snap;
-
-        {
-            std::lock_guard<std::mutex> lk(G.m_tx);
-            d_now = G.dest;
-            match_sim_rate_snap = G.match_sim_rate;
-            sim_dt_ms_snap = G.sim_dt_ms;
-            rate_hz_snap = G.rate_hz;
-            pos_mode_snap = G.json_pos_mode;
-        }
-
-        if (pos_mode_snap != last_pos_mode) {
-            origin_captured = false;
-            last_pos_mode = pos_mode_snap;
-        }
-
-        rate_hz_snap = match_sim_rate_snap ? iclamp((int)std::round(1000.0/std::max(5.0, sim_dt_ms_snap)), 10, 1000) : rate_hz_snap;
-        const double target_dt = 1.0 / (double)iclamp(rate_hz_snap, 10, 1000);
+static void HookStatusText(const char* text){
+    int n = MultiByteToWideChar(CP_UTF8, 0, text, -1, NULL, 0);
+    if (n <= 0) return;
+    wchar_t* p = (wchar_t*)malloc(n * sizeof(wchar_t));
+    if (p) {
+        MultiByteToWideChar(CP_UTF8, 0, text, -1, p, n);
+        PostMessageW(g_hwnd, WM_APP_STATUSTEXT, 0, (LPARAM)p);
+    }
+}
 
-        if (!g_sim_ok.load() && std::chrono::steady_clock::now() >= next_try){
-            simconnect_attempts++;
+static BridgeHooks MakeBridgeHooks(){
+    BridgeHooks h;
+    h.status_text = HookStatusText;
+    h.sim_status = PostSimStatus;
+    h.tx_status = PostTxStatus;
+    h.rx_status = PostRxStatus;
+    h.log_sample = LogSensorsToFile;
+    return h;
+}
+static const BridgeHooks g_hooks = MakeBridgeHooks();
 
-            if (sim_open()) {
-                g_sim_ok.store(true);
-                simconnect_attempts = 0;
-                PostStatus(L"SimConnect connected.");
-            }
-            else {
-                next_try = std::chrono::steady_clock::now() + std::chrono::milliseconds(2000);
-                if (simconnect_attempts % 3 == 0) {
-                    PostStatus(L"SimConnect not found (attempt %d)...", simconnect_attempts);
-                }
-                PostSimStatus(false, 0.0);
-            }
-        }
+// SensorSource backed by the live SimConnect session.
+class SimConnectSource : public SensorSource {
+public:
+    const char* name() const override { return "SimConnect"; }
+    bool open() override {
+        surf_built_ = false;
+        event_dispatch_ = G.cfg.acquire()->sim_event_dispatch;
+        return sim_open(sensors_, event_dispatch_ ? (HANDLE)data_event_.native_handle() : nullptr);
+    }
+    WaitEvent* data_event() override { return event_dispatch_ ? &data_event_ : nullptr; }
+    void close() override { sim_close(); }
 
+    bool dispatch(SensorTx& tx) override {
         SIMCONNECT_RECV* p=nullptr; DWORD cb=0;
+        HRESULT hr = SimConnect_GetNextDispatch(gSim,&p,&cb);
 
-        if (g_sim_ok.load()){
-            HRESULT hr = SimConnect_GetNextDispatch(gSim,&p,&cb);
-
-            while(SUCCEEDED(hr) && p){
+        while(SUCCEEDED(hr) && p){
 
-                switch(p->dwID){
-                    case SIMCONNECT_RECV_ID_QUIT:
-                    PostStatus(L"SimConnect disconnected.");
-                    sim_close();
-                    g_sim_ok.store(false);
-                    origin_captured = false;
-                    PostSimStatus(false, 0.0);
-                    next_try = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
-                    break;
-                    case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:{
-                        static uint64_t last_ms = 0; uint64_t now_ms = GetTickCount64();
-                        double dt = (now_ms > last_ms) ? (double)(now_ms - last_ms) : 0.0;
-                        last_ms = now_ms;
-
-                        if (dt>1 && dt<500) {
-                            std::lock_guard<std::mutex> lk(G.m_tx);
-                            G.sim_dt_ms = 0.8*G.sim_dt_ms + 0.2*dt;
-                        }
+            switch(p->dwID){
+                case SIMCONNECT_RECV_ID_QUIT:
+                return false;
+                case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:{
+                    auto* d=(SIMCONNECT_RECV_SIMOBJECT_DATA*)p;
 
-                        auto* d=(SIMCONNECT_RECV_SIMOBJECT_DATA*)p;
-
-                        if (d->dwRequestID==REQ_SENSORS){
-                            const double* v=(const double*)&d->dwData;
-                            R_receive_buffer.lat_deg=v[0]; R_receive_buffer.lon_deg=v[1];
-                            R_receive_buffer.alt_msl_ft=v[2]; R_receive_buffer.alt_agl_ft=v[3];
-                            R_receive_buffer.pitch_deg=v[4]; R_receive_buffer.bank_deg=v[5]; R_receive_buffer.hdg_true_deg=v[6];
-                            R_receive_buffer.ias_kt=v[7];
-                            R_receive_buffer.vel_e_fps = v[8]; R_receive_buffer.vel_n_fps = v[9]; R_receive_buffer.vel_u_fps = v[10];
-                            R_receive_buffer.p_rads=v[13]; R_receive_buffer.q_rads=v[11]; R_receive_buffer.r_rads=v[12];
-                            R_receive_buffer.accel_x_fps2=v[14]; R_receive_buffer.accel_y_fps2=v[15]; R_receive_buffer.accel_z_fps2=v[16];
-                            R_receive_buffer.engine_rpm=v[17]; R_receive_buffer.prop_rpm=v[18]; R_receive_buffer.prop_pitch_rad=v[19];
-                            R_receive_buffer.radio_height_ft=v[20]; R_receive_buffer.ground_alt_ft=v[21];
-
-                            if (std::isfinite(R_receive_buffer.radio_height_ft) && R_receive_buffer.radio_height_ft>=0 && R_receive_buffer.radio_height_ft<=3000)
-                            R_receive_buffer.alt_agl_ft=R_receive_buffer.radio_height_ft;
-                            else if (std::isfinite(R_receive_buffer.ground_alt_ft))
-                            R_receive_buffer.alt_agl_ft = std::max(R_receive_buffer.alt_msl_ft-R_receive_buffer.ground_alt_ft,0.0);
-
-                            R_receive_buffer.valid = sane_pos(R_receive_buffer.lat_deg, R_receive_buffer.lon_deg);
-
-                            {
-                                std::lock_guard<std::mutex> lk(G.m_tx);
-
-                                if (pos_mode_snap == 0 && !origin_captured && R_receive_buffer.valid) {
-                                    G.sim_origin_lat = R_receive_buffer.lat_deg;
-                                    G.sim_origin_lon = R_receive_buffer.lon_deg;
-                                    G.sim_origin_alt_m = ft2m(R_receive_buffer.alt_msl_ft);
-                                    G.sim_origin_set = true;
-                                    origin_captured = true;
-                                } else if (pos_mode_snap != 0 && !G.sim_origin_set && R_receive_buffer.valid) {
-                                    G.sim_origin_lat = R_receive_buffer.lat_deg;
-                                    G.sim_origin_lon = R_receive_buffer.lon_deg;
-                                    G.sim_origin_alt_m = ft2m(R_receive_buffer.alt_msl_ft);
-                                    G.sim_origin_set = true;
-                                }
-
-                            double Re = G.sim_earth_radius;
-                            constexpr double DEG2RAD=0.01745329251994329577;
-
-                            double dLat=(R_receive_buffer.lat_deg - G.sim_origin_lat) * DEG2RAD;
-                            double dLon=(R_receive_buffer.lon_deg - G.sim_origin_lon) * DEG2RAD;
-                            double latm=((R_receive_buffer.lat_deg + G.sim_origin_lat)/2.0)*DEG2RAD;
-
-                            R_receive_buffer.N_m = dLat*Re;
-                            R_receive_buffer.E_m = dLon*Re*std::cos(latm);
-                            R_receive_buffer.U_m = ft2m(R_receive_buffer.alt_msl_ft) - G.sim_origin_alt_m;
-                            }
-
-                            {
-                                std::lock_guard<std::mutex> lk(G.m_tx);
-                                R_prev_sample = G.R;
-                                R_prev_ms = R_last_ms;
-                                G.R = R_receive_buffer;
-                                R_last_ms = now_ms;
-                            }
-                            {
-                                const int __hz = (rate_hz_snap > 0 ? rate_hz_snap : 50);
-                                const uint64_t __period = (uint64_t)(1000 / __hz);
-                                const uint64_t __now = GetTickCount64();
-                                uint64_t __next = g_next_log_ms.load(std::memory_order_relaxed);
-
-                                if (__now >= __next) {
-                                    LogSensorsToFile(R_receive_buffer);
-                                    g_next_log_ms.store(__now + __period, std::memory_order_relaxed);
-                                }
-                            }
-                        }
-                        break;
+                    const size_t hdr = offsetof(SIMCONNECT_RECV_SIMOBJECT_DATA, dwData);
+                    if (sensors_.owns(d->dwRequestID) && cb > hdr &&
+                        sensors_.on_data(d->dwRequestID, (d->dwFlags & SIMCONNECT_DATA_REQUEST_FLAG_TAGGED) != 0,
+                        d->dwDefineCount, &d->dwData, cb - hdr)) {
+                        tx.on_sample(sensors_.current());
                     }
-                    default: break;
-                }
-
-                if (g_sim_ok.load()) {
-                    hr = SimConnect_GetNextDispatch(gSim,&p,&cb);
-                } else {
-                    p = nullptr;
-                }
-            }
-        }
-
-        PWMLast P;
-        bool have_pwm=false;
-        {
-            std::lock_guard<std::mutex> lk(G.m_rx);
-            have_pwm = (!G.pwm.pwm.empty()) && (std::chrono::duration<double>(std::chrono::steady_clock::now()-G.pwm.tlast).count() < 0.3);
-            if (have_pwm) P = G.pwm;
-        }
-
-        static bool intercept_enabled = false;
-        if (g_sim_ok.load()) {
-            if (have_pwm && !intercept_enabled) {
-                SimConnect_SetInputGroupPriority(gSim, GRP_INTERCEPT, SIMCONNECT_GROUP_PRIORITY_HIGHEST);
-                intercept_enabled = true;
-                PostStatus(L"HW axes: suppressed (SITL active)");
-            } else if (!have_pwm && intercept_enabled) {
-                SimConnect_SetInputGroupPriority(gSim, GRP_INTERCEPT, SIMCONNECT_GROUP_PRIORITY_STANDARD);
-                intercept_enabled = false;
-                PostStatus(L"HW axes: restored (SITL inactive)");
-            }
-        }
-
-        if (g_sim_ok.load() && have_pwm && P.pwm.size() >= 16) {
-
-            double norm_pwm[16];
-            bool inv_ch[16];
-            int sim_evt_idx_copy[16];
-
-            {
-                std::lock_guard<std::mutex> lk(G.m_tx);
-                for(int i=0; i<16; i++) {
-                    inv_ch[i] = G.invsim_ch[i];
-                    sim_evt_idx_copy[i] = G_sim_evt_idx[i];
-                }
-            }
-            {
-                std::lock_guard<std::mutex> lk(G.m_gui);
-                for(int i=0; i<16; i++) norm_pwm[i] = G.sitl_out_pwm[i];
-            }
-
-            for (int i = 0; i < 16; i++) {
-                if (inv_ch[i]) {
-                    if (i == 0 || i == 1 || i == 3) {
-                        norm_pwm[i] = -norm_pwm[i];
-                    } else {
-                        norm_pwm[i] = 1.0 - norm_pwm[i];
-                    }
-                }
-            }
-
-            for (int i = 0; i < 16; i++) {
-                if (sim_evt_idx_copy[i] != 0) {
-                    LONG sim_val;
-                    if (i == 0 || i == 1 || i == 3) {
-                        sim_val = (LONG)llround(norm_pwm[i] * 16383.0);
-                    } else {
-                        sim_val = (LONG)llround((norm_pwm[i] * 2.0 - 1.0) * 16383.0);
-                    }
-
-                    SimConnect_TransmitClientEvent(gSim, 0, g_sim_evt_map[i], (DWORD)sim_val, SIMCONNECT_GROUP_PRIORITY_HIGHEST, SIMCONNECT_EVENT_FLAG_GROUPID_IS_PRIORITY);
-                }
-            }
-        }
-
-        if (tx.needs_reopen(d_now.ip, d_now.port_tx)) {
-             tx.open(d_now.ip, d_now.port_tx);
-        }
-
-        while (udp_send_acc >= target_dt) {
-
-            udp_send_acc -= target_dt;
-
-            t_phys_acc += target_dt;
-            const double t_sec = t_phys_acc;
-
-            RawSensors R{};
-            int resample_mode_snap;
-            {
-                std::lock_guard<std::mutex> lk(G.m_tx);
-                R = G.R;
-                resample_mode_snap = G.resample_mode;
-            }
-
-            if (!match_sim_rate_snap && resample_mode_snap == 2) {
-                uint64_t now_ms = GetTickCount64();
-                double sim_dt = (R_last_ms>0 && R_prev_ms>0) ? double(R_last_ms - R_prev_ms) : 0.0;
-                double since  = (R_last_ms>0 && now_ms > R_last_ms) ? double(now_ms - R_last_ms) : 0.0;
-
-                if (sim_dt > 0.0 && since >= 0.0 && since < 1000.0) {
-                    double alpha = since / sim_dt;
-                    alpha = clampd(alpha, 0.0, 1.0);
-
-                    auto lerp  = [](double a,double b,double t){ return a + (b - a)*t; };
-                    auto lerp_ang = [](double a,double b,double t){
-                        double da = fmod(b - a + 540.0, 360.0) - 180.0;
-                        return a + da*t;
-                    };
-                    R.lat_deg = lerp(R_prev_sample.lat_deg, R_receive_buffer.lat_deg, alpha);
-                    R.lon_deg = lerp(R_prev_sample.lon_deg, R_receive_buffer.lon_deg, alpha);
-                    R.alt_msl_ft = lerp(R_prev_sample.alt_msl_ft, R_receive_buffer.alt_msl_ft, alpha);
-                    R.alt_agl_ft = lerp(R_prev_sample.alt_agl_ft, R_receive_buffer.alt_agl_ft, alpha);
-                    R.pitch_deg = lerp(R_prev_sample.pitch_deg, R_receive_buffer.pitch_deg, alpha);
-                    R.bank_deg  = lerp(R_prev_sample.bank_deg,  R_receive_buffer.bank_deg,  alpha);
-                    R.hdg_true_deg = lerp_ang(R_prev_sample.hdg_true_deg, R_receive_buffer.hdg_true_deg, alpha);
-                    R.vel_e_fps = lerp(R_prev_sample.vel_e_fps, R_receive_buffer.vel_e_fps, alpha);
-                    R.vel_n_fps = lerp(R_prev_sample.vel_n_fps, R_receive_buffer.vel_n_fps, alpha);
-                    R.vel_u_fps = lerp(R_prev_sample.vel_u_fps, R_receive_buffer.vel_u_fps, alpha);
-                    R.p_rads = lerp(R_prev_sample.p_rads, R_receive_buffer.p_rads, alpha);
-                    R.q_rads = lerp(R_prev_sample.q_rads, R_receive_buffer.q_rads, alpha);
-                    R.r_rads = lerp(R_prev_sample.r_rads, R_receive_buffer.r_rads, alpha);
-                    R.accel_x_fps2 = lerp(R_prev_sample.accel_x_fps2, R_receive_buffer.accel_x_fps2, alpha);
-                    R.accel_y_fps2 = lerp(R_prev_sample.accel_y_fps2, R_receive_buffer.accel_y_fps2, alpha);
-                    R.accel_z_fps2 = lerp(R_prev_sample.accel_z_fps2, R_receive_buffer.accel_z_fps2, alpha);
-                    R.ias_kt = lerp(R_prev_sample.ias_kt, R_receive_buffer.ias_kt, alpha);
-                    R.engine_rpm = lerp(R_prev_sample.engine_rpm, R_receive_buffer.engine_rpm, alpha);
-                    R.prop_rpm   = lerp(R_prev_sample.prop_rpm,   R_receive_buffer.prop_rpm,   alpha);
-                    R.prop_pitch_rad = lerp(R_prev_sample.prop_pitch_rad, R_receive_buffer.prop_pitch_rad, alpha);
-                    R.radio_height_ft = lerp(R_prev_sample.radio_height_ft, R_receive_buffer.radio_height_ft, alpha);
-                    R.ground_alt_ft   = lerp(R_prev_sample.ground_alt_ft,   R_receive_buffer.ground_alt_ft,   alpha);
-
-                    R.N_m = lerp(R_prev_sample.N_m, R_receive_buffer.N_m, alpha);
-                    R.E_m = lerp(R_prev_sample.E_m, R_receive_buffer.E_m, alpha);
-                    R.U_m = lerp(R_prev_sample.U_m, R_receive_buffer.U_m, alpha);
+                    break;
                 }
+                default: break;
             }
 
-            struct sockaddr_in dest_addr;
-            bool dest_known;
-            {
-                std::lock_guard<std::mutex> lk(g_sitl_addr_mtx);
-                dest_addr = g_sitl_addr;
-                dest_known = g_sitl_addr_known;
-            }
-
-            if (R.valid && G.sim_origin_set) {
-
-                double vel_n_ms = ft2m(R.vel_n_fps);
-                double vel_e_ms = ft2m(R.vel_e_fps);
-                double vel_d_ms = ft2m(-R.vel_u_fps);
-
-                double accel_x_ms2 = ft2m(R.accel_x_fps2);
-                double accel_y_ms2 = ft2m(R.accel_y_fps2);
-                double accel_z_ms2 = ft2m(-R.accel_z_fps2);
-                double alt_msl_m = ft2m(R.alt_msl_ft);
-                double alt_agl_m = ft2m(R.alt_agl_ft);
-                double airspeed_ms = kt2ms(R.ias_kt);
-
-                double roll_rad = -deg2rad(R.bank_deg);
-                double pitch_rad = -deg2rad(R.pitch_deg);
-                double yaw_rad = deg2rad(R.hdg_true_deg);
-
-                double cy = cos(yaw_rad * 0.5);
-                double sy = sin(yaw_rad * 0.5);
-                double cp = cos(pitch_rad * 0.5);
-                double sp = sin(pitch_rad * 0.5);
-                double cr = cos(roll_rad * 0.5);
-                double sr = sin(roll_rad * 0.5);
-
-                float q1 = cr * cp * cy + sr * sp * sy;
-                float q2 = sr * cp * cy - cr * sp * sy;
-                float q3 = cr * sp * cy + sr * cp * sy;
-                float q4 = cr * cp * sy - sr * sp * cy;
-
-                double rc_copy[12];
-                {
-                    std::lock_guard<std::mutex> lk(G.m_gui);
-                    for(int i=0; i<12; i++) rc_copy[i] = G.rc_out[i];
-                }
-
-                if (dest_known) {
-                    static char json_buf[4096];
-
-                    bool use_time_sync_snap;
-                    bool no_lockstep_snap;
-
-                    {
-                        std::lock_guard<std::mutex> lk(G.m_tx);
-                        use_time_sync_snap = G.use_time_sync;
-                        no_lockstep_snap = G.no_lockstep;
-                    }
-
-                    float rc_pwm[12];
-                    for(int i=0; i<12; i++) {
-                        rc_pwm[i] = (rc_copy[i] < 0.0) ? 1500.0f : (float)(rc_copy[i] * 1000.0 + 1000.0);
-                    }
-
-                    static char tsync_buf[64];
-                    snprintf(tsync_buf, sizeof(tsync_buf), "\"no_time_sync\":%s, ", use_time_sync_snap ? "false" : "true");
-                    const char* tsync_field = tsync_buf;
-
-
-                    static char lockstep_buf[64];
-                    snprintf(lockstep_buf, sizeof(lockstep_buf), "\"no_lockstep\": %s, ", no_lockstep_snap ? "true" : "false");
-                    const char* lockstep_field = lockstep_buf;
-
-                    static char geo_buf[256];
-                    if (pos_mode_snap == 2) {
-                        snprintf(geo_buf, sizeof(geo_buf),
-                        "\"latitude\": %.10f, \"longitude\": %.10f, \"altitude\": %.4f, \"position\": [%.4f, %.4f, %.4f], ",
-                        R.lat_deg, R.lon_deg, alt_msl_m, R.N_m, R.E_m, -R.U_m);
-                    } else {
-                        snprintf(geo_buf, sizeof(geo_buf),
-                        "\"position\": [%.4f, %.4f, %.4f], ",
-                        R.N_m, R.E_m, -R.U_m);
-                    }
-
-                    int len = snprintf(json_buf, sizeof(json_buf),
-    "{"
-      "\"timestamp\": %.6f, "
-      "%s"
-      "\"quaternion\": [%.6f, %.6f, %.6f, %.6f], "
-      "\"velocity\": [%.6f, %.6f, %.6f], "
-      "\"imu\": {"
-        "\"gyro\": [%.6f, %.6f, %.6f], "
-        "\"accel_body\": [%.6f, %.6f, %.6f]"
-      "}, "
-      "\"airspeed\": %.4f, "
-      "\"rng_1\": %.4f, "
-      "%s"
-      "%s"
-      "\"rc\": {"
-        "\"rc_1\": %.1f, \"rc_2\": %.1f, \"rc_3\": %.1f, \"rc_4\": %.1f, "
-        "\"rc_5\": %.1f, \"rc_6\": %.1f, \"rc_7\": %.1f, \"rc_8\": %.1f, "
-        "\"rc_9\": %.1f, \"rc_10\": %.1f, \"rc_11\": %.1f, \"rc_12\": %.1f"
-      "}"
-    "}\n",
-    t_sec,
-    geo_buf,
-    q1, q2, q3, q4,
-    vel_n_ms, vel_e_ms, vel_d_ms,
-    -R.p_rads, -R.q_rads, R.r_rads,
-    accel_x_ms2, accel_y_ms2, accel_z_ms2,
-    airspeed_ms,
-    alt_agl_m,
-    lockstep_field,
-    tsync_field,
-    rc_pwm[0], rc_pwm[1], rc_pwm[2], rc_pwm[3],
-    rc_pwm[4], rc_pwm[5], rc_pwm[6], rc_pwm[7],
-    rc_pwm[8], rc_pwm[9], rc_pwm[10], rc_pwm[11]
-);
-
-                    if (len > 0 && len < sizeof(json_buf)) {
-                        tx.send_buffer(json_buf, len, &dest_addr);
-                        tx_frame_count++;
-                        last_tx_time_ms = _now_ms();
-                    }
-                }
-            }
+            hr = SimConnect_GetNextDispatch(gSim,&p,&cb);
         }
+        return true;
+    }
 
-        auto now_status = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now_status - last_status_update).count() >= 0.5){
-            last_status_update = now_status;
-
-            wchar_t wip[256];
-            if (g_sitl_addr_known) {
-                char sitl_ip_str[INET_ADDRSTRLEN];
-                inet_ntop(AF_INET, &g_sitl_addr.sin_addr, sitl_ip_str, INET_ADDRSTRLEN);
-                MultiByteToWideChar(CP_UTF8,0,sitl_ip_str,-1,wip,256);
-            } else {
-                wcscpy(wip, L"?.?.?.?");
-            }
-
-            double sim_dt_ms_now;
-            {
-                std::lock_guard<std::mutex> lk(G.m_tx);
-                sim_dt_ms_now = G.sim_dt_ms;
-            }
-            double sim_fps = (sim_dt_ms_now > 0) ? (1000.0 / sim_dt_ms_now) : 0.0;
-
-            PostSimStatus(g_sim_ok.load(), sim_fps);
-
-            bool valid_data = false;
-            { std::lock_guard<std::mutex> lk(G.m_tx); valid_data = G.R.valid; }
-            const wchar_t* data_status = valid_data ? L"Data: VALID" : L"Data: NO";
-
-            const wchar_t* joy_status = G.joy_ok.load() ? L"Joy: OK" : L"Joy: ---";
+    void set_intercept(bool on) override {
+        SimConnect_SetInputGroupPriority(gSim, GRP_INTERCEPT, on ? SIMCONNECT_GROUP_PRIORITY_HIGHEST : SIMCONNECT_GROUP_PRIORITY_STANDARD);
+    }
 
-            bool sitl_is_alive;
-            {
-                std::lock_guard<std::mutex> lk(G.m_rx);
-                sitl_is_alive = g_sitl_addr_known && (std::chrono::duration<double>(std::chrono::steady_clock::now() - G.pwm.tlast).count() < 2.0);
-            }
-            const wchar_t* sitl_rx_status = sitl_is_alive ? L"SITL RX: OK" : L"SITL RX: ---";
-
-            bool tx_ok = g_sitl_addr_known && (_now_ms() - last_tx_time_ms < 2000);
-            PostTxStatus(tx_ok, tx_rate_hz);
-
-            wchar_t* buf=(wchar_t*)malloc(sizeof(wchar_t)*640);
-            if (buf){
-                swprintf(buf, 640, L"Sim fps: %.1f | %s | %s | %s (RX:%u) | TX: %s:%u | %dHz | JSON MODE",
-                sim_fps,
-                data_status,
-                joy_status,
-                sitl_rx_status,
-                d_now.port_rx,
-                wip, (g_sitl_addr_known ? ntohs(g_sitl_addr.sin_port) : 0),
-                rate_hz_snap);
-                PostMessageW(g_hwnd, WM_APP_STATUSTEXT, 0, (LPARAM)buf);
+    void send_axes(const long sim_val[16], uint32_t mask, const BridgeConfig& c) override {
+        // Data mode: every channel with a SimVar goes out in one write as
+        // soon as any of them is due; the rest stay on their events.
+        uint32_t data_mask = 0;
+        if (c.axis_output == AXIS_OUT_DATA) {
+            if (!surf_built_ || memcmp(surf_evt_, c.axis_evt, sizeof(surf_evt_)) != 0) {
+                const char* events[16];
+                for (int i = 0; i < 16; i++) events[i] = get_sim_evt_by_idx(c.axis_evt[i]);
+                surfaces_.build(api_, DEF_SURFACES, events);
+                memcpy(surf_evt_, c.axis_evt, sizeof(surf_evt_));
+                surf_built_ = true;
             }
+            data_mask = surfaces_.channels();
+            if (mask & data_mask) surfaces_.write(api_, sim_val);
         }
 
-        uint64_t calc_now = _now_ms();
-        if (calc_now - last_tx_calc_ms > 1000) {
-            double dt_s = (calc_now - last_tx_calc_ms) / 1000.0;
-            if (dt_s > 0) {
-                tx_rate_hz = (double)tx_frame_count / dt_s;
+        for (int i = 0; i < 16; i++) {
+            if (mask & ~data_mask & (1u << i)) {
+                SimConnect_TransmitClientEvent(gSim, 0, g_sim_evt_map[i], (DWORD)(LONG)sim_val[i], SIMCONNECT_GROUP_PRIORITY_HIGHEST, SIMCONNECT_EVENT_FLAG_GROUPID_IS_PRIORITY);
             }
-            tx_frame_count = 0;
-            last_tx_calc_ms = calc_now;
         }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
-    tx.close();
+private:
+    WaitEvent data_event_;
+    bool event_dispatch_ = false;
+    SensorRequests sensors_;
+    SimConnectDataApi api_;
+    SurfaceWriter surfaces_;
+    int surf_evt_[16]{};
+    bool surf_built_ = false;
+};
 
-    if(g_sim_ok.load()) {
-        sim_close();
-    }
-    g_sim_ok.store(false);
-    PostSimStatus(false, 0.0);
-    PostTxStatus(false, 0.0);
+static void sim_thread(){
+    setlocale(LC_NUMERIC, "C");
+    SimConnectSource src;
+    sim_loop(G, g_hooks, src, RUN);
 }
 
 static void joy_thread(){
@@ -3265,8 +2761,7 @@ static void joy_thread(){
     while(RUN){
         std::this_thread::sleep_for(std::chrono::milliseconds(20));
 
-        int joy_idx_now;
-        { std::lock_guard<std::mutex> lk(G.m_tx); joy_idx_now = G.joy_index; }
+        int joy_idx_now = g_joy_cfg.acquire()->joy_index;
 
         if (joy_idx_now != joy_idx_last) {
             select_joystick(joy_idx_now);
@@ -3331,11 +2826,8 @@ static void joy_thread(){
             for(int i=0;i<NUM_JOY_AXES;i++) G.raw_axes[i] = raw_axes[i];
         }
 
-        JoyMapCfg map_copy[NUM_JOY_AXES];
-        {
-            std::lock_guard<std::mutex> lk(G.m_tx);
-            for(int i=0; i < NUM_JOY_AXES; i++) map_copy[i] = G.joy_map[i];
-        }
+        const auto joy_cfg = g_joy_cfg.acquire();
+        const JoyMapCfg* map_copy = joy_cfg->joy_map;
 
         double out_slots[12];
         for(int i=0; i<12; i++) out_slots[i] = -1.0;
@@ -3372,119 +2864,7 @@ static void joy_thread(){
 }
 
 static void rx_thread(){
-    UdpRxRaw rx;
-    uint16_t port_last=0;
-    std::vector<uint8_t> buf(8192);
-    struct sockaddr_in from_addr = {};
-
-    static uint64_t last_rx_time_ms = _now_ms();
-    static int rx_frame_count = 0;
-    static double rx_rate_hz = 0.0;
-    static auto last_rx_status_post = std::chrono::steady_clock::now();
-
-
-    auto normalize_pwm = [](uint16_t pwm, bool is_throttle_or_aux) -> double {
-        if (is_throttle_or_aux) {
-            return clampd(((double)pwm - 1000.0) / 1000.0, 0.0, 1.0);
-        } else {
-            return clampd(((double)pwm - 1500.0) / 500.0, -1.0, 1.0);
-        }
-    };
-
-    while(RUN){
-        uint16_t port_now;
-        { std::lock_guard<std::mutex> lk(G.m_tx); port_now=G.dest.port_rx; }
-
-        if(rx.needs_reopen(port_now)){
-            rx.open(port_now);
-            port_last = port_now;
-            PostStatus(L"RX (Servo) settings updated: listening on port %u", port_now);
-        }
-
-        int len = rx.recv(buf.data(), (int)buf.size(), &from_addr);
-
-        auto now_tp = std::chrono::steady_clock::now();
-        if (len <= 0) {
-            if (std::chrono::duration<double>(now_tp - last_rx_status_post).count() > 1.0) {
-                if (G.status_rx_ok.load()) {
-                    PostRxStatus(false, 0.0);
-                }
-                last_rx_status_post = now_tp;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
-            continue;
-        }
-
-        rx_frame_count++;
-        uint64_t now_ms = _now_ms();
-        uint64_t dt = now_ms - last_rx_time_ms;
-        if (dt > 1000) {
-            rx_rate_hz = (double)rx_frame_count / (dt / 1000.0);
-            rx_frame_count = 0;
-            last_rx_time_ms = now_ms;
-        }
-        if (std::chrono::duration<double>(now_tp - last_rx_status_post).count() > 0.5) {
-             PostRxStatus(true, rx_rate_hz);
-             last_rx_status_post = now_tp;
-        }
-
-
-        if (len >= sizeof(servo_packet_16)) {
-            auto* pkt = reinterpret_cast<servo_packet_16*>(buf.data());
-            if (pkt->magic == 18458) {
-                {
-                    std::lock_guard<std::mutex> lk(g_sitl_addr_mtx);
-                    g_sitl_addr = from_addr;
-                    g_sitl_addr_known = true;
-                }
-                {
-                    std::lock_guard<std::mutex> lk(G.m_rx);
-                    if (G.pwm.pwm.size() < 16) G.pwm.pwm.resize(16);
-                    memcpy(G.pwm.pwm.data(), pkt->pwm, 16 * sizeof(uint16_t));
-                    G.pwm.tlast = std::chrono::steady_clock::now();
-                    G.pwm.rate_hz = pkt->frame_rate;
-                }
-                {
-                    std::lock_guard<std::mutex> lk_gui(G.m_gui);
-                    for(int i=0; i<16; i++) {
-                        bool is_thr_aux = (i == 2 || i >= 4);
-                        G.sitl_out_pwm[i] = normalize_pwm(pkt->pwm[i], is_thr_aux);
-                        G.sitl_has_ch[i] = true;
-                    }
-                }
-                continue;
-            }
-        }
-
-        if (len >= sizeof(servo_packet_32)) {
-            auto* pkt = reinterpret_cast<servo_packet_32*>(buf.data());
-            if (pkt->magic == 29569) {
-                {
-                    std::lock_guard<std::mutex> lk(g_sitl_addr_mtx);
-                    g_sitl_addr = from_addr;
-                    g_sitl_addr_known = true;
-                }
-                {
-                    std::lock_guard<std::mutex> lk(G.m_rx);
-                    if (G.pwm.pwm.size() < 32) G.pwm.pwm.resize(32);
-                    memcpy(G.pwm.pwm.data(), pkt->pwm, 32 * sizeof(uint16_t));
-                    G.pwm.tlast = std::chrono::steady_clock::now();
-                    G.pwm.rate_hz = pkt->frame_rate;
-                }
-                {
-                    std::lock_guard<std::mutex> lk_gui(G.m_gui);
-                    for(int i=0; i<16; i++) {
-                        bool is_thr_aux = (i == 2 || i >= 4);
-                        G.sitl_out_pwm[i] = normalize_pwm(pkt->pwm[i], is_thr_aux);
-                        G.sitl_has_ch[i] = true;
-                    }
-                }
-                continue;
-            }
-        }
-    }
-    rx.close();
-    PostRxStatus(false, 0.0);
+    rx_loop(G, g_hooks, RUN);
 }
 
 static void ShowCrashReport(const wchar_t* title, const wchar_t* format, ...) {
@@ -3665,6 +3045,21 @@ int WINAPI wWinMain(HINSTANCE hi, HINSTANCE, PWSTR, int nCmdShow)
     }
 }
 
-static void load_ini(){ g_ini_path = get_ini_path(); load_settings_from_path(g_ini_path); }
+static void load_sensor_extras(const std::wstring& path){
+    for (int i = 0; i < kSensorExtraMax; i++) {
+        wchar_t key[32], w[512];
+        swprintf(key, 32, L"extra%d", i + 1);
+        if (GetPrivateProfileStringW(L"sensors", key, L"", w, 512, path.c_str()) == 0) continue;
+        char spec[1024]; WideCharToMultiByte(CP_UTF8, 0, w, -1, spec, 1024, NULL, NULL);
+        if (g_sensor_reg.add_extra(spec)) g_sensor_extra_spec[g_sensor_reg.extras() - 1] = w;
+        else {
+            wchar_t msg[128];
+            swprintf(msg, 128, L"Ignoring [sensors] %ls: expected SIMVAR,units[,frame|slow[,column]]\r\n", key);
+            OutputDebugStringW(msg);
+        }
+    }
+}
+
+static void load_ini(){ g_ini_path = get_ini_path(); load_sensor_extras(g_ini_path); load_settings_from_path(g_ini_path); }
 
 static void save_ini(){ if(g_ini_path.empty()) g_ini_path = get_ini_path(); save_settings_to_path(g_ini_path); }
\ No newline at end of file
@@ -0,0 +1,441 @@
+/*
+   MSFS 202x–ArduPilot Bridge - headless runner.
+
+   Runs the bridge pipeline without any GUI so it can sit next to SITL on a
+   Linux host, be pinned to a core and be profiled with perf.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/bridge.h"
+#include "core/ini.h"
+#include "core/net.h"
+#include "core/platform.h"
+#include "core/resample.h"
+#include "core/sensor_source.h"
+#include "core/vehicle_pool.h"
+
+static std::atomic<bool> RUN{true};
+static Shared G;
+
+static std::mutex g_print_mtx;
+static std::string g_last_status;
+
+static void print_status(const char* text){
+    std::lock_guard<std::mutex> lk(g_print_mtx);
+    if (g_last_status == text) return;
+    g_last_status = text;
+    printf("%s\n", text);
+    fflush(stdout);
+}
+
+static void print_link(const char* name, bool ok, double rate_hz){
+    static bool last_ok[3] = {false, false, false};
+    int idx = name[0] == 'S' ? 0 : (name[0] == 'T' ? 1 : 2);
+    std::lock_guard<std::mutex> lk(g_print_mtx);
+    if (last_ok[idx] == ok) return;
+    last_ok[idx] = ok;
+    if (ok) printf("%s: OK (%.0f Hz)\n", name, rate_hz);
+    else printf("%s: ---\n", name);
+    fflush(stdout);
+}
+
+static void on_sim_status(bool ok, double rate_hz){ print_link("Sim", ok, rate_hz); }
+static void on_tx_status(bool ok, double rate_hz){ print_link("TX (sensors)", ok, rate_hz); }
+static void on_rx_status(bool ok, double rate_hz){ print_link("RX (servo)", ok, rate_hz); }
+
+static void on_signal(int){ RUN.store(false); }
+
+static int parse_resample(const char* s){
+    if (!strcmp(s, "zoh")) return RESAMPLE_ZOH;
+    if (!strcmp(s, "linear")) return RESAMPLE_LINEAR;
+    if (!strcmp(s, "cubic")) return RESAMPLE_CUBIC;
+    return RESAMPLE_OFF;
+}
+
+static int parse_geodesy(const char* s){
+    return strcmp(s, "flat") ? GEODESY_WGS84 : GEODESY_FLAT;
+}
+
+static int parse_net_backend(const char* s){
+    return strcmp(s, "io_uring") ? NET_SOCKETS : NET_IO_URING;
+}
+
+static int parse_frame_format(const char* s){
+    return strcmp(s, "binary") ? FRAME_JSON : FRAME_BINARY;
+}
+
+// Same [bridge] keys as the GUI's load_settings_from_path().
+static void load_settings(const IniFile& ini){
+    G.dest.ip = ini.get_string("bridge", "ip", G.dest.ip.c_str());
+    G.dest.port_tx = (uint16_t)ini.get_int("bridge", "port_tx", G.dest.port_tx);
+    G.dest.port_rx = (uint16_t)ini.get_int("bridge", "port_rx", G.dest.port_rx);
+    G.rate_hz = ini.get_int("bridge", "rate", G.rate_hz);
+    G.match_sim_rate = ini.get_int("bridge", "match_sim_rate", G.match_sim_rate?1:0) != 0;
+    {
+        std::string res = ini.get_string("bridge", "resample", "off");
+        for (auto& c : res) c = (char)tolower((unsigned char)c);
+        G.resample_mode = parse_resample(res.c_str());
+    }
+    G.use_time_sync = ini.get_int("bridge", "use_time_sync", G.use_time_sync?1:0) != 0;
+    G.no_lockstep = ini.get_int("bridge", "no_lockstep", G.no_lockstep?1:0) != 0;
+    G.lockstep_tx = ini.get_int("bridge", "lockstep_tx", G.lockstep_tx?1:0) != 0;
+    G.tx_spin_us = ini.get_int("bridge", "tx_spin_us", G.tx_spin_us);
+    G.predict_ms = ini.get_int("bridge", "predict_ms", G.predict_ms);
+    G.predict_max_err_m = ini.get_double("bridge", "predict_max_err_m", G.predict_max_err_m);
+    G.axis_deadband = ini.get_int("bridge", "axis_deadband", G.axis_deadband);
+    G.axis_keepalive_ms = ini.get_int("bridge", "axis_keepalive_ms", G.axis_keepalive_ms);
+    G.axis_frame_align = ini.get_int("bridge", "axis_frame_align", G.axis_frame_align?1:0) != 0;
+    {
+        std::string srx = ini.get_string("bridge", "servo_rx", "drain");
+        for (auto& c : srx) c = (char)tolower((unsigned char)c);
+        G.servo_rx_drain = srx != "single";
+    }
+    {
+        std::string net = ini.get_string("bridge", "net_backend", "sockets");
+        for (auto& c : net) c = (char)tolower((unsigned char)c);
+        G.net_backend = parse_net_backend(net.c_str());
+    }
+    G.sensor_listeners = ini.get_string("bridge", "listeners", G.sensor_listeners.c_str());
+    G.sitl_shadows = ini.get_int("bridge", "sitl_shadows", G.sitl_shadows?1:0) != 0;
+    {
+        std::string fmt = ini.get_string("bridge", "sitl_format", "json");
+        for (auto& c : fmt) c = (char)tolower((unsigned char)c);
+        G.sitl_format = parse_frame_format(fmt.c_str());
+    }
+    G.shm_path = ini.get_string("bridge", "shm_path", G.shm_path.c_str());
+    G.json_pos_mode = ini.get_int("bridge", "pos_mode", G.json_pos_mode);
+    {
+        std::string geo = ini.get_string("bridge", "geodesy", "wgs84");
+        for (auto& c : geo) c = (char)tolower((unsigned char)c);
+        G.geodesy_mode = parse_geodesy(geo.c_str());
+    }
+
+    for (int i = 0; i < 16; i++) {
+        char key_inv[64];
+        snprintf(key_inv, sizeof(key_inv), "invert_sim_ch%d", i + 1);
+        G.invsim_ch[i] = ini.get_int("bridge", key_inv, G.invsim_ch[i] ? 1 : 0) != 0;
+    }
+
+    G.sim_origin_lat = ini.get_double("bridge", "origin_lat", G.sim_origin_lat);
+    G.sim_origin_lon = ini.get_double("bridge", "origin_lon", G.sim_origin_lon);
+    G.sim_origin_alt_m = ini.get_double("bridge", "origin_alt_m", G.sim_origin_alt_m);
+    G.sim_earth_radius = ini.get_double("bridge", "earth_radius", G.sim_earth_radius);
+}
+
+static void set_static_dest(Shared& S, const BridgeConfig& c){
+    S.sitl_addr.sin_family = AF_INET;
+    S.sitl_addr.sin_port = htons(c.dest.port_tx);
+    inet_pton(AF_INET, c.dest.ip.c_str(), &S.sitl_addr.sin_addr);
+    S.sitl_addr_known = true;
+}
+
+// --vehicles/--workers: G is vehicle 0 with the usual hooks; the others
+// copy its published configuration and origin, shifted to their own SITL
+// ports (and shared-memory file, FILE.i), and stay silent.
+static int run_pool(const BridgeHooks& hooks, int vehicles, int workers, int cpu, double duration_s,
+                    const char* replay_path, double replay_speed, bool replay_loop, bool static_dest){
+    const BridgeConfig base = *G.cfg.acquire();
+    const BridgeHooks quiet;
+    std::vector<std::unique_ptr<Shared>> others;
+    std::vector<Shared*> S(1, &G);
+    for (int i = 1; i < vehicles; i++) {
+        others.emplace_back(new Shared);
+        Shared& v = *others.back();
+        BridgeConfig c = base;
+        c.dest.port_tx = (uint16_t)(c.dest.port_tx + 10 * i);
+        c.dest.port_rx = (uint16_t)(c.dest.port_rx + 10 * i);
+        if (!c.shm_path.empty()) c.shm_path += "." + std::to_string(i);
+        v.dest = c.dest;
+        v.lockstep_tx = c.lockstep_tx;
+        v.sitl_shadows = c.sitl_shadows;
+        v.sim_origin_set = G.sim_origin_set;
+        v.sim_origin_lat = G.sim_origin_lat;
+        v.sim_origin_lon = G.sim_origin_lon;
+        v.sim_origin_alt_m = G.sim_origin_alt_m;
+        v.sim_earth_radius = G.sim_earth_radius;
+        for (int k = 0; k < 12; k++) v.rc_out[k] = -1.0;
+        v.cfg.publish(c);
+        if (static_dest) set_static_dest(v, c);
+        S.push_back(&v);
+    }
+
+    std::vector<std::unique_ptr<ReplaySource>> src;
+    VehiclePool pool;
+    for (int i = 0; i < vehicles; i++) {
+        src.emplace_back(new ReplaySource(replay_path, replay_speed, replay_loop));
+        pool.add(*S[i], *src[i], i ? quiet : hooks);
+    }
+
+    const auto t_start = std::chrono::steady_clock::now();
+    pool.start(workers, cpu);
+    printf("Pool: %d vehicles, %d workers\n", vehicles, pool.workers());
+    fflush(stdout);
+    while (RUN && !pool.finished()) {
+        if (duration_s > 0.0 && std::chrono::steady_clock::now() - t_start >= std::chrono::duration<double>(duration_s)) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    pool.stop();
+    RUN = false;
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+    if (src[0]->sample_count() == 0) {
+        fprintf(stderr, "Cannot read samples from %s\n", replay_path);
+        return 1;
+    }
+    const PoolStats ps = pool.stats();
+    printf("Pool: %.3f s, %llu passes, %llu sleeps\n", elapsed,
+    (unsigned long long)ps.passes, (unsigned long long)ps.sleeps);
+    for (int i = 0; i < vehicles; i++) {
+        const auto cfg = S[i]->cfg.acquire();
+        const BridgeConfig& c = *cfg;
+        const TxStats& ts = S[i]->tx_stats;
+        const RxStats& rs = S[i]->rx_stats;
+        printf("Vehicle %d (-> %u, <- %u): %llu samples, %llu frames sent, ", i,
+        (unsigned)c.dest.port_tx, (unsigned)c.dest.port_rx,
+        (unsigned long long)src[i]->samples_sent(), (unsigned long long)ts.frames_sent.load());
+        if (c.lockstep_tx) printf("%llu answered", (unsigned long long)ts.lockstep_answered.load());
+        else printf("%llu deadlines dropped", (unsigned long long)ts.pace_dropped.load());
+        printf(", %llu servo packets, %llu applied, %llu lost\n",
+        (unsigned long long)rs.datagrams.load(), (unsigned long long)rs.applied.load(),
+        (unsigned long long)rs.dropped.load());
+    }
+    return 0;
+}
+
+static void usage(const char* argv0){
+    printf(
+    "Usage: %s [options]\n"
+    "  --ini FILE          load [bridge] settings from FILE\n"
+    "  --ip ADDR           SITL address (default 127.0.0.1)\n"
+    "  --tx PORT           SITL sensor port (default 9003)\n"
+    "  --rx PORT           SITL servo port (default 9002)\n"
+    "  --rate HZ           sensor frame rate (default 1000)\n"
+    "  --pos-mode N        0 = MP SITL, 1 = Position, 2 = LLA\n"
+    "  --resample MODE     off | zoh | linear | cubic\n"
+    "  --geodesy MODE      N/E from wgs84 (exact, default) | flat (spherical approximation)\n"
+    "  --no-time-sync      send \"no_time_sync\": true\n"
+    "  --no-lockstep       send \"no_lockstep\": true\n"
+    "  --lockstep-tx       send one frame per SITL servo packet instead of at --rate\n"
+    "  --spin-us US        busy-wait the last US microseconds before each frame (default 200)\n"
+    "  --predict-ms MS     extrapolate the newest sim sample up to MS ms to the TX instant\n"
+    "  --predict-err M     hold instead while the one-frame-ahead error exceeds M metres (default 2)\n"
+    "  --axis-deadband N   resend a servo channel to the sim only when it moves by more than N (of 16383)\n"
+    "  --axis-keepalive MS resend unchanged servo channels every MS ms (default 250, 0 = never)\n"
+    "  --no-axis-align     do not limit servo events to one batch per sim frame\n"
+    "  --servo-rx MODE     drain (apply the newest queued servo packet, default) | single\n"
+    "  --net MODE          sockets (default) | io_uring (Linux; falls back to sockets)\n"
+    "  --listener IP:PORT  also send every sensor frame to IP:PORT (repeatable);\n"
+    "                      IP:PORT/binary sends it the binary packet instead of JSON\n"
+    "  --sitl-shadows      feed further SITL instances as shadows; only the first drives the sim\n"
+    "  --sitl-format FMT   json (default) | binary (sensor_packet.h, for SITL builds that read it)\n"
+    "  --shm FILE          also exchange frames with a SITL on this host through the\n"
+    "                      memory-mapped FILE (shm_layout.h), e.g. /dev/shm/msfs_ap_bridge\n"
+    "  --vehicles N        bridge N vehicles replaying the same log; vehicle i uses the\n"
+    "                      SITL ports offset by 10*i (ArduPilot's -I i)\n"
+    "  --workers N         run the vehicles on N pooled threads (0 = one per core,\n"
+    "                      the default with --vehicles) instead of two threads each\n"
+    "  --cpu N             pin the sensor loop (with --vehicles, worker 0) to CPU N\n"
+    "  --duration SEC      exit after SEC seconds\n"
+    "  --replay FILE       feed samples from a sensor log CSV\n"
+    "  --speed X|max       replay at X times the recorded timing (default 1)\n"
+    "  --loop              restart the replay at end of file\n"
+    "  --static-dest       send to ip:tx without waiting for SITL servo packets\n",
+    argv0);
+}
+
+int main(int argc, char** argv){
+    NetInit net;
+    int cpu = -1;
+    double duration_s = 0.0;
+    const char* replay_path = nullptr;
+    double replay_speed = 1.0;
+    bool replay_loop = false;
+    bool static_dest = false;
+    int vehicles = 1;
+    int workers = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto need = [&](){ if (!v) { usage(argv[0]); exit(2); } i++; return v; };
+
+        if (!strcmp(a, "--ini")) {
+            IniFile ini;
+            const char* path = need();
+            if (!ini.load(path)) { fprintf(stderr, "Cannot read %s\n", path); return 1; }
+            load_settings(ini);
+        }
+        else if (!strcmp(a, "--ip")) G.dest.ip = need();
+        else if (!strcmp(a, "--tx")) G.dest.port_tx = (uint16_t)atoi(need());
+        else if (!strcmp(a, "--rx")) G.dest.port_rx = (uint16_t)atoi(need());
+        else if (!strcmp(a, "--rate")) G.rate_hz = iclamp(atoi(need()), 1, 1000);
+        else if (!strcmp(a, "--pos-mode")) G.json_pos_mode = iclamp(atoi(need()), 0, 2);
+        else if (!strcmp(a, "--resample")) G.resample_mode = parse_resample(need());
+        else if (!strcmp(a, "--geodesy")) G.geodesy_mode = parse_geodesy(need());
+        else if (!strcmp(a, "--no-time-sync")) G.use_time_sync = false;
+        else if (!strcmp(a, "--no-lockstep")) G.no_lockstep = true;
+        else if (!strcmp(a, "--lockstep-tx")) G.lockstep_tx = true;
+        else if (!strcmp(a, "--spin-us")) G.tx_spin_us = iclamp(atoi(need()), 0, 5000);
+        else if (!strcmp(a, "--predict-ms")) G.predict_ms = iclamp(atoi(need()), 0, 500);
+        else if (!strcmp(a, "--predict-err")) G.predict_max_err_m = atof(need());
+        else if (!strcmp(a, "--axis-deadband")) G.axis_deadband = iclamp(atoi(need()), 0, 16383);
+        else if (!strcmp(a, "--axis-keepalive")) G.axis_keepalive_ms = atoi(need());
+        else if (!strcmp(a, "--no-axis-align")) G.axis_frame_align = false;
+        else if (!strcmp(a, "--servo-rx")) G.servo_rx_drain = strcmp(need(), "single") != 0;
+        else if (!strcmp(a, "--net")) G.net_backend = parse_net_backend(need());
+        else if (!strcmp(a, "--listener")) {
+            const char* l = need();
+            G.sensor_listeners += G.sensor_listeners.empty() ? l : std::string(",") + l;
+        }
+        else if (!strcmp(a, "--sitl-shadows")) G.sitl_shadows = true;
+        else if (!strcmp(a, "--sitl-format")) G.sitl_format = parse_frame_format(need());
+        else if (!strcmp(a, "--shm")) G.shm_path = need();
+        else if (!strcmp(a, "--vehicles")) vehicles = iclamp(atoi(need()), 1, 1000);
+        else if (!strcmp(a, "--workers")) workers = iclamp(atoi(need()), 0, 1000);
+        else if (!strcmp(a, "--cpu")) cpu = atoi(need());
+        else if (!strcmp(a, "--duration")) duration_s = atof(need());
+        else if (!strcmp(a, "--replay")) replay_path = need();
+        else if (!strcmp(a, "--speed")) { const char* x = need(); replay_speed = strcmp(x, "max") ? atof(x) : 0.0; }
+        else if (!strcmp(a, "--loop")) replay_loop = true;
+        else if (!strcmp(a, "--static-dest")) static_dest = true;
+        else { usage(argv[0]); return (!strcmp(a, "--help") || !strcmp(a, "-h")) ? 0 : 2; }
+    }
+
+    {
+        struct sockaddr_in parsed[kSensorDestMax];
+        std::string bad;
+        parse_endpoint_list(G.sensor_listeners, parsed, kSensorDestMax, &bad);
+        if (!bad.empty()) {
+            fprintf(stderr, "Bad or too many listeners at \"%s\" (IP:PORT[/json|/binary], at most %d)\n", bad.c_str(), kSensorDestMax);
+            return 2;
+        }
+    }
+
+    if (!replay_path) {
+        fprintf(stderr, "No sensor source: use --replay FILE\n");
+        return 2;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    BridgeHooks hooks;
+    hooks.status_text = print_status;
+    hooks.sim_status = on_sim_status;
+    hooks.tx_status = on_tx_status;
+    hooks.rx_status = on_rx_status;
+
+    for (int i = 0; i < 12; i++) G.rc_out[i] = -1.0;
+    {
+        // The replay accepts every servo channel, standing in for a sim
+        // with all 16 axis events mapped.
+        BridgeConfig c = snapshot_config(G);
+        for (int i = 0; i < 16; i++) c.axis_evt[i] = 1;
+        G.cfg.publish(c);
+    }
+
+    if (static_dest) set_static_dest(G, *G.cfg.acquire());
+
+    printf("%s: SITL %s, sensors -> %u, servos <- %u, %d Hz\n", argv[0],
+    G.dest.ip.c_str(), (unsigned)G.dest.port_tx, (unsigned)G.dest.port_rx, G.rate_hz);
+    fflush(stdout);
+
+    if (vehicles > 1 || workers >= 0) {
+        return run_pool(hooks, vehicles, workers < 0 ? 0 : workers, cpu, duration_s,
+                        replay_path, replay_speed, replay_loop, static_dest);
+    }
+
+    std::thread t_rx(rx_loop, std::ref(G), std::cref(hooks), std::cref(RUN));
+
+    ReplaySource src(replay_path, replay_speed, replay_loop);
+
+    std::atomic<bool> sim_run{true};
+    const auto t_start = std::chrono::steady_clock::now();
+    std::thread t_sim([&](){
+        if (cpu >= 0 && !pin_current_thread(cpu)) {
+            fprintf(stderr, "Could not pin the sensor loop to CPU %d\n", cpu);
+        }
+        sim_loop(G, hooks, src, sim_run);
+    });
+
+    while (RUN && !src.finished()) {
+        if (duration_s > 0.0 && std::chrono::steady_clock::now() - t_start >= std::chrono::duration<double>(duration_s)) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    sim_run = false;
+    t_sim.join();
+    RUN = false;
+    t_rx.join();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+    if (src.sample_count() == 0) {
+        fprintf(stderr, "Cannot read samples from %s\n", replay_path);
+        return 1;
+    }
+    else {
+        printf("Replay: %llu samples in %.3f s (%.0f samples/s), %llu servo frames to sim, %llu axis events sent, %llu suppressed\n",
+        (unsigned long long)src.samples_sent(), elapsed,
+        elapsed > 0 ? (double)src.samples_sent() / elapsed : 0.0,
+        (unsigned long long)src.axes_frames(), (unsigned long long)src.axis_events(),
+        (unsigned long long)G.axis_stats.events_suppressed.load());
+    }
+
+    const TxStats& ts = G.tx_stats;
+    printf("TX: %llu frames sent", (unsigned long long)ts.frames_sent.load());
+    if (G.lockstep_tx) {
+        uint64_t answered = ts.lockstep_answered.load();
+        printf(", lockstep %llu answered, %llu resent, %llu skipped, turnaround %.0f/%.0f us avg/max",
+        (unsigned long long)answered, (unsigned long long)ts.lockstep_resent.load(),
+        (unsigned long long)ts.lockstep_skipped.load(),
+        answered ? (double)ts.turnaround_sum_us.load() / (double)answered : 0.0,
+        (double)ts.turnaround_max_us.load());
+    }
+    else {
+        printf(", pacing error %u/%u/%u us p50/p99/max, %llu deadlines dropped",
+        ts.pace_p50_us.load(), ts.pace_p99_us.load(), ts.pace_max_us.load(),
+        (unsigned long long)ts.pace_dropped.load());
+    }
+    if (G.predict_ms > 0) {
+        printf(", predictor %llu fallbacks, max error %.3f m",
+        (unsigned long long)ts.predict_fallbacks.load(), ts.predict_err_max_mm.load() / 1000.0);
+    }
+    printf("\n");
+    for (int i = 0; i < G.dest_status_n; i++) {
+        const SensorDestStatus& d = G.dest_status[i];
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &d.addr.sin_addr, ip, sizeof(ip));
+        printf("  -> %s:%u (%s, %s): %llu frames, %llu errors\n", ip, (unsigned)ntohs(d.addr.sin_port),
+        sensor_dest_kind_name(d.kind), sensor_frame_format_name(d.format),
+        (unsigned long long)d.frames, (unsigned long long)d.errors);
+    }
+    const RxStats& rs = G.rx_stats;
+    printf("RX: %llu servo packets in %llu wakeups, %llu applied, %llu superseded, %llu lost, %llu duplicated, %llu reordered\n",
+    (unsigned long long)rs.datagrams.load(), (unsigned long long)rs.wakeups.load(),
+    (unsigned long long)rs.applied.load(), (unsigned long long)rs.superseded.load(),
+    (unsigned long long)rs.dropped.load(), (unsigned long long)rs.duplicated.load(),
+    (unsigned long long)rs.reordered.load());
+    if (G.sitl_shadows) printf("RX: %llu packets from shadow SITL instances\n", (unsigned long long)rs.shadow.load());
+    if (!G.shm_path.empty()) {
+        printf("Shared memory %s: %llu sensor frames out, %llu servo frames in\n", G.shm_path.c_str(),
+        (unsigned long long)ts.shm_frames.load(), (unsigned long long)rs.shm.load());
+    }
+    printf("Sim clock: %.2f ms period, %.0f us jitter, %llu frames skipped, %llu stalls\n",
+    G.sim_dt_ms.load(), (double)ts.sim_jitter_us.load(),
+    (unsigned long long)ts.sim_frames_skipped.load(), (unsigned long long)ts.sim_stalls.load());
+    return 0;
+}